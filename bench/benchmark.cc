@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "benchmark.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+/**
+ * Get processor time used by process in seconds
+ * @return Processor time
+ */
+double process_cpu_time() {
+  return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+}  // namespace
+
+bench::State::State(std::size_t iterations, const std::vector<long>& args)
+    : iterations_{iterations},
+      remaining_{iterations},
+      args_{args},
+      started_{false},
+      paused_{false},
+      cpu_start_{0.0},
+      real_time_{0.0},
+      cpu_time_{0.0} {}
+
+bool bench::State::keep_running() {
+  if (!started_) {
+    started_ = true;
+    resume_timing();
+  }
+
+  if (remaining_ == 0) {
+    pause_timing();
+    return false;
+  }
+
+  --remaining_;
+  return true;
+}
+
+void bench::State::pause_timing() {
+  if (paused_) {
+    return;
+  }
+  real_time_ += std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - real_start_)
+                    .count();
+  cpu_time_ += process_cpu_time() - cpu_start_;
+  paused_ = true;
+}
+
+void bench::State::resume_timing() {
+  paused_ = false;
+  cpu_start_ = process_cpu_time();
+  real_start_ = std::chrono::steady_clock::now();
+}
+
+bench::Registry* bench::Registry::instance() {
+  static Registry registry;
+  return &registry;
+}
+
+void bench::Registry::add(const std::string& name,
+                          std::function<void(State&)> function,
+                          const std::vector<std::vector<long>>& args) {
+  if (args.empty()) {
+    instances_.push_back(Instance{name, function, {}});
+  }
+
+  for (const auto& arg_set : args) {
+    std::string instance_name = name;
+    for (auto arg : arg_set) {
+      instance_name += "/" + std::to_string(arg);
+    }
+    instances_.push_back(Instance{instance_name, function, arg_set});
+  }
+}
+
+std::vector<std::string> bench::Registry::names() const {
+  std::vector<std::string> instance_names;
+  for (const auto& instance : instances_) {
+    instance_names.push_back(instance.name);
+  }
+  return instance_names;
+}
+
+nlohmann::json bench::Registry::run(const RunOptions& options) const {
+  auto start_time = std::time(nullptr);
+  char date[64];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                std::localtime(&start_time));
+
+  nlohmann::json output;
+  output["context"] = {{"date", date},
+                       {"library", "smelt"},
+                       {"num_cpus", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+                       {"library_build_type", "release"}
+#else
+                       {"library_build_type", "debug"}
+#endif
+  };
+  output["benchmarks"] = nlohmann::json::array();
+
+  for (const auto& instance : instances_) {
+    if (instance.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+
+    // Grow number of iterations until measured time reaches minimum time,
+    // predicting the required iterations from the previous run
+    std::size_t iterations = 1;
+    while (true) {
+      State state(iterations, instance.args);
+      instance.function(state);
+
+      if (state.real_time() >= options.min_time ||
+          iterations >= options.max_iterations) {
+        nlohmann::json result = {
+            {"name", instance.name},
+            {"run_type", "iteration"},
+            {"iterations", iterations},
+            {"real_time", 1.0E9 * state.real_time() / iterations},
+            {"cpu_time", 1.0E9 * state.cpu_time() / iterations},
+            {"time_unit", "ns"}};
+        for (const auto& rate : state.rates()) {
+          result[rate.first] =
+              state.real_time() > 0.0
+                  ? rate.second * iterations / state.real_time()
+                  : 0.0;
+        }
+        for (const auto& counter : state.counters()) {
+          result[counter.first] = counter.second;
+        }
+        result["peak_rss_kb"] = peak_rss_kb();
+        output["benchmarks"].push_back(result);
+
+        std::cerr << instance.name << ": " << iterations << " iterations, "
+                  << result["real_time"].get<double>() << " ns per iteration"
+                  << std::endl;
+        break;
+      }
+
+      double multiplier =
+          state.real_time() > 0.0
+              ? 1.4 * options.min_time / state.real_time()
+              : 10.0;
+      multiplier = std::min(std::max(multiplier, 2.0), 10.0);
+      iterations = std::min(
+          static_cast<std::size_t>(iterations * multiplier),
+          options.max_iterations);
+    }
+  }
+
+  return output;
+}
+
+std::size_t bench::peak_rss_kb() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return counters.PeakWorkingSetSize / 1024;
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  // Reported in bytes on macOS
+  return static_cast<std::size_t>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
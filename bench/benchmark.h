@@ -0,0 +1,240 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace bench {
+
+/**
+ * State of a running benchmark. Benchmarks loop while keep_running() returns
+ * true, and time spent in the loop is divided by the number of iterations.
+ * Rates registered by the benchmark are reported per second of measured time.
+ */
+class State {
+ public:
+  /**
+   * @constructor Default constructor
+   */
+  State() = delete;
+
+  /**
+   * @constructor Construct state for a fixed number of iterations
+   * @param[in] iterations Number of iterations to run
+   * @param[in] args Arguments of benchmark instance
+   */
+  State(std::size_t iterations, const std::vector<long>& args);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~State() {};
+
+  /**
+   * Delete copy constructor
+   */
+  State(const State&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  State& operator=(const State&) = delete;
+
+  /**
+   * Check whether another iteration should be run. Timing starts on the first
+   * call and stops once all iterations have run.
+   * @return Returns true if another iteration should be run, false otherwise
+   */
+  bool keep_running();
+
+  /**
+   * Get argument of benchmark instance
+   * @param[in] index Index of argument
+   * @return Value of argument
+   */
+  long range(std::size_t index = 0) const { return args_.at(index); };
+
+  /**
+   * Get number of iterations run by benchmark loop
+   * @return Number of iterations
+   */
+  std::size_t iterations() const { return iterations_; };
+
+  /**
+   * Stop timing, for example to exclude setup done inside benchmark loop
+   */
+  void pause_timing();
+
+  /**
+   * Resume timing after call to pause_timing
+   */
+  void resume_timing();
+
+  /**
+   * Add count processed per iteration that should be reported as a rate,
+   * such as items or records per second
+   * @param[in] name Name of rate in benchmark output
+   * @param[in] count_per_iteration Number processed per iteration
+   */
+  void set_rate(const std::string& name, double count_per_iteration) {
+    rates_[name] = count_per_iteration;
+  };
+
+  /**
+   * Add value that should be reported as is
+   * @param[in] name Name of counter in benchmark output
+   * @param[in] value Value of counter
+   */
+  void set_counter(const std::string& name, double value) {
+    counters_[name] = value;
+  };
+
+  /**
+   * Get measured wall clock time in seconds
+   * @return Elapsed time
+   */
+  double real_time() const { return real_time_; };
+
+  /**
+   * Get measured processor time in seconds, summed over all threads
+   * @return Processor time
+   */
+  double cpu_time() const { return cpu_time_; };
+
+  /**
+   * Get rates as counts per iteration
+   * @return Map from rate names to counts per iteration
+   */
+  const std::map<std::string, double>& rates() const { return rates_; };
+
+  /**
+   * Get counters
+   * @return Map from counter names to values
+   */
+  const std::map<std::string, double>& counters() const { return counters_; };
+
+ private:
+  std::size_t iterations_; /**< Number of iterations to run */
+  std::size_t remaining_; /**< Number of iterations left to run */
+  std::vector<long> args_; /**< Arguments of benchmark instance */
+  bool started_; /**< Indicates whether timing has started */
+  bool paused_; /**< Indicates whether timing is paused */
+  std::chrono::steady_clock::time_point real_start_; /**< Start of timed
+                                                         section */
+  double cpu_start_; /**< Processor time at start of timed section */
+  double real_time_; /**< Accumulated wall clock time in seconds */
+  double cpu_time_; /**< Accumulated processor time in seconds */
+  std::map<std::string, double> rates_; /**< Counts per iteration reported
+                                           as rates */
+  std::map<std::string, double> counters_; /**< Values reported as is */
+};
+
+/**
+ * Options used when running registered benchmarks
+ */
+struct RunOptions {
+  std::string filter; /**< Only benchmarks whose name contains this are run */
+  double min_time = 0.5; /**< Minimum measured time per benchmark in seconds */
+  std::size_t max_iterations = 1000000000; /**< Maximum number of iterations */
+};
+
+/**
+ * Registry of benchmark functions and the arguments they should be run with
+ */
+class Registry {
+ public:
+  /**
+   * Get the registry instance
+   * @return Pointer to registry
+   */
+  static Registry* instance();
+
+  /**
+   * Register benchmark function
+   * @param[in] name Name of benchmark
+   * @param[in] function Benchmark function
+   * @param[in] args List of argument sets to run benchmark with. If empty,
+   *                 benchmark is run once without arguments.
+   */
+  void add(const std::string& name, std::function<void(State&)> function,
+           const std::vector<std::vector<long>>& args);
+
+  /**
+   * Get names of all registered benchmark instances
+   * @return Vector of benchmark names including arguments
+   */
+  std::vector<std::string> names() const;
+
+  /**
+   * Run registered benchmarks. The number of iterations of each benchmark is
+   * increased until the measured time reaches the minimum time.
+   * @param[in] options Options for running benchmarks
+   * @return JSON object in the format of Google Benchmark JSON output
+   *         containing the run context and results of each benchmark
+   */
+  nlohmann::json run(const RunOptions& options) const;
+
+ private:
+  /**
+   * @constructor Default constructor
+   */
+  Registry() = default;
+
+  /**
+   * Registered benchmark instance
+   */
+  struct Instance {
+    std::string name; /**< Name including arguments */
+    std::function<void(State&)> function; /**< Benchmark function */
+    std::vector<long> args; /**< Arguments to run function with */
+  };
+
+  std::vector<Instance> instances_; /**< Registered benchmark instances */
+};
+
+/**
+ * Class used to register benchmarks with static instances
+ */
+class Register {
+ public:
+  /**
+   * @constructor Register benchmark function
+   * @param[in] name Name of benchmark
+   * @param[in] function Benchmark function
+   * @param[in] args List of argument sets to run benchmark with
+   */
+  Register(const std::string& name, std::function<void(State&)> function,
+           const std::vector<std::vector<long>>& args = {}) {
+    Registry::instance()->add(name, function, args);
+  };
+};
+
+/**
+ * Get peak resident set size of the current process. This is a high water
+ * mark for the whole process, so it only increases over a run.
+ * @return Peak resident set size in kilobytes, or 0 if unavailable
+ */
+std::size_t peak_rss_kb();
+
+/**
+ * Prevent compiler from optimizing away a value computed in a benchmark
+ * @tparam T Type of value
+ * @param[in] value Value to keep
+ */
+template <typename T>
+void do_not_optimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+}  // namespace bench
+
+#endif  // _BENCHMARK_H_
@@ -0,0 +1,377 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include <nlohmann/json.hpp>
+#include "benchmark.h"
+#include "beta_dist.h"
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "inv_gauss_dist.h"
+#include "json_object.h"
+#include "lognormal_dist.h"
+#include "nelder_mead.h"
+#include "normal_dist.h"
+#include "normal_multivar.h"
+#include "numeric_utils.h"
+#include "record_writer.h"
+#include "students_t_dist.h"
+#include "uniform_dist.h"
+#include "vlachos_et_al.h"
+#include "wittig_sinha.h"
+
+namespace {
+/**
+ * Record writer that discards records, counting the records and values
+ * received so that end-to-end benchmarks measure generation only
+ */
+class CountingRecordWriter : public utilities::RecordWriter {
+ public:
+  CountingRecordWriter() = default;
+
+  bool write_header(const utilities::JsonObject& /*metadata*/) override {
+    return true;
+  }
+
+  bool write_record(const utilities::JsonObject& /*event*/,
+                    const std::vector<std::vector<double>>& series) override {
+    ++num_records;
+    for (const auto& values : series) {
+      num_values += values.size();
+    }
+    return true;
+  }
+
+  bool close() override { return true; }
+
+  std::size_t num_records = 0; /**< Number of records received */
+  std::size_t num_values = 0; /**< Number of time series values received */
+};
+
+/**
+ * Generate deterministic pseudo-random signal of given length
+ * @param[in] length Length of signal
+ * @return Vector containing signal
+ */
+std::vector<double> test_signal(std::size_t length) {
+  std::vector<double> signal(length);
+  for (std::size_t i = 0; i < length; ++i) {
+    signal[i] = std::sin(0.013 * i) + 0.5 * std::cos(0.37 * i + 1.0);
+  }
+  return signal;
+}
+
+/**
+ * Run model generation as end-to-end benchmark, reporting the number of
+ * records and time series values generated per second
+ * @param[in, out] state Benchmark state
+ * @param[in] model Model to generate records with
+ */
+void generate_suite(bench::State& state, stochastic::StochasticModel& model) {
+  CountingRecordWriter writer;
+  while (state.keep_running()) {
+    writer.num_records = 0;
+    writer.num_values = 0;
+    model.generate("Benchmark", writer);
+  }
+  state.set_rate("records_per_second", writer.num_records);
+  state.set_rate("values_per_second", writer.num_values);
+  state.set_counter("records", writer.num_records);
+}
+
+// MICROBENCHMARKS
+// Lengths cover wind time histories and padded seismic time histories
+const std::vector<std::vector<long>> fft_lengths = {{1024}, {4096}, {16384}};
+
+bench::Register fft("fft", [](bench::State& state) {
+  auto signal = test_signal(state.range(0));
+  std::vector<std::complex<double>> output;
+  while (state.keep_running()) {
+    numeric_utils::fft(signal, output);
+    bench::do_not_optimize(output);
+  }
+  state.set_rate("items_per_second", state.range(0));
+}, fft_lengths);
+
+bench::Register inverse_fft("inverse_fft", [](bench::State& state) {
+  auto signal = test_signal(2 * state.range(0));
+  std::vector<std::complex<double>> input(state.range(0));
+  for (long i = 0; i < state.range(0); ++i) {
+    input[i] = std::complex<double>(signal[2 * i], signal[2 * i + 1]);
+  }
+  std::vector<double> output;
+  while (state.keep_running()) {
+    numeric_utils::inverse_fft(input, output);
+    bench::do_not_optimize(output);
+  }
+  state.set_rate("items_per_second", state.range(0));
+}, fft_lengths);
+
+// Time history with short filter impulse response, and full length
+// convolutions as used in multiple-window estimation
+bench::Register convolve_1d("convolve_1d", [](bench::State& state) {
+  auto input_x = test_signal(state.range(0));
+  auto input_y = test_signal(state.range(1));
+  std::vector<double> output;
+  while (state.keep_running()) {
+    numeric_utils::convolve_1d(input_x, input_y, output);
+    bench::do_not_optimize(output);
+  }
+  state.set_rate("items_per_second", state.range(0) + state.range(1) - 1);
+}, {{4096, 64}, {4096, 4096}, {16384, 16384}});
+
+// Number of model parameters in Vlachos et al. model
+bench::Register normal_multivar_generate(
+    "NormalMultiVar::generate", [](bench::State& state) {
+      unsigned int num_vars = 18;
+      Eigen::VectorXd means = Eigen::VectorXd::LinSpaced(num_vars, 0.0, 1.0);
+      Eigen::MatrixXd cov(num_vars, num_vars);
+      for (unsigned int i = 0; i < num_vars; ++i) {
+        for (unsigned int j = 0; j < num_vars; ++j) {
+          cov(i, j) = std::pow(0.5, std::abs(static_cast<int>(i - j)));
+        }
+      }
+      numeric_utils::NormalMultiVar generator(100);
+      Eigen::MatrixXd random_numbers;
+      while (state.keep_running()) {
+        generator.generate(random_numbers, means, cov, state.range(0));
+        bench::do_not_optimize(random_numbers);
+      }
+      state.set_rate("items_per_second", state.range(0));
+    }, {{100}, {10000}});
+
+/**
+ * Register inverse CDF benchmark for distribution
+ * @param[in] name Name of distribution
+ * @param[in] distribution Distribution to evaluate inverse CDF of
+ */
+void register_inv_cdf(const std::string& name,
+                      std::shared_ptr<stochastic::Distribution> distribution) {
+  bench::Registry::instance()->add(
+      "Distribution::inv_cumulative_dist_func/" + name,
+      [distribution](bench::State& state) {
+        std::vector<double> probabilities(state.range(0));
+        for (long i = 0; i < state.range(0); ++i) {
+          probabilities[i] = (i + 0.5) / state.range(0);
+        }
+        while (state.keep_running()) {
+          auto locations =
+              distribution->inv_cumulative_dist_func(probabilities);
+          bench::do_not_optimize(locations);
+        }
+        state.set_rate("items_per_second", state.range(0));
+      },
+      {{1000}, {100000}});
+
+  bench::Registry::instance()->add(
+      "Distribution::inv_cumulative_dist_func/batch/" + name,
+      [distribution](bench::State& state) {
+        std::vector<double> probabilities(state.range(0));
+        std::vector<double> locations(state.range(0));
+        for (long i = 0; i < state.range(0); ++i) {
+          probabilities[i] = (i + 0.5) / state.range(0);
+        }
+        while (state.keep_running()) {
+          distribution->inv_cumulative_dist_func(
+              probabilities.data(), locations.data(), probabilities.size());
+          bench::do_not_optimize(locations);
+        }
+        state.set_rate("items_per_second", state.range(0));
+      },
+      {{1000}, {100000}});
+}
+
+/**
+ * Tabulate inverse CDF of distribution, building table before timing starts
+ * @param[in] distribution Distribution to tabulate inverse CDF of
+ * @return Input distribution
+ */
+std::shared_ptr<stochastic::Distribution> tabulated(
+    std::shared_ptr<stochastic::Distribution> distribution) {
+  distribution->tabulate_inv_cumulative_dist_func(1.0e-8);
+  distribution->inv_cumulative_dist_func(0.5);
+  return distribution;
+}
+
+bench::Register nelder_mead_minimize(
+    "NelderMead::minimize", [](bench::State& state) {
+      // Extended Rosenbrock function
+      std::function<double(const std::vector<double>&)> rosenbrock =
+          [](const std::vector<double>& points) -> double {
+        double value = 0.0;
+        for (unsigned int i = 0; i + 1 < points.size(); ++i) {
+          value += std::pow(1.0 - points[i], 2) +
+                   100.0 * std::pow(points[i + 1] - points[i] * points[i], 2);
+        }
+        return value;
+      };
+      std::vector<double> initial_point(state.range(0), -1.0);
+      while (state.keep_running()) {
+        optimization::NelderMead optimizer(1e-6);
+        auto minimum = optimizer.minimize(initial_point, 0.1, rosenbrock);
+        bench::do_not_optimize(minimum);
+      }
+    }, {{2}, {6}});
+
+/**
+ * Register benchmark of modulating function parameter backcalculation, where
+ * each iteration fits both components of a parameter set
+ * @param[in] name Name of solver
+ * @param[in] mode Solver used to fit parameters
+ */
+void register_backcalculation(const std::string& name,
+                              stochastic::ModulatingFitMode mode) {
+  bench::Registry::instance()->add(
+      "DabaghiDerKiureghian::backcalculate_modulating_params/" + name,
+      [mode](bench::State& state) {
+        stochastic::DabaghiDerKiureghian model(
+            stochastic::FaultType::StrikeSlip,
+            stochastic::SimulationType::PulseAndNoPulse, 6.5, 0.0, 10.0,
+            760.0, 26.0, 0.0, 1, 1, true, 100);
+        // Values from Table 4 of Dabaghi & Der Kiureghian (2017)
+        Eigen::VectorXd q_params_1(4), q_params_2(4);
+        q_params_1 << 12.0, 14.0, 3.9, 5.7;
+        q_params_2 << 9.0, 15.2, 3.9, 5.5;
+        while (state.keep_running()) {
+          auto params_1 =
+              model.backcalculate_modulating_params(q_params_1, 1.7, mode);
+          auto params_2 = model.backcalculate_modulating_params(
+              q_params_2, 1.7, mode, params_1.head(3));
+          bench::do_not_optimize(params_2);
+        }
+        state.set_rate("parameter_sets_per_second", 1);
+      },
+      {});
+}
+
+// END-TO-END BENCHMARKS
+// Arguments are number of spectra and simulations per spectrum
+bench::Register vlachos_generate(
+    "VlachosEtAl::generate", [](bench::State& state) {
+      stochastic::VlachosEtAl model(6.5, 30.0, 500.0, 0.0, state.range(0),
+                                    state.range(1), 100);
+      generate_suite(state, model);
+    }, {{1, 1}, {1, 8}, {4, 4}});
+
+// Argument is number of floors
+bench::Register wittig_sinha_generate(
+    "WittigSinha::generate", [](bench::State& state) {
+      stochastic::WittigSinha model("D", 30.0, 123.0, state.range(0), 200.0,
+                                    100);
+      generate_suite(state, model);
+    }, {{4}, {16}});
+
+// Arguments are number of parameter realizations and white noise
+// realizations per parameter realization
+bench::Register dabaghi_der_kiureghian_generate(
+    "DabaghiDerKiureghian::generate", [](bench::State& state) {
+      stochastic::DabaghiDerKiureghian model(
+          stochastic::FaultType::StrikeSlip,
+          stochastic::SimulationType::PulseAndNoPulse, 6.5, 0.0, 10.0, 760.0,
+          26.0, 0.0, state.range(0), state.range(1), true, 100);
+      generate_suite(state, model);
+    }, {{1, 1}, {2, 2}});
+
+/**
+ * Print usage of benchmark executable
+ */
+void print_usage() {
+  std::cout
+      << "Usage: smelt_bench [options]\n"
+      << "  --benchmark_filter=<text>    Only run benchmarks containing text\n"
+      << "  --benchmark_min_time=<sec>   Minimum time per benchmark\n"
+      << "  --benchmark_out=<file>       Write JSON results to file instead "
+         "of standard output\n"
+      << "  --benchmark_list_tests       List benchmarks without running\n";
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  config::initialize();
+
+  register_inv_cdf("NormalDist",
+                   std::make_shared<stochastic::NormalDistribution>(0.0, 1.0));
+  register_inv_cdf(
+      "LognormalDist",
+      std::make_shared<stochastic::LognormalDistribution>(0.0, 0.5));
+  register_inv_cdf("UniformDist",
+                   std::make_shared<stochastic::UniformDistribution>(0.0, 1.0));
+  register_inv_cdf("BetaDist",
+                   std::make_shared<stochastic::BetaDistribution>(2.0, 5.0));
+  register_inv_cdf(
+      "InverseGaussianDist",
+      std::make_shared<stochastic::InverseGaussianDistribution>(1.0, 3.0));
+  register_inv_cdf(
+      "StudentstDist",
+      std::make_shared<stochastic::StudentstDistribution>(0.0, 1.0, 5.0));
+  register_inv_cdf(
+      "BetaDist/tabulated",
+      tabulated(std::make_shared<stochastic::BetaDistribution>(2.0, 5.0)));
+  register_inv_cdf("InverseGaussianDist/tabulated",
+                   tabulated(std::make_shared<
+                             stochastic::InverseGaussianDistribution>(1.0, 3.0)));
+  register_inv_cdf("StudentstDist/tabulated",
+                   tabulated(std::make_shared<stochastic::StudentstDistribution>(
+                       0.0, 1.0, 5.0)));
+
+  register_backcalculation("LevenbergMarquardt",
+                           stochastic::ModulatingFitMode::LevenbergMarquardt);
+  register_backcalculation("NelderMead",
+                           stochastic::ModulatingFitMode::NelderMead);
+
+  bench::RunOptions options;
+  std::string output_location;
+  bool list_tests = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = arg.substr(arg.find('=') + 1);
+    if (arg.find("--benchmark_filter=") == 0) {
+      options.filter = value;
+    } else if (arg.find("--benchmark_min_time=") == 0) {
+      options.min_time = std::stod(value);
+    } else if (arg.find("--benchmark_out=") == 0) {
+      output_location = value;
+    } else if (arg == "--benchmark_list_tests") {
+      list_tests = true;
+    } else {
+      print_usage();
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  if (list_tests) {
+    for (const auto& name : bench::Registry::instance()->names()) {
+      if (name.find(options.filter) != std::string::npos) {
+        std::cout << name << std::endl;
+      }
+    }
+    return 0;
+  }
+
+  try {
+    auto results = bench::Registry::instance()->run(options);
+    if (output_location.empty()) {
+      std::cout << results.dump(2) << std::endl;
+    } else {
+      std::ofstream output_file(output_location);
+      if (!output_file) {
+        throw std::runtime_error("\nERROR: in smelt_bench: Could not open " +
+                                 output_location + " for writing\n");
+      }
+      output_file << results.dump(2) << std::endl;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    return 1;
+  }
+
+  return 0;
+}
@@ -1,6 +1,7 @@
 #ifndef _DABAGHI_DER_KIUREGHIAN_H_
 #define _DABAGHI_DER_KIUREGHIAN_H_
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -8,6 +9,7 @@
 #include <Eigen/Dense>
 #include "distribution.h"
 #include "json_object.h"
+#include "modulating_params_cache.h"
 #include "numeric_utils.h"
 #include "stochastic_model.h"
 
@@ -30,6 +32,29 @@ enum class SimulationType {
   NoPulse /**< only non-pulse-like */
 };
 
+/** @enum stochastic::ImpulseResponseMode
+ *  @brief is a strongly typed enum class representing how the time-varying
+ *  impulse response filter is applied to white noise
+ */
+enum class ImpulseResponseMode {
+  Truncated, /**< impulse responses truncated once their envelope decays below
+                tolerance, O(N*K) time and O(N) memory */
+  Dense /**< reference mode using full num_steps x num_steps impulse response
+           matrix, O(N^2) time and memory */
+};
+
+/** @enum stochastic::ModulatingFitMode
+ *  @brief is a strongly typed enum class representing the solver used to
+ *  back-calculate modulating function parameters
+ */
+enum class ModulatingFitMode {
+  LevenbergMarquardt, /**< Levenberg-Marquardt solve of duration residuals
+                         with analytic Jacobian, stopping once a start matches
+                         the target durations */
+  NelderMead /**< reference mode minimizing error measure with Nelder-Mead
+                from all starting points */
+};
+
 /**
  * Stochastic model for simulating near-fault ground motions. Based on the following
  * references:
@@ -104,6 +129,43 @@ class DabaghiDerKiureghian : public StochasticModel {
                        double theta_or_phi, unsigned int num_sims,
                        unsigned int num_realizations, bool truncate, int seed_value);
 
+  /**
+   * @constructor Construct near-fault ground motion model that generates a
+   * single shard of the suite of time histories. All shards of a suite must
+   * be constructed with the same parameters and seed, in which case each
+   * shard produces the same records as a single model generating the full
+   * suite.
+   * @param[in] faulting Type of faulting
+   * @param[in] simulation_type Pulse-type of simulation
+   * @param[in] moment_magnitude Moment magnitude of earthquake
+   * @param[in] depth_to_rupt Depth to the top of the rupture plane in
+   *               kilometers
+   * @param[in] rupture_distance Closest distance from the site to the fault
+   *               rupture in kilometers
+   * @param[in] vs30 Soil shear wave velocity averaged over top 30 meters in
+   *               meters per second
+   * @param[in] s_or_d Directivity parameter s or d (km)--input the larger of
+   *               the two
+   * @param[in] theta_or_phi Directivity ange parameter theta or phi
+   *               (degrees)--input corresponding value to s or d
+   * @param[in] num_sims Total number of model parameter realizations in suite
+   * @param[in] num_realizations Number of realizations of non-stationary, modulated, filtered
+   *               white noise per set of model parameters
+   * @param[in] truncate Boolean indicating whether to truncate and baseline correct
+   *               synthetic motion
+   * @param[in] seed_value Value to seed random variables with to ensure
+   *               repeatability
+   * @param[in] shard_id Index of shard to generate
+   * @param[in] num_shards Total number of shards suite is split into
+   */
+  DabaghiDerKiureghian(FaultType faulting, SimulationType simulation_type,
+                       double moment_magnitude, double depth_to_rupt,
+                       double rupture_distance, double vs30, double s_or_d,
+                       double theta_or_phi, unsigned int num_sims,
+                       unsigned int num_realizations, bool truncate,
+                       int seed_value, unsigned int shard_id,
+                       unsigned int num_shards);
+
   /**
    * @destructor Virtual destructor
    */
@@ -147,6 +209,106 @@ class DabaghiDerKiureghian : public StochasticModel {
                 const std::string& output_location,
                 bool units = false) override;
 
+  /**
+   * Generate ground motion time histories based on input parameters and pass
+   * each event to the record writer as soon as it has been generated. Throws
+   * exception if errors are encountered during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in, out] writer Record writer to write events to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Returns true if successful, false otherwise
+   */
+  bool generate(const std::string& event_name, utilities::RecordWriter& writer,
+                bool units = false) override;
+
+  /**
+   * Get the number of event records produced by model
+   * @return Number of parameter sets multiplied by number of realizations per
+   *         parameter set
+   */
+  unsigned int num_records() const override {
+    return (num_sims_pulse_ + num_sims_nopulse_) * num_realizations_;
+  };
+
+  /**
+   * Generate a single ground motion event on demand. Record index i
+   * corresponds to realization i % num_realizations of parameter set
+   * i / num_realizations, where pulse-like parameter sets precede
+   * non-pulse-like ones as in generate. Model parameters are shared with
+   * generate and white noise is drawn from a random stream specific to each
+   * parameter set, so for a seeded model records match those of generate
+   * regardless of the order of calls. Since truncation acts
+   * on all realizations of a parameter set together, the realizations of the
+   * most recently requested parameter set are cached, so iterating over
+   * records in order simulates each parameter set once. Throws exception if
+   * index is out of range or errors are encountered during time history
+   * generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in] index Index of record to generate
+   * @param[out] event Event metadata without time series data
+   * @param[out] series Acceleration time histories in x and y directions
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Returns true if successful, false otherwise
+   */
+  bool generate_record(const std::string& event_name, unsigned int index,
+                       utilities::JsonObject& event,
+                       std::vector<std::vector<double>>& series,
+                       bool units = false) override;
+
+  /**
+   * Set the number of threads used to generate time histories. Parameter
+   * sets are simulated, truncated and baseline corrected concurrently, and
+   * results for a given seed do not depend on the number of threads.
+   * @param[in] num_threads Number of threads to use. A value of 0 uses the
+   *                        number of hardware threads available.
+   */
+  void set_num_threads(unsigned int num_threads) { num_threads_ = num_threads; };
+
+  /**
+   * Get the number of threads used to generate time histories
+   * @return Number of threads, where 0 indicates all hardware threads
+   */
+  unsigned int num_threads() const { return num_threads_; };
+
+  /**
+   * Set cache of back-calculated modulating function parameters, which may be
+   * shared with other models and threads. Cached parameters are returned for
+   * Arias intensities, durations, start times, and initial guesses that
+   * quantize to the same key. Caching is disabled by default.
+   * @param[in] cache Cache to use, or null to disable caching
+   */
+  void set_modulating_params_cache(
+      std::shared_ptr<ModulatingParamsCache> cache) {
+    modulating_params_cache_ = cache;
+  };
+
+  /**
+   * Get cache of back-calculated modulating function parameters
+   * @return Cache in use, or null if caching is disabled
+   */
+  std::shared_ptr<ModulatingParamsCache> modulating_params_cache() const {
+    return modulating_params_cache_;
+  };
+
+  /**
+   * Tabulate the inverse CDFs of the Beta marginal distributions used to
+   * transform parameter realizations from normal space. Must not be called
+   * while generating time histories.
+   * @param[in] tolerance Maximum interpolation error of tabulated inverse
+   *                      CDFs
+   */
+  void set_quantile_tolerance(double tolerance);
+
+  /**
+   * Get the interpolation error tolerance of tabulated inverse CDFs
+   * @return Tolerance, where 0 indicates inverse CDFs are evaluated exactly
+   */
+  double quantile_tolerance() const { return quantile_tolerance_; };
+
   /**
    * Generates proportion of motions that should be pulse-like based on total
    * number of simulations and probability of those motions containing a pulse
@@ -184,7 +346,8 @@ class DabaghiDerKiureghian : public StochasticModel {
    * @param[in, out] parameters Vector of parameters in normal space. Transformed variables will be
    *                            stored in this vector.
    */
-  void transform_parameters_from_normal_space(bool pulse_like, Eigen::VectorXd& parameters);
+  void transform_parameters_from_normal_space(bool pulse_like,
+                                              Eigen::VectorXd& parameters) const;
 
   /**
    * Calculate the inverse of double-exponential distribution
@@ -204,6 +367,8 @@ class DabaghiDerKiureghian : public StochasticModel {
    *                       pulse-like
    * @param[in] parameters Vector of model parameters to use for ground motion
    *                       simulation
+   * @param[in] set_index Index of parameter set, selecting the random streams
+   *                      of the white noise
    * @param[in,out] accel_comp_1 Simulated near-fault ground motion components
    *                             in direction 1. Outputs are written here.
    * @param[in,out] accel_comp_2 Simulated near-fault ground motion components
@@ -213,7 +378,7 @@ class DabaghiDerKiureghian : public StochasticModel {
    */
   void simulate_near_fault_ground_motion(
       bool pulse_like, const Eigen::VectorXd& parameters,
-      std::vector<std::vector<double>>& accel_comp_1,
+      unsigned int set_index, std::vector<std::vector<double>>& accel_comp_1,
       std::vector<std::vector<double>>& accel_comp_2,
       unsigned int num_gms = 1) const;
 
@@ -221,25 +386,36 @@ class DabaghiDerKiureghian : public StochasticModel {
    * Backcalculate modulating parameters given Arias Intesity and duration parameters
    * @param[in] q_params Vector containing Ia, D595, D05, and D030
    * @param[in] t0 Initial time. Defaults to 0.0.
+   * @param[in] mode Solver used to fit parameters. Defaults to
+   *                 Levenberg-Marquardt.
+   * @param[in] initial_guess Optional alpha, beta, and tmaxq tried before the
+   *                          default starting points by Levenberg-Marquardt,
+   *                          such as the solution for the other component
    * @return Vector containing parameters alpha, beta, tmaxq, and c
    */
   Eigen::VectorXd backcalculate_modulating_params(
-      const Eigen::VectorXd& q_params, double t0 = 0.0) const;
+      const Eigen::VectorXd& q_params, double t0 = 0.0,
+      ModulatingFitMode mode = ModulatingFitMode::LevenbergMarquardt,
+      const Eigen::VectorXd& initial_guess = Eigen::VectorXd()) const;
 
   /**
    * Simulate modulated filtered white noise process
    * @param[in] modulating_params Modulating parameters
    * @param[in] filter_params Filtering parameters
    * @param[in] num_steps Total number of time steps to be taken
+   * @param[in, out] random_stream Random stream to draw white noise from
    * @param[in] num_gms Number of ground motions that should be generated.
    *                    Defaults to 1.
+   * @param[in] mode Method used to apply impulse response filter. Defaults to
+   *                 truncated impulse responses.
    * @return Vector of vectors containing time history of simulated modulate
    *         filtered white noise
    */
-  Eigen::MatrixXd simulate_white_noise(const Eigen::VectorXd& modulating_params,
-                                       const Eigen::VectorXd& filter_params,
-                                       unsigned int num_steps,
-                                       unsigned int num_gms = 1) const;
+  Eigen::MatrixXd simulate_white_noise(
+      const Eigen::VectorXd& modulating_params,
+      const Eigen::VectorXd& filter_params, unsigned int num_steps,
+      numeric_utils::RandomStream& random_stream, unsigned int num_gms = 1,
+      ImpulseResponseMode mode = ImpulseResponseMode::Truncated) const;
 
   /**
    * This function defines an error measure based on matching times of the 5%,
@@ -262,6 +438,33 @@ class DabaghiDerKiureghian : public StochasticModel {
                               double d05_target, double d030_target,
                               double d095_target, double t0) const;
 
+  /**
+   * Calculate residuals between the times from t0 to the 5%, 30%, and 95%
+   * Arias intensity of the modulating function and of the target motion,
+   * along with their derivatives with respect to the modulating function
+   * parameters. The sum of squared residuals equals the error measure
+   * calculated by calc_parameter_error.
+   * @param[in] parameters Modulating function parameters: alpha, beta, and t_max_q
+   * @param[in] d05_target Time from t0 to time of 5% Arias intensity of target
+   *                       motion
+   * @param[in] d030_target Time from t0 to time of 30% Arias intensity of
+   *                        target motion
+   * @param[in] d095_target Time from t0 to time of 95% Arias intensity of
+   *                        target motion
+   * @param[in] t0 Start time of modulating function and of target ground motion
+   * @param[out] residuals Vector of fitted minus target durations
+   * @param[out] jacobian Matrix of derivatives of residuals (rows) with respect
+   *                      to parameters (columns)
+   * @return Returns true if parameters are within domain of modulating
+   *         function, i.e. t_max_q > t0, beta > 0, and alpha > -0.5, false
+   *         otherwise
+   */
+  bool calc_parameter_residuals(const Eigen::VectorXd& parameters,
+                                double d05_target, double d030_target,
+                                double d095_target, double t0,
+                                Eigen::VectorXd& residuals,
+                                Eigen::MatrixXd& jacobian) const;
+
   /**
    * Calculate values of modulating function given function parameters
    * @param[in] num_steps Total number of time steps to be taken
@@ -315,6 +518,33 @@ class DabaghiDerKiureghian : public StochasticModel {
       unsigned int num_steps, const std::vector<double>& input_filter,
       double zeta) const;
 
+  /**
+   * Apply time-varying impulse response filter based on input filter and
+   * filter parameter zeta to white noise. This gives the same result as
+   * multiplying the white noise by the output of calc_impulse_response_filter.
+   * In truncated mode, the impulse response excited at each time step is
+   * generated by a second-order recursion and truncated once its exponential
+   * envelope decays below the tolerance, so no num_steps x num_steps matrix is
+   * formed. When the model precision is single, the filtered white noise is
+   * accumulated in 32-bit floating point while the impulse responses and
+   * their normalization are evaluated in double precision, giving a relative
+   * error of roughly sqrt(num_steps) * 2^-24.
+   * @param[in] white_noise Matrix where each row is a white noise time history
+   * @param[in] input_filter Input filter coefficients to use in impulse
+   *                         response
+   * @param[in] zeta Filter parameter
+   * @param[in] mode Method used to apply impulse response filter. Defaults to
+   *                 truncated impulse responses.
+   * @param[in] tolerance Envelope value relative to peak below which impulse
+   *                      responses are truncated. Defaults to 1.0E-10.
+   * @return Matrix where each row is filtered white noise time history
+   */
+  Eigen::MatrixXd filter_white_noise(
+      const Eigen::MatrixXd& white_noise,
+      const std::vector<double>& input_filter, double zeta,
+      ImpulseResponseMode mode = ImpulseResponseMode::Truncated,
+      double tolerance = 1.0E-10) const;
+
   /**
    * Filters input acceleration time history in frequency domain using
    * acausal high-pass Butterworth filter
@@ -327,6 +557,20 @@ class DabaghiDerKiureghian : public StochasticModel {
                                           double freq_corner,
                                           unsigned int filter_order) const;
 
+  /**
+   * Filters each row of input acceleration time histories in frequency domain
+   * using acausal high-pass Butterworth filter. All time histories are
+   * transformed in a single batch.
+   * @param[in] accel_histories Matrix where each row is an acceleration time
+   *                            history to filter
+   * @param[in] freq_corner Corner frequency
+   * @param[in] filter_order Order of filter
+   * @return Vector of filtered time histories
+   */
+  std::vector<std::vector<double>> filter_acceleration_batch(
+      const Eigen::MatrixXd& accel_histories, double freq_corner,
+      unsigned int filter_order) const;
+
   /**
    * Calculate the pulse acceleration based on the modified Mavroeidis and
    * Papageorgiou model
@@ -377,6 +621,102 @@ class DabaghiDerKiureghian : public StochasticModel {
                                   bool units) const;  
 
  private:
+  /**
+   * Transform of a single model parameter from normal space to the marginal
+   * distribution fitted to it (Table 5 in Dabaghi & Der Kiureghian, 2017)
+   */
+  struct MarginalTransform {
+    /** @enum stochastic::DabaghiDerKiureghian::MarginalTransform::Type
+     *  @brief is a strongly typed enum class representing the marginal
+     *  distribution of a parameter
+     */
+    enum class Type {
+      Lognormal, /**< exponential of normal variable */
+      Beta, /**< beta distribution scaled to bounds */
+      LogBeta, /**< exponential of beta distribution scaled to bounds */
+      Uniform, /**< uniform distribution between bounds */
+      DoubleExponential /**< double-exponential distribution */
+    };
+
+    Type type; /**< Marginal distribution of parameter */
+    unsigned int index; /**< Index of parameter in parameter vector */
+    std::shared_ptr<const Distribution>
+        distribution; /**< Beta distribution, empty for other types */
+    double lower_bound; /**< Lower bound of marginal distribution */
+    double upper_bound; /**< Upper bound of marginal distribution */
+    double param_a; /**< Double-exponential distribution parameter */
+    double param_b; /**< Double-exponential distribution parameter */
+    double param_c; /**< Double-exponential distribution parameter */
+  };
+
+  /**
+   * Build the tables of marginal transforms for pulse-like and
+   * non-pulse-like parameters from the fitted marginal distributions. Called
+   * once during construction so that transforming parameter realizations
+   * never creates distributions.
+   */
+  void build_marginal_transforms();
+
+  /**
+   * Create marginal transform for a parameter
+   * @param[in] type Marginal distribution of parameter
+   * @param[in] index Index of parameter in parameter vector
+   * @param[in] fitted_index Index of fitted marginal distribution parameters
+   *                         and bounds in Table 5
+   * @return Marginal transform for parameter
+   */
+  MarginalTransform make_marginal_transform(MarginalTransform::Type type,
+                                            unsigned int index,
+                                            unsigned int fitted_index) const;
+
+  /**
+   * Simulate all realizations of a parameter set, truncating and baseline
+   * correcting them if requested
+   * @param[in] set_index Index of parameter set, where pulse-like parameter
+   *                      sets precede non-pulse-like ones
+   * @param[out] accel_comp_1 Realizations of first component of motion
+   * @param[out] accel_comp_2 Realizations of second component of motion
+   */
+  void simulate_parameter_set(
+      unsigned int set_index, std::vector<std::vector<double>>& accel_comp_1,
+      std::vector<std::vector<double>>& accel_comp_2) const;
+
+  /**
+   * Simulate model parameters of all parameter sets, unless already
+   * simulated. Seeded models restart the multivariate normal generator from
+   * the seed, so the parameters do not depend on earlier draws.
+   */
+  void simulate_suite_parameters();
+
+  /**
+   * Get random stream for white noise of a component of a parameter set
+   * @param[in] set_index Index of parameter set
+   * @param[in] component Index of component of motion
+   * @return Random stream specific to parameter set and component
+   */
+  numeric_utils::RandomStream parameter_set_stream(
+      unsigned int set_index, unsigned int component) const;
+
+  /**
+   * Get the name of an event record
+   * @param[in] event_name Name assigned to events
+   * @param[in] set_index Index of parameter set
+   * @param[in] realization Index of realization for parameter set
+   * @return Name of event record
+   */
+  std::string record_name(const std::string& event_name,
+                          unsigned int set_index,
+                          unsigned int realization) const;
+
+  /**
+   * Create metadata for a ground motion event
+   * @param[in] name Name of event
+   * @param[in] num_steps Number of time steps in event time histories
+   * @return JsonObject containing event metadata without time series data
+   */
+  utilities::JsonObject event_metadata(const std::string& name,
+                                       std::size_t num_steps) const;
+
   FaultType faulting_;      /**< Enum for type of faulting for scenario */
   SimulationType sim_type_; /**< Enum for pulse-like nature of ground motion */
   double moment_magnitude_; /**< Moment magnitude for scenario */
@@ -393,6 +733,7 @@ class DabaghiDerKiureghian : public StochasticModel {
                              motion time histories that should be generated */
   unsigned int num_realizations_; /**< Number of realizations of model parameters */
   int seed_value_; /**< Integer to seed random distributions with */
+  unsigned long long stream_seed_; /**< Seed for white noise random streams */
   double time_step_; /**< Temporal discretization. Set to 0.005 seconds */
   double start_time_ = 0.0; /**< Start time of ground motion */
   Eigen::VectorXd std_dev_pulse_; /**< Pulse-like parameter standard deviation */
@@ -408,10 +749,38 @@ class DabaghiDerKiureghian : public StochasticModel {
   Eigen::VectorXd params_fitted1_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */
   Eigen::VectorXd params_fitted2_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */
   Eigen::VectorXd params_fitted3_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */  
+  std::shared_ptr<const Distribution>
+      standard_normal_; /**< Standard normal distribution */
+  std::vector<MarginalTransform>
+      marginal_transforms_pulse_; /**< Marginal transforms of pulse-like
+                                     parameters */
+  std::vector<MarginalTransform>
+      marginal_transforms_nopulse_; /**< Marginal transforms of
+                                       non-pulse-like parameters */
   const double magnitude_baseline_ = 6.5; /**< Baseline regression factor for magnitude */ 
   const double c6_ = 6.0 ; /**< This factor is set to avoid non-linearity in regression */
   std::shared_ptr<numeric_utils::RandomGenerator>
       sample_generator_; /**< Multivariate normal random number generator */
+  unsigned int num_threads_ = 0; /**< Number of threads used for
+                                   generation */
+  std::shared_ptr<ModulatingParamsCache>
+      modulating_params_cache_; /**< Cache of back-calculated modulating
+                                   function parameters */
+  double quantile_tolerance_ = 0.0; /**< Tolerance of tabulated inverse CDFs,
+                                       0 if evaluated exactly */
+  bool parameters_simulated_ = false; /**< Indicates model parameters of all
+                                         parameter sets have been simulated */
+  Eigen::MatrixXd parameters_pulse_; /**< Pulse-like parameters shared by
+                                        generate and generate_record */
+  Eigen::MatrixXd parameters_nopulse_; /**< Non-pulse-like parameters shared
+                                          by generate and generate_record */
+  bool record_set_cached_ = false; /**< Indicates realizations of a parameter
+                                      set are cached */
+  unsigned int record_set_ = 0; /**< Index of cached parameter set */
+  std::vector<std::vector<double>>
+      record_motions_comp1_; /**< Cached first component realizations */
+  std::vector<std::vector<double>>
+      record_motions_comp2_; /**< Cached second component realizations */
 };
 }  // namespace stochastic
 
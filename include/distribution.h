@@ -1,6 +1,7 @@
 #ifndef _DISTRIBUTION_H_
 #define _DISTRIBUTION_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -55,6 +56,78 @@ class Distribution {
    */
   virtual std::vector<double> inv_cumulative_dist_func(
       const std::vector<double>& probabilities) const = 0;
+
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * a single location. Derived classes should override this to avoid the
+   * allocations made by the vector interface.
+   * @param[in] location Location at which to calculate CDF
+   * @return Evaluated value of CDF at input location
+   */
+  virtual double cumulative_dist_func(double location) const {
+    return cumulative_dist_func(std::vector<double>{location})[0];
+  };
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at a single probability. Derived classes should override this
+   * to avoid the allocations made by the vector interface.
+   * @param[in] probability Probability at which to calculate ICDF
+   * @return Evaluated value of ICDF at input probability
+   */
+  virtual double inv_cumulative_dist_func(double probability) const {
+    return inv_cumulative_dist_func(std::vector<double>{probability})[0];
+  };
+
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * a batch of locations, writing into a caller-provided buffer. Input and
+   * output buffers may be the same, in which case the CDF is evaluated in
+   * place.
+   * @param[in] locations Buffer containing locations at which to calculate CDF
+   * @param[out] evaluations Buffer to write evaluated values of CDF to
+   * @param[in] size Number of locations in batch
+   */
+  virtual void cumulative_dist_func(const double* locations,
+                                    double* evaluations,
+                                    std::size_t size) const {
+    for (std::size_t i = 0; i < size; ++i) {
+      evaluations[i] = cumulative_dist_func(locations[i]);
+    }
+  };
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at a batch of probabilities, writing into a caller-provided
+   * buffer. Input and output buffers may be the same, in which case the ICDF
+   * is evaluated in place.
+   * @param[in] probabilities Buffer containing probabilities at which to
+   *                          calculate ICDF
+   * @param[out] evaluations Buffer to write evaluated values of ICDF to
+   * @param[in] size Number of probabilities in batch
+   */
+  virtual void inv_cumulative_dist_func(const double* probabilities,
+                                        double* evaluations,
+                                        std::size_t size) const {
+    for (std::size_t i = 0; i < size; ++i) {
+      evaluations[i] = inv_cumulative_dist_func(probabilities[i]);
+    }
+  };
+
+  /**
+   * Tabulate the inverse cumulative distribution function (ICDF) so that
+   * subsequent evaluations interpolate a table built lazily on first use
+   * instead of evaluating the ICDF exactly. Distributions with inexpensive
+   * ICDFs ignore this request. Must not be called while the ICDF is being
+   * evaluated on other threads.
+   * @param[in] tolerance Maximum interpolation error, relative to the
+   *                      magnitude of the location for locations larger than
+   *                      1 and absolute otherwise
+   * @return Returns true if the ICDF will be tabulated, false otherwise
+   */
+  virtual bool tabulate_inv_cumulative_dist_func(double /*tolerance*/) {
+    return false;
+  };
 };
 }  // namespace stochastic
 
@@ -28,10 +28,12 @@
 #ifndef _FACTORY_H_
 #define _FACTORY_H_
 
+#include <algorithm>
 #include <functional>
-#include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -61,6 +63,11 @@ class Factory {
     registry[key].reset(new Creator<Tderivedclass>);
   }
 
+  /**
+   * Function creating an instance of a registered class
+   */
+  using CreateFunction = std::function<std::shared_ptr<Tbaseclass>(Targs&&...)>;
+
   /**
    * Create an instance of a registered class
    * @param[in] key Key to item in registry
@@ -68,10 +75,20 @@ class Factory {
    * @return shared_ptr<Tbaseclass> Shared pointer to a base class
    */
   std::shared_ptr<Tbaseclass> create(const std::string& key, Targs&&... args) {
-    if (!this->check(key))
-      throw std::runtime_error("Invalid key: " + key +
-                               ", not found in the factory register!");
-    return registry.at(key)->create(std::forward<Targs>(args)...);
+    return find(key)->create(std::forward<Targs>(args)...);
+  }
+
+  /**
+   * Resolve the factory function for a registered class once, so that
+   * repeated creation skips the registry lookup
+   * @param[in] key Key to item in registry
+   * @return Function creating instances of the registered class
+   */
+  CreateFunction resolve(const std::string& key) const {
+    std::shared_ptr<CreatorBase> creator = find(key);
+    return [creator](Targs&&... args) {
+      return creator->create(std::forward<Targs>(args)...);
+    };
   }
 
   /**
@@ -80,20 +97,18 @@ class Factory {
    * @return status Return if key is in registry or not
    */
   bool check(const std::string& key) const {
-    bool status = false;
-    for (const auto& keyvalue : registry)
-      if (keyvalue.first == key) status = true;
-    return status;
+    return registry.find(key) != registry.end();
   }
   
   /**
    * List registered elements
-   * @return factory_items Return list of items in the registry
+   * @return factory_items Return sorted list of items in the registry
    */
   std::vector<std::string> list() const {
     std::vector<std::string> factory_items;
     for (const auto& keyvalue : registry)
       factory_items.push_back(keyvalue.first);
+    std::sort(factory_items.begin(), factory_items.end());
     return factory_items;
   }
 
@@ -103,6 +118,24 @@ class Factory {
    */
   Factory() = default;
 
+  /**
+   * A base class creator struct
+   */
+  struct CreatorBase;
+
+  /**
+   * Find factory function for registered class with a single hashed lookup
+   * @param[in] key Key to item in registry
+   * @return Factory function for registered class
+   */
+  const std::shared_ptr<CreatorBase>& find(const std::string& key) const {
+    auto creator = registry.find(key);
+    if (creator == registry.end())
+      throw std::runtime_error("Invalid key: " + key +
+                               ", not found in the factory register!");
+    return creator->second;
+  }
+
   /**
    * A base class creator struct
    */
@@ -125,9 +158,8 @@ class Factory {
     }
   };
 
-  std::map<std::string, std::shared_ptr<CreatorBase>> registry; /**< Register of
-                                                                   factory
-                                                                   functions */
+  std::unordered_map<std::string, std::shared_ptr<CreatorBase>>
+      registry; /**< Register of factory functions */
 };
 
 /**
@@ -0,0 +1,135 @@
+#ifndef _FILTER_CACHE_H_
+#define _FILTER_CACHE_H_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace signal_processing {
+
+/**
+ * Thread-safe cache of filter designs. Highpass Butterworth coefficients,
+ * their impulse responses and acausal highpass frequency domain masks are
+ * computed once for each combination of filter order, cutoff frequency, time
+ * step and length, and returned as shared immutable arrays. Callers keep
+ * returned arrays valid independently of the cache, so entries can be
+ * discarded at any time. When a table reaches its capacity it is cleared
+ * before the new design is added.
+ */
+class FilterCache {
+ public:
+  /**
+   * Get the single instance of the cache shared by all models
+   */
+  static FilterCache* instance();
+
+  /**
+   * @constructor Construct empty cache
+   * @param[in] capacity Maximum number of designs held in each table.
+   *                     Defaults to 256.
+   */
+  explicit FilterCache(std::size_t capacity = 256);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~FilterCache() {};
+
+  /**
+   * Delete copy constructor
+   */
+  FilterCache(const FilterCache&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  FilterCache& operator=(const FilterCache&) = delete;
+
+  /**
+   * Get the coefficients of a highpass Butterworth filter
+   * @param[in] filter_order Order of the Butterworth filter
+   * @param[in] cutoff_freq Cutoff frequency in Hz
+   * @param[in] time_step Time step between observations
+   * @return Shared vector containing the numerator coefficients followed by
+   *         the denominator coefficients
+   */
+  std::shared_ptr<const std::vector<std::vector<double>>> highpass_butterworth(
+      int filter_order, double cutoff_freq, double time_step);
+
+  /**
+   * Get the impulse response of a highpass Butterworth filter
+   * @param[in] filter_order Order of the Butterworth filter
+   * @param[in] cutoff_freq Cutoff frequency in Hz
+   * @param[in] time_step Time step between observations
+   * @param[in] num_samples Number of samples in impulse response
+   * @return Shared vector containing impulse response
+   */
+  std::shared_ptr<const std::vector<double>> highpass_impulse_response(
+      int filter_order, double cutoff_freq, double time_step, int num_samples);
+
+  /**
+   * Get the frequency domain mask of an acausal highpass Butterworth filter
+   * @param[in] filter_order Order of the filter
+   * @param[in] freq_corner Corner frequency in Hz
+   * @param[in] time_step Time step between observations
+   * @param[in] num_samples Number of samples in the filtered signal
+   * @return Shared vector containing filter coefficients
+   */
+  std::shared_ptr<const std::vector<double>> acausal_highpass_filter(
+      unsigned int filter_order, double freq_corner, double time_step,
+      unsigned int num_samples);
+
+  /**
+   * Get the total number of designs in the cache
+   * @return Number of cached designs
+   */
+  std::size_t size() const;
+
+  /**
+   * Get the maximum number of designs held in each table
+   * @return Capacity of each table
+   */
+  std::size_t capacity() const { return capacity_; };
+
+  /**
+   * Remove all designs from the cache
+   */
+  void clear();
+
+ private:
+  /**
+   * Key for designs: filter order, cutoff frequency, time step and length
+   */
+  using Key = std::tuple<int, double, double, std::size_t>;
+
+  /**
+   * Look up design in table, computing and adding it on a miss. Designs are
+   * computed without holding the mutex, so concurrent misses on the same key
+   * may both compute the design, in which case the first one added is kept.
+   * @tparam Tdesign Type of design
+   * @tparam Tcompute Type of function computing design
+   * @param[in] table Table to look up design in
+   * @param[in] key Key of design
+   * @param[in] compute Function computing design on a miss
+   * @return Shared design
+   */
+  template <typename Tdesign, typename Tcompute>
+  std::shared_ptr<const Tdesign> find_or_compute(
+      std::map<Key, std::shared_ptr<const Tdesign>>& table, const Key& key,
+      Tcompute compute);
+
+  std::size_t capacity_; /**< Maximum number of designs in each table */
+  mutable std::mutex mutex_; /**< Mutex guarding tables */
+  std::map<Key, std::shared_ptr<const std::vector<std::vector<double>>>>
+      butterworth_; /**< Butterworth numerator and denominator coefficients */
+  std::map<Key, std::shared_ptr<const std::vector<double>>>
+      impulse_responses_; /**< Butterworth filter impulse responses */
+  std::map<Key, std::shared_ptr<const std::vector<double>>>
+      acausal_filters_; /**< Acausal highpass frequency domain masks */
+};
+}  // namespace signal_processing
+
+#endif  // _FILTER_CACHE_H_
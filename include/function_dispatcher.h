@@ -1,9 +1,11 @@
 #ifndef _FUNCTION_DISPATCHER_H_
 #define _FUNCTION_DISPATCHER_H_
 
+#include <algorithm>
 #include <functional>
-#include <map>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -23,16 +25,18 @@ class Dispatcher {
     return &dispatcher;
   }
 
+  /**
+   * Function type held by the dispatcher
+   */
+  using Function = std::function<Treturntype(Targs...)>;
+
   /**
    * Register a function with the dispatcher
    * @param[in] key Register key
    * @param[in] new_function New function to register with the dispatcher
    */
-  void register_function(const std::string& key,
-                         std::function<Treturntype(Targs...)> new_function) {
-    if (!this->check(key)) {
-      registry[key] = std::move(new_function);
-    } else {
+  void register_function(const std::string& key, Function new_function) {
+    if (!registry.emplace(key, std::move(new_function)).second) {
       throw std::runtime_error("Duplicate key: " + key +
                                ", already registered. Verify key choice to "
                                "ensure function has not already been added");
@@ -46,11 +50,24 @@ class Dispatcher {
    * @return Return result of evaluating function with input args
    */
   Treturntype dispatch(const std::string& key, Targs... args) {
-    if (!this->check(key)) {
-      throw std::runtime_error("Invalid key: " + key + ", not found in the function dispatcher");
-    } else {
-      return registry.at(key)(std::forward<Targs>(args)...);
+    return resolve(key)(std::forward<Targs>(args)...);
+  }
+
+  /**
+   * Resolve a registered function once with a single hashed lookup, so that
+   * callers on hot paths can call through the returned reference directly.
+   * Registered functions are never removed, so the reference remains valid
+   * for the lifetime of the program.
+   * @param[in] key Key to function in dispatcher
+   * @return Reference to registered function
+   */
+  const Function& resolve(const std::string& key) const {
+    auto function = registry.find(key);
+    if (function == registry.end()) {
+      throw std::runtime_error("Invalid key: " + key +
+                               ", not found in the function dispatcher");
     }
+    return function->second;
   }
 
   /**
@@ -59,20 +76,18 @@ class Dispatcher {
    * @return status Return if key is in registry or not
    */
   bool check(const std::string& key) const {
-    bool status = false;
-    for (const auto& keyvalue : registry)
-      if (keyvalue.first == key) status = true;
-    return status;
+    return registry.find(key) != registry.end();
   }
   
   /**
    * List registered functions
-   * @return dispather_items Return list of items in the registry
+   * @return dispather_items Return sorted list of items in the registry
    */
   std::vector<std::string> list() const {
     std::vector<std::string> dispatcher_items;
     for (const auto& keyvalue : registry)
       dispatcher_items.push_back(keyvalue.first);
+    std::sort(dispatcher_items.begin(), dispatcher_items.end());
     return dispatcher_items;
   }
 
@@ -82,9 +97,8 @@ class Dispatcher {
    */
   Dispatcher() = default;
 
-  std::map<std::string, std::function<Treturntype(Targs...)>> registry; /**<
-                                                                   Register of
-                                                                   functions */
+  std::unordered_map<std::string, Function>
+      registry; /**< Register of functions */
 };
 
 /**
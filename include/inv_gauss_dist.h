@@ -1,10 +1,13 @@
 #ifndef _INV_GAUSS_DIST_H_
 #define _INV_GAUSS_DIST_H_
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 #include <boost/math/distributions/inverse_gaussian.hpp>
 #include "distribution.h"
+#include "quantile_table.h"
 
 namespace stochastic {
 /**
@@ -56,11 +59,57 @@ class InverseGaussianDistribution : public Distribution {
   std::vector<double> inv_cumulative_dist_func(
       const std::vector<double>& probabilities) const override;
 
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * a single location
+   * @param[in] location Location at which to calculate CDF
+   * @return Evaluated value of CDF at input location
+   */
+  double cumulative_dist_func(double location) const override;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at a single probability
+   * @param[in] probability Probability at which to calculate ICDF
+   * @return Evaluated value of ICDF at input probability
+   */
+  double inv_cumulative_dist_func(double probability) const override;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at a batch of probabilities, writing into a caller-provided
+   * buffer. Interpolates the tabulated ICDF if it has been requested.
+   * @param[in] probabilities Buffer containing probabilities at which to
+   *                          calculate ICDF
+   * @param[out] evaluations Buffer to write evaluated values of ICDF to
+   * @param[in] size Number of probabilities in batch
+   */
+  void inv_cumulative_dist_func(const double* probabilities,
+                                double* evaluations,
+                                std::size_t size) const override;
+
+  /**
+   * Tabulate the inverse cumulative distribution function (ICDF) so that
+   * subsequent evaluations interpolate a table built lazily on first use
+   * instead of running an iterative root-find for every probability. Must
+   * not be called while the ICDF is being evaluated on other threads.
+   * @param[in] tolerance Maximum interpolation error, relative to the
+   *                      magnitude of the location for locations larger than
+   *                      1 and absolute otherwise
+   * @return Returns true
+   */
+  bool tabulate_inv_cumulative_dist_func(double tolerance) override;
+
+  // Batch CDF evaluates the scalar overload element by element
+  using Distribution::cumulative_dist_func;
+
  protected:
   double mean_;    /**< Distribution mean */
   double std_dev_; /**< Distribution standard deviation */
   boost::math::inverse_gaussian distribution_; /**< Inverse Gaussian
                                                   distribution */
+  std::unique_ptr<QuantileTable>
+      quantile_table_; /**< Tabulated ICDF, empty unless requested */
 };
 }  // namespace stochastic
 
@@ -25,6 +25,12 @@ class JsonObject {
    */
   JsonObject();
 
+  /**
+   * @constructor Construct JsonObject from underlying library object
+   * @param[in] library_json Library JSON object
+   */
+  explicit JsonObject(json library_json);
+
   /**
    * @destructor Virtual destructor
    */
@@ -108,12 +114,6 @@ class JsonObject {
   };  
 
  protected:
-  /**
-   * @constructor Construct JsonObject from underlying library object
-   * @param[in] library_json Library JSON object
-   */
-  JsonObject(json library_json);
-
   json json_object_; /**< JSON object for this class */
 };
 
@@ -0,0 +1,98 @@
+#ifndef _LEVENBERG_MARQUARDT_H_
+#define _LEVENBERG_MARQUARDT_H_
+
+#include <functional>
+#include <limits>
+#include <Eigen/Dense>
+
+/**
+ * Optimization utilities
+ */
+namespace optimization {
+
+/**
+ * Class that implements the Levenberg-Marquardt algorithm for nonlinear least
+ * squares problems with analytic Jacobians. Based on implementation presented
+ * in Press et al. (2007) - "Numerical Recipes", using Marquardt's scaling of
+ * the damping term by the diagonal of the approximate Hessian.
+ */
+class LevenbergMarquardt {
+ public:
+  /**
+   * Residual function type. Given a point, the function fills the vector of
+   * residuals and the Jacobian of the residuals with respect to the point,
+   * returning false if the point lies outside the domain of the residuals.
+   */
+  using ResidualFunction = std::function<bool(
+      const Eigen::VectorXd&, Eigen::VectorXd&, Eigen::MatrixXd&)>;
+
+  /**
+   * @constructor Default constructor
+   */
+  LevenbergMarquardt() = default;
+
+  /**
+   * @constructor Construct with input tolerance
+   * @param[in] tolerance Tolerance in relative step size and relative change in
+   *                      objective function for convergence
+   * @param[in] max_iterations Maximum number of iterations. Defaults to 100.
+   */
+  LevenbergMarquardt(double tolerance, unsigned int max_iterations = 100)
+      : tolerance_{tolerance},
+        max_iters_{max_iterations},
+        num_iters_{0},
+        func_min_{std::numeric_limits<double>::infinity()} {};
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~LevenbergMarquardt(){};
+
+  /**
+   * Delete copy constructor
+   */
+  LevenbergMarquardt(const LevenbergMarquardt&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  LevenbergMarquardt& operator=(const LevenbergMarquardt&) = delete;
+
+  /**
+   * Minimize the sum of squared residuals given initial point
+   * @param[in] initial_point Initial values to use for each dimension
+   * @param[in] residual_function Function computing residuals and Jacobian
+   * @return Location of minimum. If the initial point lies outside the domain
+   *         of the residuals, it is returned unchanged and the minimum is set
+   *         to infinity.
+   */
+  Eigen::VectorXd minimize(const Eigen::VectorXd& initial_point,
+                           const ResidualFunction& residual_function);
+
+  /**
+   * Get the minimum sum of squared residuals
+   * @return Minimum value of objective function
+   */
+  double get_minimum() const { return func_min_; };
+
+  /**
+   * Get the number of iterations taken in last minimization
+   * @return Number of iterations
+   */
+  unsigned int get_num_iterations() const { return num_iters_; };
+
+ private:
+  double tolerance_ = 1.0e-10;    /**< Tolerance for convergence */
+  unsigned int max_iters_ = 100;  /**< Maximum number of iterations */
+  unsigned int num_iters_ = 0;    /**< Number of iterations taken */
+  double func_min_ =
+      std::numeric_limits<double>::infinity(); /**< Objective minimum */
+  const double INITIAL_DAMPING_ = 1.0e-3; /**< Initial damping factor */
+  const double MAX_DAMPING_ = 1.0e16; /**< Damping factor at which iteration
+                                         stops making progress */
+  const double MAX_STEP_RATIO_ = 1.0; /**< Maximum step in each dimension
+                                         relative to magnitude of point */
+};
+}  // namespace optimization
+
+#endif  // _LEVENBERG_MARQUARDT_H_
@@ -0,0 +1,200 @@
+#ifndef _MODULATING_PARAMS_CACHE_H_
+#define _MODULATING_PARAMS_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <Eigen/Dense>
+
+namespace stochastic {
+
+/**
+ * Thread-safe, size-bounded cache of modulating function parameters
+ * back-calculated from Arias intensity and duration parameters. Entries are
+ * keyed by the Arias intensity and durations, the start time, the solver, and
+ * the initial guess the solver was warm started from, if any, quantized to a
+ * fixed resolution, so near-identical inputs share an entry. Fits that cannot
+ * match all targets depend on the starting point, so including the initial
+ * guess keeps cached parameters independent of which fit was inserted first.
+ * When the cache is full, the least recently used entry is evicted. A single
+ * cache can be shared by several models and threads, and can be saved to and
+ * loaded from disk so that repeated runs skip back-calculation entirely.
+ */
+class ModulatingParamsCache {
+ public:
+  /**
+   * @constructor Construct empty cache
+   * @param[in] capacity Maximum number of entries. Defaults to 100000.
+   * @param[in] resolution Resolution inputs are quantized to before lookup.
+   *                       Defaults to 1.0e-6.
+   */
+  explicit ModulatingParamsCache(std::size_t capacity = 100000,
+                                 double resolution = 1.0e-6);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~ModulatingParamsCache() {};
+
+  /**
+   * Delete copy constructor
+   */
+  ModulatingParamsCache(const ModulatingParamsCache&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  ModulatingParamsCache& operator=(const ModulatingParamsCache&) = delete;
+
+  /**
+   * Look up modulating function parameters, marking the entry as most
+   * recently used if found
+   * @param[in] q_params Vector containing Ia, D595, D05, and D030
+   * @param[in] t0 Start time of modulating function
+   * @param[in] solver Identifier of solver used to fit parameters
+   * @param[out] parameters Vector to store alpha, beta, tmaxq, and c to
+   * @return Returns true if parameters were found, false otherwise
+   */
+  bool find(const Eigen::VectorXd& q_params, double t0, int solver,
+            Eigen::VectorXd& parameters);
+
+  /**
+   * Look up modulating function parameters fit from an initial guess,
+   * marking the entry as most recently used if found
+   * @param[in] q_params Vector containing Ia, D595, D05, and D030
+   * @param[in] t0 Start time of modulating function
+   * @param[in] solver Identifier of solver used to fit parameters
+   * @param[in] initial_guess Alpha, beta, and tmaxq the solver was warm
+   *                          started from, or empty if none
+   * @param[out] parameters Vector to store alpha, beta, tmaxq, and c to
+   * @return Returns true if parameters were found, false otherwise
+   */
+  bool find(const Eigen::VectorXd& q_params, double t0, int solver,
+            const Eigen::VectorXd& initial_guess,
+            Eigen::VectorXd& parameters);
+
+  /**
+   * Add modulating function parameters to cache, evicting the least recently
+   * used entry if cache is full
+   * @param[in] q_params Vector containing Ia, D595, D05, and D030
+   * @param[in] t0 Start time of modulating function
+   * @param[in] solver Identifier of solver used to fit parameters
+   * @param[in] parameters Vector containing alpha, beta, tmaxq, and c
+   */
+  void insert(const Eigen::VectorXd& q_params, double t0, int solver,
+              const Eigen::VectorXd& parameters);
+
+  /**
+   * Add modulating function parameters fit from an initial guess to cache,
+   * evicting the least recently used entry if cache is full
+   * @param[in] q_params Vector containing Ia, D595, D05, and D030
+   * @param[in] t0 Start time of modulating function
+   * @param[in] solver Identifier of solver used to fit parameters
+   * @param[in] initial_guess Alpha, beta, and tmaxq the solver was warm
+   *                          started from, or empty if none
+   * @param[in] parameters Vector containing alpha, beta, tmaxq, and c
+   */
+  void insert(const Eigen::VectorXd& q_params, double t0, int solver,
+              const Eigen::VectorXd& initial_guess,
+              const Eigen::VectorXd& parameters);
+
+  /**
+   * Load entries from file written by save, adding them to cache as most
+   * recently used in the order they were saved
+   * @param[in] input_file Location of cache file
+   * @return Returns true if file exists and was loaded, false if file does
+   *         not exist
+   */
+  bool load(const std::string& input_file);
+
+  /**
+   * Write entries to file as JSON, ordered from least to most recently used
+   * @param[in] output_file Location to write cache file to
+   * @return Returns true if successful
+   */
+  bool save(const std::string& output_file) const;
+
+  /**
+   * Get the number of entries in the cache
+   * @return Number of cached entries
+   */
+  std::size_t size() const;
+
+  /**
+   * Get the maximum number of entries in the cache
+   * @return Capacity of cache
+   */
+  std::size_t capacity() const { return capacity_; };
+
+  /**
+   * Get the resolution inputs are quantized to
+   * @return Resolution of keys
+   */
+  double resolution() const { return resolution_; };
+
+  /**
+   * Get the number of lookups that found an entry
+   * @return Number of hits
+   */
+  std::size_t hits() const;
+
+  /**
+   * Get the number of lookups that did not find an entry
+   * @return Number of misses
+   */
+  std::size_t misses() const;
+
+  /**
+   * Remove all entries from the cache and reset hit and miss counts
+   */
+  void clear();
+
+ private:
+  /**
+   * Key for entries in cache: quantized Ia, D595, D05, D030, and t0, solver
+   * identifier, number of initial guess values, and quantized initial guess
+   * alpha, beta, and tmaxq, which are zero without an initial guess
+   */
+  using Key = std::array<long long, 10>;
+
+  /**
+   * Entry in cache, pairing key with modulating function parameters
+   */
+  using Entry = std::pair<Key, std::array<double, 4>>;
+
+  /**
+   * Quantize inputs to key
+   * @param[in] q_params Vector containing Ia, D595, D05, and D030
+   * @param[in] t0 Start time of modulating function
+   * @param[in] solver Identifier of solver used to fit parameters
+   * @param[in] initial_guess Alpha, beta, and tmaxq the solver was warm
+   *                          started from, or empty if none
+   * @return Key for inputs
+   */
+  Key make_key(const Eigen::VectorXd& q_params, double t0, int solver,
+               const Eigen::VectorXd& initial_guess) const;
+
+  /**
+   * Add entry as most recently used, replacing existing entry with the same
+   * key and evicting least recently used entry if cache is full. Mutex must
+   * be held by caller.
+   * @param[in] entry Entry to add
+   */
+  void insert_entry(const Entry& entry);
+
+  std::size_t capacity_; /**< Maximum number of entries */
+  double resolution_; /**< Resolution inputs are quantized to */
+  std::list<Entry> entries_; /**< Entries from most to least recently used */
+  std::map<Key, std::list<Entry>::iterator>
+      index_; /**< Entries in list indexed by key */
+  std::size_t hits_ = 0; /**< Number of lookups that found an entry */
+  std::size_t misses_ = 0; /**< Number of lookups that did not find an entry */
+  mutable std::mutex mutex_; /**< Mutex guarding access to entries */
+};
+}  // namespace stochastic
+
+#endif  // _MODULATING_PARAMS_CACHE_H_
@@ -1,6 +1,7 @@
 #ifndef _NORMAL_DIST_H_
 #define _NORMAL_DIST_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <boost/math/distributions/normal.hpp>
@@ -56,6 +57,47 @@ class NormalDistribution : public Distribution {
   std::vector<double> inv_cumulative_dist_func(
       const std::vector<double>& probabilities) const override;
 
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * a single location
+   * @param[in] location Location at which to calculate CDF
+   * @return Evaluated value of CDF at input location
+   */
+  double cumulative_dist_func(double location) const override;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at a single probability
+   * @param[in] probability Probability at which to calculate ICDF
+   * @return Evaluated value of ICDF at input probability
+   */
+  double inv_cumulative_dist_func(double probability) const override;
+
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * a batch of locations, writing into a caller-provided buffer.
+   * Evaluated for the whole batch with vectorized MKL VM kernels.
+   * @param[in] locations Buffer containing locations at which to calculate CDF
+   * @param[out] evaluations Buffer to write evaluated values of CDF to
+   * @param[in] size Number of locations in batch
+   */
+  void cumulative_dist_func(const double* locations, double* evaluations,
+                            std::size_t size) const override;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at a batch of probabilities, writing into a caller-provided
+   * buffer. Evaluated for the whole batch with vectorized MKL VM
+   * kernels; probabilities of 0 and 1 map to -infinity and infinity.
+   * @param[in] probabilities Buffer containing probabilities at which to
+   *                          calculate ICDF
+   * @param[out] evaluations Buffer to write evaluated values of ICDF to
+   * @param[in] size Number of probabilities in batch
+   */
+  void inv_cumulative_dist_func(const double* probabilities,
+                                double* evaluations,
+                                std::size_t size) const override;
+
  protected:
   double mean_;                      /**< Distribution mean */
   double std_dev_;                   /**< Distribution standard deviation */
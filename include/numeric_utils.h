@@ -1,17 +1,43 @@
 #ifndef _NUMERIC_UTILS_H_
 #define _NUMERIC_UTILS_H_
 
+#include <array>
 #include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include <Eigen/Dense>
 
+// Forward declaration of MKL DFTI descriptor so MKL headers are not required
+// by users of this header
+struct DFTI_DESCRIPTOR;
+
 /**
  * Numeric utility functions not tied to any particular class
  */
 namespace numeric_utils {
 
+/**
+ * Dense matrix of doubles stored in row-major order, used where each row is
+ * traversed contiguously
+ */
+using RowMatrixXd =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/**
+ * Dense matrix of single precision floats stored in row-major order
+ */
+using RowMatrixXf =
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
 /**
  * Convert input correlation matrix and standard deviation to covariance matrix
  * @param[in] corr Input correlation matrix
@@ -22,15 +48,43 @@ Eigen::MatrixXd corr_to_cov(const Eigen::MatrixXd& corr,
 			    const Eigen::VectorXd& std_dev);
 
 /**
- * Compute the 1-dimensional convolution of two input vectors
+ * Method used to compute convolutions
+ */
+enum class ConvolutionMode {
+  Auto, /**< Direct below crossover length, FFT-based otherwise */
+  Direct, /**< Direct summation */
+  Fft /**< FFT-based convolution */
+};
+
+/**
+ * Compute the 1-dimensional convolution of two input vectors. Convolution
+ * tasks are cached per thread, so repeated convolutions with the same input
+ * lengths and mode do not recreate them.
  * @param[in] input_x First input vector of data
  * @param[in] input_y Second input vector of data
  * @param[out] output Vector to story convolution results to
+ * @param[in] mode Method to use for convolution. Defaults to automatic
+ *                 selection based on convolution crossover length.
  * @return Returns true if convolution was successful, false otherwise
  */
 bool convolve_1d(const std::vector<double>& input_x,
                  const std::vector<double>& input_y,
-                 std::vector<double>& response);
+                 std::vector<double>& response,
+                 ConvolutionMode mode = ConvolutionMode::Auto);
+
+/**
+ * Set the length of the shorter input above which automatic convolution
+ * mode switches from direct to FFT-based convolution
+ * @param[in] crossover_length Crossover length
+ */
+void set_convolution_crossover(std::size_t crossover_length);
+
+/**
+ * Get the length of the shorter input above which automatic convolution
+ * mode switches from direct to FFT-based convolution
+ * @return Crossover length
+ */
+std::size_t get_convolution_crossover();
 
 /**
  * Computes the real portion of the 1-dimensional inverse Fast Fourier Transform
@@ -39,7 +93,7 @@ bool convolve_1d(const std::vector<double>& input_x,
  * @param[in, out] output_vector Vector to write output to
  * @return Returns true if computations were successful, false otherwise
  */
-bool inverse_fft(std::vector<std::complex<double>> input_vector,
+bool inverse_fft(const std::vector<std::complex<double>>& input_vector,
                  std::vector<double>& output_vector);
 
 /**
@@ -69,7 +123,7 @@ bool inverse_fft(const Eigen::VectorXcd& input_vector,
  * @param[in, out] output_vector Vector to write output to
  * @return Returns true if computations were successful, false otherwise
  */
-bool fft(std::vector<double> input_vector,
+bool fft(const std::vector<double>& input_vector,
          std::vector<std::complex<double>>& output_vector);
 
 /**
@@ -91,6 +145,502 @@ bool fft(const Eigen::VectorXd& input_vector, Eigen::VectorXcd& output_vector);
 bool fft(const Eigen::VectorXd& input_vector,
          std::vector<std::complex<double>>& output_vector);
 
+/**
+ * Computes the real portion of the 1-dimensional inverse Fast Fourier Transform
+ * (FFT) of strided input data without intermediate copies. Only the first
+ * length / 2 + 1 input values are read since the spectrum is assumed to be
+ * conjugate-even.
+ * @param[in] input Pointer to first element of input spectrum
+ * @param[in] length Number of points in transform
+ * @param[in] input_stride Distance between consecutive input elements
+ * @param[in, out] output Pointer to location to write length real values to
+ * @param[in] output_stride Distance between consecutive output elements
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_fft(const std::complex<double>* input, std::size_t length,
+                 std::size_t input_stride, double* output,
+                 std::size_t output_stride);
+
+/**
+ * Computes the 1-dimensional inverse Fast Fourier Transform (FFT) of strided
+ * complex data in place
+ * @param[in, out] data Pointer to first element of data to transform
+ * @param[in] length Number of points in transform
+ * @param[in] stride Distance between consecutive elements. Defaults to 1.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_fft(std::complex<double>* data, std::size_t length,
+                 std::size_t stride = 1);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transform (FFT) of strided real
+ * input data without intermediate copies. The full complex spectrum is written
+ * to the output.
+ * @param[in] input Pointer to first element of real input data
+ * @param[in] length Number of points in transform
+ * @param[in] input_stride Distance between consecutive input elements
+ * @param[in, out] output Pointer to location to write length complex values
+ *                        to
+ * @param[in] output_stride Distance between consecutive output elements
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool fft(const double* input, std::size_t length, std::size_t input_stride,
+         std::complex<double>* output, std::size_t output_stride);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transform (FFT) of strided complex
+ * data in place
+ * @param[in, out] data Pointer to first element of data to transform
+ * @param[in] length Number of points in transform
+ * @param[in] stride Distance between consecutive elements. Defaults to 1.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool fft(std::complex<double>* data, std::size_t length,
+         std::size_t stride = 1);
+
+/**
+ * Computes the first length / 2 + 1 bins of the 1-dimensional Fast Fourier
+ * Transform (FFT) of strided real input data without intermediate copies
+ * @param[in] input Pointer to first element of real input data
+ * @param[in] length Number of points in transform
+ * @param[in] input_stride Distance between consecutive input elements
+ * @param[in, out] output Pointer to location to write length / 2 + 1 complex
+ *                        values to
+ * @param[in] output_stride Distance between consecutive output elements
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool real_fft(const double* input, std::size_t length,
+              std::size_t input_stride, std::complex<double>* output,
+              std::size_t output_stride);
+
+/**
+ * Computes the real 1-dimensional inverse Fast Fourier Transform (FFT) of the
+ * first length / 2 + 1 bins of a strided conjugate-even spectrum without
+ * intermediate copies
+ * @param[in] input Pointer to first element of input spectrum
+ * @param[in] length Number of points, N, in real signal
+ * @param[in] input_stride Distance between consecutive input elements
+ * @param[in, out] output Pointer to location to write length real values to
+ * @param[in] output_stride Distance between consecutive output elements
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_real_fft(const std::complex<double>* input, std::size_t length,
+                      std::size_t input_stride, double* output,
+                      std::size_t output_stride);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transform (FFT) of the real input
+ * vector without promoting it to complex values. Only the first N/2+1 bins of
+ * the conjugate-even spectrum are computed, since the remaining bins are the
+ * complex conjugates of these.
+ * @param[in] input_vector Input vector of length N to compute the FFT of
+ * @param[in, out] output_vector Vector to write the N/2+1 non-redundant bins
+ *                               of the spectrum to
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool real_fft(const std::vector<double>& input_vector,
+              std::vector<std::complex<double>>& output_vector);
+
+/**
+ * Computes the 1-dimensional inverse Fast Fourier Transform (FFT) of the
+ * first N/2+1 bins of a conjugate-even spectrum, producing a real signal.
+ * This is the inverse of real_fft.
+ * @param[in] input_vector Vector containing the N/2+1 non-redundant bins of
+ *                         the spectrum
+ * @param[in, out] output_vector Vector to write real signal to
+ * @param[in] length Number of points, N, in real signal
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_real_fft(const std::vector<std::complex<double>>& input_vector,
+                      std::vector<double>& output_vector, std::size_t length);
+
+/**
+ * Computes the 1-dimensional real-to-complex Fast Fourier Transform (FFT) of
+ * each row or column of the input matrix using a single MKL call. Only the
+ * first N/2+1 bins of each spectrum are computed.
+ * @param[in] input_matrix Matrix of real signals of length N
+ * @param[in, out] output_matrix Matrix to write N/2+1 bins of each spectrum
+ *                               to
+ * @param[in] rowwise Indicates that each row is a separate signal. Defaults
+ *                    to false where each column is a separate signal.
+ * @param[in] cache_plan Indicates that the plan should be kept in the plan
+ *                       cache for later calls with the same shape. Defaults
+ *                       to true. Batch shapes that are unlikely to repeat
+ *                       should not be cached.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool real_fft_batch(const Eigen::MatrixXd& input_matrix,
+                    Eigen::MatrixXcd& output_matrix, bool rowwise = false,
+                    bool cache_plan = true);
+
+/**
+ * Computes the 1-dimensional complex-to-real inverse Fast Fourier Transform
+ * (FFT) of each row or column of the input matrix using a single MKL call.
+ * This is the inverse of real_fft_batch.
+ * @param[in] input_matrix Matrix containing N/2+1 bins of each spectrum
+ * @param[in, out] output_matrix Matrix to write real signals to
+ * @param[in] length Number of points, N, in each real signal
+ * @param[in] rowwise Indicates that each row is a separate spectrum. Defaults
+ *                    to false where each column is a separate spectrum.
+ * @param[in] cache_plan Indicates that the plan should be kept in the plan
+ *                       cache for later calls with the same shape. Defaults
+ *                       to true.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_real_fft_batch(const Eigen::MatrixXcd& input_matrix,
+                            Eigen::MatrixXd& output_matrix, std::size_t length,
+                            bool rowwise = false, bool cache_plan = true);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transform (FFT) of a batch of real
+ * signals stored in a strided buffer using a single MKL call. The full
+ * complex spectrum of each signal is written to the output.
+ * @param[in] input Pointer to first element of input signals
+ * @param[in, out] output Pointer to location to write spectra to
+ * @param[in] length Number of points in each signal
+ * @param[in] num_transforms Number of signals in batch
+ * @param[in] input_stride Distance between consecutive points of a signal
+ * @param[in] input_distance Distance between first points of consecutive
+ *                           signals
+ * @param[in] output_stride Distance between consecutive points of a spectrum
+ * @param[in] output_distance Distance between first points of consecutive
+ *                            spectra
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool fft_batch(const double* input, std::complex<double>* output,
+               std::size_t length, std::size_t num_transforms,
+               std::size_t input_stride, std::size_t input_distance,
+               std::size_t output_stride, std::size_t output_distance);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transform (FFT) of each row or
+ * column of the input matrix using a single MKL call
+ * @param[in] input_matrix Matrix of signals to compute the FFT of
+ * @param[in, out] output_matrix Matrix to write spectra to. Resized to the
+ *                               dimensions of the input matrix.
+ * @param[in] rowwise Indicates that each row is a separate signal. Defaults
+ *                    to false where each column is a separate signal.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool fft_batch(const Eigen::MatrixXd& input_matrix,
+               Eigen::MatrixXcd& output_matrix, bool rowwise = false);
+
+/**
+ * Computes the real portion of the 1-dimensional inverse Fast Fourier
+ * Transform (FFT) of a batch of spectra stored in a strided buffer using a
+ * single MKL call
+ * @param[in] input Pointer to first element of input spectra
+ * @param[in, out] output Pointer to location to write signals to
+ * @param[in] length Number of points in each spectrum
+ * @param[in] num_transforms Number of spectra in batch
+ * @param[in] input_stride Distance between consecutive points of a spectrum
+ * @param[in] input_distance Distance between first points of consecutive
+ *                           spectra
+ * @param[in] output_stride Distance between consecutive points of a signal
+ * @param[in] output_distance Distance between first points of consecutive
+ *                            signals
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_fft_batch(const std::complex<double>* input, double* output,
+                       std::size_t length, std::size_t num_transforms,
+                       std::size_t input_stride, std::size_t input_distance,
+                       std::size_t output_stride, std::size_t output_distance);
+
+/**
+ * Computes the real portion of the 1-dimensional inverse Fast Fourier
+ * Transform (FFT) of each row or column of the input matrix using a single MKL
+ * call
+ * @param[in] input_matrix Matrix of spectra to compute the inverse FFT of
+ * @param[in, out] output_matrix Matrix to write signals to. Resized to the
+ *                               dimensions of the input matrix.
+ * @param[in] rowwise Indicates that each row is a separate spectrum. Defaults
+ *                    to false where each column is a separate spectrum.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_fft_batch(const Eigen::MatrixXcd& input_matrix,
+                       Eigen::MatrixXd& output_matrix, bool rowwise = false);
+
+/**
+ * Committed MKL DFTI descriptor for 1-dimensional transforms of a fixed
+ * length, precision, domain, direction and placement. Plans are expensive to
+ * create but cheap to execute, so they should be reused for repeated
+ * transforms of the same length. Execution does not modify the plan, so a
+ * single plan can be shared between threads.
+ */
+class FftPlan {
+ public:
+  /**
+   * Floating point precision of transform
+   */
+  enum class Precision { Single, Double };
+
+  /**
+   * Forward domain of transform
+   */
+  enum class Domain { Real, Complex };
+
+  /**
+   * Direction of transform
+   */
+  enum class Direction { Forward, Backward };
+
+  /**
+   * Location of transform results
+   */
+  enum class Placement { InPlace, NotInPlace };
+
+  /**
+   * @constructor Delete default constructor
+   */
+  FftPlan() = delete;
+
+  /**
+   * @constructor Create and commit descriptor for transform. Backward
+   * transforms are scaled by 1 divided by the length so that they are the
+   * inverse of the forward transform. Throws exception if the descriptor can
+   * not be created or committed.
+   * @param[in] length Number of points in transform
+   * @param[in] direction Direction of transform
+   * @param[in] domain Forward domain of transform. Defaults to complex.
+   * @param[in] precision Precision of transform. Defaults to double.
+   * @param[in] placement Placement of transform results. Defaults to not in
+   *                      place.
+   */
+  FftPlan(std::size_t length, Direction direction,
+          Domain domain = Domain::Complex,
+          Precision precision = Precision::Double,
+          Placement placement = Placement::NotInPlace);
+
+  /**
+   * @constructor Create and commit descriptor for a batch of transforms that
+   * are computed in a single call. Strides and distances are in units of the
+   * input and output element types, so for real domain transforms they are
+   * in real elements on the real side and complex elements on the complex
+   * side. Throws exception if the descriptor can not be created or committed.
+   * @param[in] length Number of points in each transform
+   * @param[in] num_transforms Number of transforms in batch
+   * @param[in] input_stride Distance between consecutive input elements of a
+   *                         transform
+   * @param[in] input_distance Distance between first input elements of
+   *                           consecutive transforms
+   * @param[in] output_stride Distance between consecutive output elements of
+   *                          a transform
+   * @param[in] output_distance Distance between first output elements of
+   *                            consecutive transforms
+   * @param[in] direction Direction of transform
+   * @param[in] domain Forward domain of transform. Defaults to complex.
+   * @param[in] precision Precision of transform. Defaults to double.
+   * @param[in] placement Placement of transform results. Defaults to not in
+   *                      place.
+   */
+  FftPlan(std::size_t length, std::size_t num_transforms,
+          std::size_t input_stride, std::size_t input_distance,
+          std::size_t output_stride, std::size_t output_distance,
+          Direction direction, Domain domain = Domain::Complex,
+          Precision precision = Precision::Double,
+          Placement placement = Placement::NotInPlace);
+
+  /**
+   * @destructor Free descriptor
+   */
+  ~FftPlan();
+
+  /**
+   * Delete copy constructor
+   */
+  FftPlan(const FftPlan&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  FftPlan& operator=(const FftPlan&) = delete;
+
+  /**
+   * Execute transform in the direction of the plan. Throws exception if
+   * transform fails.
+   * @param[in] input Pointer to input data
+   * @param[in, out] output Pointer to location to write output to. Ignored for
+   *                        in place plans.
+   * @return Returns true if computations were successful
+   */
+  bool execute(void* input, void* output = nullptr) const;
+
+  /**
+   * Get the number of points in transform
+   * @return Length of transform
+   */
+  std::size_t length() const { return length_; };
+
+  /**
+   * Get the number of transforms computed in each execution
+   * @return Number of transforms in batch
+   */
+  std::size_t num_transforms() const { return num_transforms_; };
+
+  /**
+   * Get the direction of transform
+   * @return Direction of transform
+   */
+  Direction direction() const { return direction_; };
+
+  /**
+   * Get the forward domain of transform
+   * @return Domain of transform
+   */
+  Domain domain() const { return domain_; };
+
+  /**
+   * Get the precision of transform
+   * @return Precision of transform
+   */
+  Precision precision() const { return precision_; };
+
+  /**
+   * Get the placement of transform results
+   * @return Placement of transform results
+   */
+  Placement placement() const { return placement_; };
+
+ private:
+  std::size_t length_; /**< Number of points in transform */
+  std::size_t num_transforms_; /**< Number of transforms in batch */
+  Direction direction_; /**< Direction of transform */
+  Domain domain_; /**< Forward domain of transform */
+  Precision precision_; /**< Precision of transform */
+  Placement placement_; /**< Placement of transform results */
+  DFTI_DESCRIPTOR* descriptor_; /**< Committed MKL DFTI descriptor */
+};
+
+/**
+ * Thread-safe cache of FFT plans that persists across calls so that repeated
+ * transforms of the same length only create and commit a descriptor once.
+ * The number of cached plans is bounded, evicting the least recently used
+ * plan when the cache is full.
+ */
+class FftPlanCache {
+ public:
+  /**
+   * Get the single instance of the plan cache
+   */
+  static FftPlanCache* instance() {
+    static FftPlanCache cache;
+    return &cache;
+  }
+
+  /**
+   * Get plan for the requested transform, creating it if it is not already
+   * in the cache
+   * @param[in] length Number of points in transform
+   * @param[in] direction Direction of transform
+   * @param[in] domain Forward domain of transform. Defaults to complex.
+   * @param[in] precision Precision of transform. Defaults to double.
+   * @param[in] placement Placement of transform results. Defaults to not in
+   *                      place.
+   * @return Shared pointer to committed plan
+   */
+  std::shared_ptr<const FftPlan> get(
+      std::size_t length, FftPlan::Direction direction,
+      FftPlan::Domain domain = FftPlan::Domain::Complex,
+      FftPlan::Precision precision = FftPlan::Precision::Double,
+      FftPlan::Placement placement = FftPlan::Placement::NotInPlace);
+
+  /**
+   * Get plan for the requested batch of transforms, creating it if it is not
+   * already in the cache
+   * @param[in] length Number of points in each transform
+   * @param[in] num_transforms Number of transforms in batch
+   * @param[in] input_stride Distance between consecutive input elements of a
+   *                         transform
+   * @param[in] input_distance Distance between first input elements of
+   *                           consecutive transforms
+   * @param[in] output_stride Distance between consecutive output elements of
+   *                          a transform
+   * @param[in] output_distance Distance between first output elements of
+   *                            consecutive transforms
+   * @param[in] direction Direction of transform
+   * @param[in] domain Forward domain of transform. Defaults to complex.
+   * @param[in] precision Precision of transform. Defaults to double.
+   * @param[in] placement Placement of transform results. Defaults to not in
+   *                      place.
+   * @return Shared pointer to committed plan
+   */
+  std::shared_ptr<const FftPlan> get(
+      std::size_t length, std::size_t num_transforms, std::size_t input_stride,
+      std::size_t input_distance, std::size_t output_stride,
+      std::size_t output_distance, FftPlan::Direction direction,
+      FftPlan::Domain domain = FftPlan::Domain::Complex,
+      FftPlan::Precision precision = FftPlan::Precision::Double,
+      FftPlan::Placement placement = FftPlan::Placement::NotInPlace);
+
+  /**
+   * Get the number of plans in the cache
+   * @return Number of cached plans
+   */
+  std::size_t size() const;
+
+  /**
+   * Get the maximum number of plans in the cache
+   * @return Capacity of cache
+   */
+  std::size_t capacity() const;
+
+  /**
+   * Set the maximum number of plans in the cache, evicting least recently
+   * used plans if the cache holds more. Plans still held by callers remain
+   * valid.
+   * @param[in] capacity Maximum number of cached plans
+   */
+  void set_capacity(std::size_t capacity);
+
+  /**
+   * Remove all plans from the cache. Plans still held by callers remain valid.
+   */
+  void clear();
+
+  /**
+   * Delete copy constructor
+   */
+  FftPlanCache(const FftPlanCache&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  FftPlanCache& operator=(const FftPlanCache&) = delete;
+
+ private:
+  /**
+   * Private constructor
+   */
+  FftPlanCache() = default;
+
+  /**
+   * Key for plans in cache: length, number of transforms, input stride and
+   * distance, output stride and distance, direction, domain, precision and
+   * placement
+   */
+  using Key = std::tuple<std::size_t, std::size_t, std::size_t, std::size_t,
+                         std::size_t, std::size_t, FftPlan::Direction,
+                         FftPlan::Domain, FftPlan::Precision,
+                         FftPlan::Placement>;
+
+  /**
+   * Cached plan paired with its key
+   */
+  using Entry = std::pair<Key, std::shared_ptr<const FftPlan>>;
+
+  /**
+   * Evict least recently used plans until cache holds at most capacity plans.
+   * Mutex must be held by caller.
+   */
+  void evict();
+
+  std::size_t capacity_ = 64; /**< Maximum number of cached plans */
+  std::list<Entry> plans_; /**< Plans from most to least recently used */
+  std::map<Key, std::list<Entry>::iterator>
+      index_; /**< Plans in list indexed by key */
+  mutable std::mutex mutex_; /**< Mutex guarding access to cached plans */
+};
+
 /**
  * Calculate the integral of the input vector with uniform spacing
  * between data points
@@ -109,6 +659,75 @@ double trapazoid_rule(const std::vector<double>& input_vector, double spacing);
  */
 double trapazoid_rule(const Eigen::VectorXd& input_vector, double spacing);
 
+/**
+ * Evaluate a sum of harmonics with time-varying amplitudes at uniformly
+ * spaced times, such that
+ * output[i] = sum_j amplitudes(i, j) * cos(frequencies[j] * i * time_step +
+ * phases[j]). Instead of evaluating trigonometric functions for every term,
+ * cosines are advanced between time steps using the angle-addition
+ * recurrence over all frequencies at once and are resynchronized by direct
+ * evaluation every resync_interval time steps to bound accumulated rounding
+ * error. Relative error in each term grows roughly linearly with the number
+ * of steps since the last resynchronization and remains near machine
+ * precision for the default interval.
+ * @param[in] amplitudes Matrix of harmonic amplitudes where rows correspond to
+ *                       times and columns to frequencies
+ * @param[in] frequencies Vector of angular frequencies
+ * @param[in] phases Vector of phase angles for each frequency
+ * @param[in] time_step Time step between rows of amplitudes
+ * @param[out] output Vector to store sum of harmonics at each time to
+ * @param[in] resync_interval Number of time steps between direct evaluations
+ *                            of harmonics. Defaults to 64.
+ */
+void harmonic_synthesis(const Eigen::MatrixXd& amplitudes,
+                        const std::vector<double>& frequencies,
+                        const std::vector<double>& phases, double time_step,
+                        std::vector<double>& output,
+                        unsigned int resync_interval = 64);
+
+/**
+ * Evaluate a sum of harmonics with time-varying amplitudes at uniformly
+ * spaced times as described above, reading amplitudes for each time directly
+ * from a row-major matrix without copying
+ * @param[in] amplitudes Row-major matrix of harmonic amplitudes where rows
+ *                       correspond to times and columns to frequencies
+ * @param[in] frequencies Vector of angular frequencies
+ * @param[in] phases Vector of phase angles for each frequency
+ * @param[in] time_step Time step between rows of amplitudes
+ * @param[out] output Vector to store sum of harmonics at each time to
+ * @param[in] resync_interval Number of time steps between direct evaluations
+ *                            of harmonics. Defaults to 64.
+ */
+void harmonic_synthesis(const RowMatrixXd& amplitudes,
+                        const std::vector<double>& frequencies,
+                        const std::vector<double>& phases, double time_step,
+                        std::vector<double>& output,
+                        unsigned int resync_interval = 64);
+
+/**
+ * Evaluate a sum of harmonics with time-varying amplitudes at uniformly
+ * spaced times as described above in single precision. Harmonics are
+ * advanced and summed in 32-bit floating point, halving memory traffic,
+ * while resynchronization angles are evaluated in double precision so that
+ * errors do not grow with time. With eps = 2^-24, the error at each time is
+ * bounded by approximately (2 * resync_interval + log2(num_freqs) + 2) * eps
+ * multiplied by the sum of the absolute amplitudes at that time.
+ * @param[in] amplitudes Row-major matrix of single precision harmonic
+ *                       amplitudes where rows correspond to times and columns
+ *                       to frequencies
+ * @param[in] frequencies Vector of angular frequencies
+ * @param[in] phases Vector of phase angles for each frequency
+ * @param[in] time_step Time step between rows of amplitudes
+ * @param[out] output Vector to store sum of harmonics at each time to
+ * @param[in] resync_interval Number of time steps between direct evaluations
+ *                            of harmonics. Defaults to 64.
+ */
+void harmonic_synthesis(const RowMatrixXf& amplitudes,
+                        const std::vector<double>& frequencies,
+                        const std::vector<double>& phases, double time_step,
+                        std::vector<float>& output,
+                        unsigned int resync_interval = 64);
+
 /**
  * Fit polynomial to data, forcing y-intercept to zero
  * @param[in] points Vector of evaluation points
@@ -222,6 +841,103 @@ class RandomGenerator {
   int seed_ = static_cast<int>(
       std::time(nullptr)); /**< Seed value to use in random number generator */
 };
+
+/**
+ * Counter-based random number stream using the Philox4x32-10 generator
+ * (Salmon et al., 2011). Each stream is identified by a seed together with
+ * model, spectrum, simulation and stream indices, so independent, reproducible
+ * streams can be created for individual work items without sharing state.
+ * Numbers are a pure function of the key and position in the stream, so
+ * creating a stream and skipping ahead in it are constant time. Each stream
+ * provides 2^34 values. Satisfies the requirements of a uniform random bit
+ * generator, so it can be used with standard and Boost distributions.
+ */
+class RandomStream {
+ public:
+  /**
+   * Type of generated values
+   */
+  using result_type = std::uint32_t;
+
+  /**
+   * @constructor Construct random stream identified by input key
+   * @param[in] seed Seed value
+   * @param[in] model Identifier of model using stream. Defaults to 0.
+   * @param[in] spectrum Index of spectrum or parameter set. Defaults to 0.
+   * @param[in] sim Index of simulation. Defaults to 0.
+   * @param[in] stream Index of stream within simulation. Defaults to 0.
+   */
+  explicit RandomStream(unsigned long long seed, std::uint32_t model = 0,
+                        std::uint32_t spectrum = 0, std::uint32_t sim = 0,
+                        std::uint32_t stream = 0);
+
+  /**
+   * Minimum value generated
+   * @return Minimum value
+   */
+  static constexpr result_type min() { return 0; };
+
+  /**
+   * Maximum value generated
+   * @return Maximum value
+   */
+  static constexpr result_type max() { return 0xFFFFFFFF; };
+
+  /**
+   * Generate next value in stream
+   * @return Uniformly distributed 32-bit value
+   */
+  result_type operator()();
+
+  /**
+   * Generate next uniformly distributed double in [0, 1) with 53 bits of
+   * resolution. Consumes two values from the stream.
+   * @return Uniform random value
+   */
+  double uniform();
+
+  /**
+   * Skip ahead in stream in constant time
+   * @param[in] count Number of values to skip
+   */
+  void discard(unsigned long long count);
+
+  /**
+   * Create independent stream sharing seed, model, spectrum and simulation
+   * with this stream but with a different stream index
+   * @param[in] stream Index of new stream
+   * @return Random stream starting at beginning of new stream
+   */
+  RandomStream split(std::uint32_t stream) const;
+
+ private:
+  /**
+   * Generate block of 4 values for current counter
+   */
+  void generate_block();
+
+  unsigned long long seed_; /**< Seed value */
+  std::array<std::uint32_t, 2> key_; /**< Philox key built from seed and model */
+  std::array<std::uint32_t, 4> counter_; /**< Philox counter: block, stream,
+                                              sim and spectrum */
+  std::array<std::uint32_t, 4> block_; /**< Current block of random values */
+  unsigned int position_; /**< Position of next value in current block */
+};
+
+/**
+ * Get identifier to use for random streams based on name. This is a 32-bit
+ * FNV-1a hash of the input.
+ * @param[in] name Name to generate identifier for, such as model name
+ * @return Stream identifier
+ */
+std::uint32_t stream_id(const std::string& name);
+
+/**
+ * Reserve a time-based seed for random streams when no seed has been
+ * provided. Seeds returned within a process are unique.
+ * @return Seed value
+ */
+unsigned long long reserve_stream_seed();
 }  // namespace numeric_utils
 
 #endif  // _NUMERIC_UTILS_H_
@@ -0,0 +1,260 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "json_object.h"
+
+namespace utilities {
+
+/**
+ * Accumulated count and time of a single named stage. Stages are updated
+ * with atomic operations, so they can be shared by all threads.
+ */
+class ProfileStage {
+ public:
+  /**
+   * @constructor Construct stage with input name
+   * @param[in] name Name of stage
+   */
+  explicit ProfileStage(const std::string& name)
+      : name_{name}, count_{0}, nanoseconds_{0} {};
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~ProfileStage() {};
+
+  /**
+   * Delete copy constructor
+   */
+  ProfileStage(const ProfileStage&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  ProfileStage& operator=(const ProfileStage&) = delete;
+
+  /**
+   * Add calls or counted items and time spent to stage
+   * @param[in] count Number of calls or counted items
+   * @param[in] nanoseconds Time spent in nanoseconds
+   */
+  void add(unsigned long long count, unsigned long long nanoseconds) {
+    count_.fetch_add(count, std::memory_order_relaxed);
+    nanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+  };
+
+  /**
+   * Get name of stage
+   * @return Name of stage
+   */
+  const std::string& name() const { return name_; };
+
+  /**
+   * Get number of calls or counted items
+   * @return Accumulated count
+   */
+  unsigned long long count() const {
+    return count_.load(std::memory_order_relaxed);
+  };
+
+  /**
+   * Get time spent in stage
+   * @return Accumulated time in nanoseconds
+   */
+  unsigned long long nanoseconds() const {
+    return nanoseconds_.load(std::memory_order_relaxed);
+  };
+
+  /**
+   * Reset count and time to zero
+   */
+  void reset() {
+    count_.store(0, std::memory_order_relaxed);
+    nanoseconds_.store(0, std::memory_order_relaxed);
+  };
+
+ private:
+  std::string name_; /**< Name of stage */
+  std::atomic<unsigned long long> count_; /**< Number of calls or items */
+  std::atomic<unsigned long long> nanoseconds_; /**< Time spent in stage */
+};
+
+/**
+ * Aggregated statistics of a stage
+ */
+struct StageStatistics {
+  std::string name; /**< Name of stage */
+  unsigned long long count; /**< Number of calls or counted items */
+  double seconds; /**< Total time spent in stage, summed over threads */
+};
+
+/**
+ * Registry of named stages timed with scoped timers and counters placed in
+ * the hot paths of the library. Timing is disabled by default, in which case
+ * each timer costs a single relaxed atomic load. Instrumentation is only
+ * compiled in when SMELT_ENABLE_PROFILING is defined, otherwise the
+ * profiling macros expand to nothing and no stages are recorded. Times of
+ * nested stages are inclusive, and stages run in parallel accumulate the
+ * time spent by each thread.
+ */
+class Profiler {
+ public:
+  /**
+   * Get the profiler instance
+   * @return Pointer to profiler
+   */
+  static Profiler* instance();
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~Profiler() {};
+
+  /**
+   * Delete copy constructor
+   */
+  Profiler(const Profiler&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  Profiler& operator=(const Profiler&) = delete;
+
+  /**
+   * Enable or disable timing of stages
+   * @param[in] enabled Indicates whether stages should be timed
+   */
+  static void set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  };
+
+  /**
+   * Check whether timing of stages is enabled
+   * @return Returns true if stages are timed, false otherwise
+   */
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); };
+
+  /**
+   * Get stage with input name, registering it if it does not exist yet.
+   * References to stages remain valid for the lifetime of the program.
+   * @param[in] name Name of stage
+   * @return Reference to stage
+   */
+  ProfileStage& stage(const std::string& name);
+
+  /**
+   * Get aggregated statistics of all stages that have been recorded
+   * @return Vector of stage statistics sorted by stage name
+   */
+  std::vector<StageStatistics> statistics() const;
+
+  /**
+   * Get aggregated statistics of all stages that have been recorded as JSON,
+   * where each stage name maps to an object with the "count" and "seconds"
+   * of the stage
+   * @return JsonObject containing stage statistics
+   */
+  JsonObject to_json() const;
+
+  /**
+   * Reset counts and times of all stages to zero
+   */
+  void reset();
+
+ private:
+  /**
+   * @constructor Default constructor
+   */
+  Profiler() = default;
+
+  static std::atomic<bool> enabled_; /**< Indicates stages are timed */
+  mutable std::mutex mutex_; /**< Mutex guarding registration of stages */
+  std::map<std::string, std::unique_ptr<ProfileStage>>
+      stages_; /**< Registered stages */
+};
+
+/**
+ * Timer that adds the time between its construction and destruction to a
+ * stage when profiling is enabled
+ */
+class ScopedTimer {
+ public:
+  /**
+   * @constructor Start timing stage
+   * @param[in] stage Stage to add time to
+   */
+  explicit ScopedTimer(ProfileStage& stage)
+      : stage_{Profiler::enabled() ? &stage : nullptr} {
+    if (stage_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  };
+
+  /**
+   * @destructor Add elapsed time to stage
+   */
+  virtual ~ScopedTimer() {
+    if (stage_) {
+      stage_->add(1, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count());
+    }
+  };
+
+  /**
+   * Delete copy constructor
+   */
+  ScopedTimer(const ScopedTimer&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  ProfileStage* stage_; /**< Stage to add time to, null if disabled */
+  std::chrono::steady_clock::time_point start_; /**< Start time */
+};
+}  // namespace utilities
+
+#define SMELT_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SMELT_PROFILE_CONCAT(a, b) SMELT_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SMELT_ENABLE_PROFILING
+/**
+ * Time the remainder of the enclosing scope as the stage with input name
+ */
+#define SMELT_PROFILE_SCOPE(name)                                        \
+  static utilities::ProfileStage& SMELT_PROFILE_CONCAT(                  \
+      smelt_profile_stage_, __LINE__) =                                  \
+      utilities::Profiler::instance()->stage(name);                      \
+  utilities::ScopedTimer SMELT_PROFILE_CONCAT(smelt_profile_timer_,      \
+                                              __LINE__)(                 \
+      SMELT_PROFILE_CONCAT(smelt_profile_stage_, __LINE__))
+
+/**
+ * Add input number of items to the counter with input name
+ */
+#define SMELT_PROFILE_COUNT(name, items)                                 \
+  do {                                                                   \
+    static utilities::ProfileStage& smelt_profile_counter =              \
+        utilities::Profiler::instance()->stage(name);                    \
+    if (utilities::Profiler::enabled()) {                                \
+      smelt_profile_counter.add(items, 0);                               \
+    }                                                                    \
+  } while (false)
+#else
+#define SMELT_PROFILE_SCOPE(name)
+#define SMELT_PROFILE_COUNT(name, items) \
+  do {                                   \
+  } while (false)
+#endif
+
+#endif  // _PROFILER_H_
@@ -0,0 +1,116 @@
+#ifndef _QUANTILE_TABLE_H_
+#define _QUANTILE_TABLE_H_
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace stochastic {
+
+/**
+ * Tabulated inverse cumulative distribution function (quantile function).
+ * The quantile function is interpolated with monotone piecewise cubic
+ * polynomials on a uniform grid in the logit of the probability, which
+ * refines the grid geometrically towards both tails. The grid is doubled
+ * until the interpolation error at the midpoints and quarter points of every
+ * interval is within the requested tolerance. Tails that cannot meet the tolerance within the
+ * maximum table size, along with probabilities beyond the tabulated range,
+ * fall back to the exact quantile function. The table is built lazily on
+ * first evaluation, after which each evaluation is a constant time lookup.
+ */
+class QuantileTable {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  QuantileTable() = delete;
+
+  /**
+   * @constructor Construct table for input quantile function
+   * @param[in] quantile Exact quantile function to tabulate
+   * @param[in] tolerance Maximum interpolation error, relative to the
+   *                      magnitude of the location for locations larger than
+   *                      1 and absolute otherwise
+   */
+  QuantileTable(std::function<double(double)> quantile, double tolerance);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~QuantileTable() {};
+
+  /**
+   * Delete copy constructor
+   */
+  QuantileTable(const QuantileTable&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  QuantileTable& operator=(const QuantileTable&) = delete;
+
+  /**
+   * Evaluate quantile function at input probability, building table if it
+   * has not been built yet
+   * @param[in] probability Probability at which to evaluate quantile function
+   * @return Location corresponding to input probability
+   */
+  double evaluate(double probability) const;
+
+  /**
+   * Evaluate quantile function at a batch of probabilities, building table if
+   * it has not been built yet. Input and output buffers may be the same.
+   * @param[in] probabilities Buffer containing probabilities at which to
+   *                          evaluate quantile function
+   * @param[out] locations Buffer to write locations to
+   * @param[in] size Number of probabilities in batch
+   */
+  void evaluate(const double* probabilities, double* locations,
+                std::size_t size) const;
+
+  /**
+   * Get the interpolation error tolerance
+   * @return Tolerance table is built to
+   */
+  double tolerance() const { return tolerance_; };
+
+  /**
+   * Get the number of intervals in the table, building table if it has not
+   * been built yet
+   * @return Number of intervals
+   */
+  std::size_t num_intervals() const;
+
+ private:
+  /**
+   * Build table, doubling the number of intervals until the tolerance is met
+   * or the maximum number of intervals is reached
+   */
+  void build() const;
+
+  /**
+   * Interpolate quantile function within table. Returns exact quantile for
+   * probabilities outside the tabulated range.
+   * @param[in] probability Probability at which to evaluate quantile function
+   * @return Location corresponding to input probability
+   */
+  double interpolate(double probability) const;
+
+  std::function<double(double)> quantile_; /**< Exact quantile function */
+  double tolerance_; /**< Maximum interpolation error */
+  mutable std::once_flag built_; /**< Flag indicating table has been built */
+  mutable std::vector<double>
+      coefficients_; /**< Cubic coefficients for each interval, stored
+                        contiguously from constant to cubic term */
+  mutable std::size_t lower_index_ = 0; /**< First tabulated interval */
+  mutable std::size_t upper_index_ = 0; /**< One past last tabulated interval */
+  mutable double spacing_ = 0.0; /**< Spacing of grid in logit of probability */
+  const double MAX_LOGIT_ = 27.6; /**< Logit of largest tabulated probability,
+                                     approximately 1 - 1e-12 */
+  const std::size_t INITIAL_INTERVALS_ = 64; /**< Initial number of intervals */
+  const std::size_t MAX_INTERVALS_ = 16384; /**< Maximum number of intervals */
+};
+}  // namespace stochastic
+
+#endif  // _QUANTILE_TABLE_H_
@@ -0,0 +1,454 @@
+#ifndef _RECORD_WRITER_H_
+#define _RECORD_WRITER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "json_object.h"
+
+namespace utilities {
+
+/**
+ * Floating point precision used to store time history values
+ */
+enum class RecordPrecision {
+  Double, /**< 64-bit floating point values */
+  Single /**< 32-bit floating point values */
+};
+
+/**
+ * Abstract base class for sinks that receive generated event records one at a
+ * time. An event record consists of the event metadata in the same schema as
+ * the JSON output, but without the "data" entries of its time series, along
+ * with the values of each time series listed in the event "timeSeries" array.
+ */
+class RecordWriter {
+ public:
+  /**
+   * @constructor Default constructor
+   */
+  RecordWriter() = default;
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~RecordWriter() {};
+
+  /**
+   * Delete copy constructor
+   */
+  RecordWriter(const RecordWriter&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  RecordWriter& operator=(const RecordWriter&) = delete;
+
+  /**
+   * Write metadata that applies to all events, such as time step shared by
+   * all records. If called, this must be called before any records are
+   * written.
+   * @param[in] metadata Metadata for suite of events
+   * @return Returns true if successful, false otherwise
+   */
+  virtual bool write_header(const JsonObject& metadata) = 0;
+
+  /**
+   * Write single event record
+   * @param[in] event Event metadata without time series data
+   * @param[in] series Values of time series in the same order as the
+   *                   "timeSeries" entries of the event
+   * @return Returns true if successful, false otherwise
+   */
+  virtual bool write_record(const JsonObject& event,
+                            const std::vector<std::vector<double>>& series) = 0;
+
+  /**
+   * Write metadata that applies to all events but is only known once records
+   * have been written, such as profiling statistics. If called, this must be
+   * called before the writer is closed. Writers that do not support trailing
+   * metadata ignore it.
+   * @param[in] metadata Metadata to add to top level of output
+   * @return Returns true if metadata was written, false if unsupported
+   */
+  virtual bool write_trailer(const JsonObject& /*metadata*/) {
+    return false;
+  };
+
+  /**
+   * Finish writing records
+   * @return Returns true if successful, false otherwise
+   */
+  virtual bool close() = 0;
+};
+
+/**
+ * Record writer that collects events in memory as a JSON object. Header
+ * metadata is stored at the top level and records are stored, with time
+ * series data attached, in the "Events" array.
+ */
+class MemoryRecordWriter : public RecordWriter {
+ public:
+  /**
+   * @constructor Construct empty in-memory record writer
+   */
+  MemoryRecordWriter();
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~MemoryRecordWriter() {};
+
+  /**
+   * Delete copy constructor
+   */
+  MemoryRecordWriter(const MemoryRecordWriter&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  MemoryRecordWriter& operator=(const MemoryRecordWriter&) = delete;
+
+  /**
+   * Store metadata at top level of JSON object
+   * @param[in] metadata Metadata for suite of events
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_header(const JsonObject& metadata) override;
+
+  /**
+   * Append event, with time series data attached, to array of events
+   * @param[in] event Event metadata without time series data
+   * @param[in] series Values of time series in the same order as the
+   *                   "timeSeries" entries of the event
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_record(const JsonObject& event,
+                    const std::vector<std::vector<double>>& series) override;
+
+  /**
+   * Add metadata to top level of JSON object
+   * @param[in] metadata Metadata to add to top level of output
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_trailer(const JsonObject& metadata) override;
+
+  /**
+   * Finish collecting records
+   * @return Returns true if successful, false otherwise
+   */
+  bool close() override;
+
+  /**
+   * Get collected events
+   * @return JsonObject containing header metadata and array of events
+   */
+  JsonObject get_json() const;
+
+ private:
+  json header_; /**< Top level metadata */
+  json events_; /**< Array of events with data attached */
+};
+
+/**
+ * Record writer that streams events to a JSON file as soon as they are
+ * written, using the same schema as the in-memory JSON output: header
+ * metadata at the top level and events in the "Events" array with time series
+ * data attached. Only a single event is held in memory at a time. In pretty
+ * mode with default precision, output is byte-for-byte identical to writing
+ * the equivalent JsonObject with JsonObject::write_to_file.
+ */
+class JsonRecordWriter : public RecordWriter {
+ public:
+  /**
+   * @constructor Open JSON file for writing
+   * @param[in] output_location Location to write records to
+   * @param[in] pretty Indicates that output should be indented with 4 spaces
+   *                   per level. Otherwise output is written without any
+   *                   whitespace. Defaults to true.
+   * @param[in] precision Number of significant digits to write time series
+   *                      values with. A value of 0 writes the shortest
+   *                      representation that round-trips exactly. Defaults
+   *                      to 0.
+   */
+  JsonRecordWriter(const std::string& output_location, bool pretty = true,
+                   unsigned int precision = 0);
+
+  /**
+   * @destructor Virtual destructor. Closes file if still open.
+   */
+  virtual ~JsonRecordWriter();
+
+  /**
+   * Delete copy constructor
+   */
+  JsonRecordWriter(const JsonRecordWriter&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  JsonRecordWriter& operator=(const JsonRecordWriter&) = delete;
+
+  /**
+   * Store metadata to write at top level of JSON file
+   * @param[in] metadata Metadata for suite of events
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_header(const JsonObject& metadata) override;
+
+  /**
+   * Write event, with time series data attached, to array of events in file
+   * @param[in] event Event metadata without time series data
+   * @param[in] series Values of time series in the same order as the
+   *                   "timeSeries" entries of the event
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_record(const JsonObject& event,
+                    const std::vector<std::vector<double>>& series) override;
+
+  /**
+   * Store metadata to write at top level of JSON file. Once records have
+   * been written, keys must sort after "Events" so that the output keeps
+   * the same key order as the in-memory JSON output.
+   * @param[in] metadata Metadata to add to top level of output
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_trailer(const JsonObject& metadata) override;
+
+  /**
+   * Close array of events, write remaining header metadata and close file
+   * @return Returns true if successful, false otherwise
+   */
+  bool close() override;
+
+  /**
+   * Get the number of records written
+   * @return Number of records
+   */
+  unsigned long long num_records() const { return num_records_; };
+
+ private:
+  /**
+   * Write header metadata preceding array of events and open array
+   */
+  void write_prefix();
+
+  /**
+   * Write line break and indentation for input depth in pretty mode
+   * @param[in] depth Nesting depth
+   */
+  void write_indent(unsigned int depth);
+
+  /**
+   * Write object key followed by separator
+   * @param[in] key Key to write
+   */
+  void write_key(const std::string& key);
+
+  /**
+   * Write JSON value formatted for input nesting depth
+   * @param[in] value Value to write
+   * @param[in] depth Nesting depth of value
+   */
+  void write_value(const json& value, unsigned int depth);
+
+  /**
+   * Write time series values as JSON array
+   * @param[in] values Time series values
+   * @param[in] depth Nesting depth of array
+   */
+  void write_data(const std::vector<double>& values, unsigned int depth);
+
+  std::ofstream output_; /**< Output file */
+  bool pretty_; /**< Indicates output should be indented */
+  unsigned int precision_; /**< Significant digits for time series values */
+  json header_; /**< Top level metadata */
+  bool prefix_written_; /**< Indicates array of events has been opened */
+  unsigned long long num_records_; /**< Number of records written */
+};
+
+/**
+ * Record writer that streams events to a compact binary file as soon as they
+ * are written. All integers are unsigned and, like the time series values,
+ * stored in the byte order of the host that wrote the file. Every section
+ * starts at an offset that is a multiple of 8 bytes, so values can be read
+ * in place from a memory-mapped file. The layout is:
+ *   - 8-byte magic "SMELTBIN"
+ *   - uint64 byte order mark 0x0102030405060708, used by readers to reject
+ *     files written on a host with different byte order
+ *   - uint32 format version, uint32 precision (0 = float64, 1 = float32)
+ *   - uint64 length of header JSON, followed by compact header JSON padded
+ *     with spaces to a multiple of 8 bytes
+ *   - For each record: uint64 length of event JSON (never 0), padded event
+ *     JSON, uint64 number of time series, uint64 length of each time series,
+ *     then values of each time series, each padded with zeros to a multiple
+ *     of 8 bytes
+ *   - uint64 value of 0 marking end of records
+ */
+class BinaryRecordWriter : public RecordWriter {
+ public:
+  /**
+   * @constructor Open binary record file for writing
+   * @param[in] output_location Location to write records to
+   * @param[in] precision Precision to store time history values with.
+   *                      Defaults to double precision.
+   */
+  BinaryRecordWriter(const std::string& output_location,
+                     RecordPrecision precision = RecordPrecision::Double);
+
+  /**
+   * @destructor Virtual destructor. Closes file if still open.
+   */
+  virtual ~BinaryRecordWriter();
+
+  /**
+   * Delete copy constructor
+   */
+  BinaryRecordWriter(const BinaryRecordWriter&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  BinaryRecordWriter& operator=(const BinaryRecordWriter&) = delete;
+
+  /**
+   * Write metadata that applies to all events
+   * @param[in] metadata Metadata for suite of events
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_header(const JsonObject& metadata) override;
+
+  /**
+   * Write single event record to file
+   * @param[in] event Event metadata without time series data
+   * @param[in] series Values of time series in the same order as the
+   *                   "timeSeries" entries of the event
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_record(const JsonObject& event,
+                    const std::vector<std::vector<double>>& series) override;
+
+  /**
+   * Write end of records marker and close file
+   * @return Returns true if successful, false otherwise
+   */
+  bool close() override;
+
+  /**
+   * Get the number of records written
+   * @return Number of records
+   */
+  unsigned long long num_records() const { return num_records_; };
+
+ private:
+  /**
+   * Write file header with input metadata
+   * @param[in] metadata Metadata for suite of events
+   */
+  void write_file_header(const json& metadata);
+
+  std::ofstream output_; /**< Output file */
+  RecordPrecision precision_; /**< Precision of stored values */
+  bool header_written_; /**< Indicates file header has been written */
+  unsigned long long num_records_; /**< Number of records written */
+  std::vector<float> buffer_; /**< Buffer for single precision conversion */
+};
+
+/**
+ * Reader for files written by BinaryRecordWriter. Records are read one at a
+ * time, so memory use is bounded by the size of a single record.
+ */
+class BinaryRecordReader {
+ public:
+  /**
+   * @constructor Open binary record file and read header. Throws exception
+   * if the file is not a binary record file of the current version or was
+   * written on a host with different byte order.
+   * @param[in] input_location Location of binary record file
+   */
+  BinaryRecordReader(const std::string& input_location);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~BinaryRecordReader() {};
+
+  /**
+   * Delete copy constructor
+   */
+  BinaryRecordReader(const BinaryRecordReader&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  BinaryRecordReader& operator=(const BinaryRecordReader&) = delete;
+
+  /**
+   * Get metadata that applies to all events
+   * @return JsonObject containing header metadata
+   */
+  JsonObject header() const;
+
+  /**
+   * Get precision of stored values
+   * @return Precision of time history values in file
+   */
+  RecordPrecision precision() const { return precision_; };
+
+  /**
+   * Read next record in file
+   * @param[out] event Event metadata without time series data
+   * @param[out] series Values of time series in the same order as the
+   *                    "timeSeries" entries of the event
+   * @return Returns true if record was read, false if there are no more
+   *         records
+   */
+  bool next(JsonObject& event, std::vector<std::vector<double>>& series);
+
+  /**
+   * Get byte offsets in file of the values of each time series of the last
+   * record read. Useful for accessing values in memory-mapped files.
+   * @return Vector of byte offsets
+   */
+  std::vector<std::uint64_t> series_offsets() const { return offsets_; };
+
+ private:
+  std::ifstream input_; /**< Input file */
+  RecordPrecision precision_; /**< Precision of stored values */
+  json header_; /**< Header metadata */
+  bool finished_; /**< Indicates end of records has been reached */
+  std::vector<std::uint64_t> offsets_; /**< Offsets of last record series */
+  std::vector<float> buffer_; /**< Buffer for single precision conversion */
+};
+
+/**
+ * Merge JSON record files, such as the outputs of separate shards of a suite
+ * of events, into a single JSON file. Events are written in the order of the
+ * input files, so merging all shards of a suite in shard order reproduces the
+ * output of generating the full suite in a single process. Only one input
+ * file is held in memory at a time. Throws exception if inputs can not be
+ * read or their header metadata differs. "Profile" sections are not compared;
+ * the counts and times of their stages are summed over all inputs instead.
+ * @param[in] input_locations Locations of JSON record files to merge
+ * @param[in] output_location Location to write merged records to
+ * @return Returns true if successful, false otherwise
+ */
+bool merge_json_records(const std::vector<std::string>& input_locations,
+                        const std::string& output_location);
+
+/**
+ * Merge binary record files, such as the outputs of separate shards of a
+ * suite of events, into a single binary record file. Events are written in
+ * the order of the input files and are streamed one record at a time. Throws
+ * exception if inputs can not be read or their header metadata or precision
+ * differs.
+ * @param[in] input_locations Locations of binary record files to merge
+ * @param[in] output_location Location to write merged records to
+ * @return Returns true if successful, false otherwise
+ */
+bool merge_binary_records(const std::vector<std::string>& input_locations,
+                          const std::string& output_location);
+}  // namespace utilities
+
+#endif  // _RECORD_WRITER_H_
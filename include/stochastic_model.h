@@ -1,8 +1,12 @@
 #ifndef _STOCHASTIC_MODEL_H_
 #define _STOCHASTIC_MODEL_H_
 
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include "json_object.h"
+#include "profiler.h"
+#include "record_writer.h"
 
 namespace stochastic {
 
@@ -63,8 +67,177 @@ class StochasticModel {
                         const std::string& output_location,
                         bool units = false) = 0;
 
+  /**
+   * Generate loading based on stochastic model and pass each event record to
+   * the input record writer as soon as it has been generated, so the full
+   * suite of events does not need to be held in memory
+   * @param[in] event_name Name to assign to event
+   * @param[in, out] writer Record writer to write events to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  specific units. These units will depend on the subclass; the input
+   *                  just allows for ensuring outputs are in a certain unit.
+   * @return Returns true if successful, false otherwise
+   */
+  virtual bool generate(const std::string& event_name,
+                        utilities::RecordWriter& writer,
+                        bool units = false) = 0;
+
+  /**
+   * Get the number of event records produced by stochastic model
+   * @return Number of event records
+   */
+  virtual unsigned int num_records() const = 0;
+
+  /**
+   * Generate a single event record on demand. Random streams are selected by
+   * record index, so records can be requested in any order, consumers can
+   * stop early and index ranges can be generated by separate processes
+   * without generating the full suite of events.
+   * @param[in] event_name Name to assign to event
+   * @param[in] index Index of record to generate, less than num_records()
+   * @param[out] event Event metadata without time series data, in the same
+   *                   schema as the events passed to record writers
+   * @param[out] series Values of time series in the same order as the
+   *                    "timeSeries" entries of the event
+   * @param[in] units Indicates that time histories should be returned in
+   *                  specific units. These units will depend on the subclass; the input
+   *                  just allows for ensuring outputs are in a certain unit.
+   * @return Returns true if successful, false otherwise
+   */
+  virtual bool generate_record(const std::string& event_name,
+                               unsigned int index,
+                               utilities::JsonObject& event,
+                               std::vector<std::vector<double>>& series,
+                               bool units = false) = 0;
+
+  /**
+   * Set the floating point precision used for generated records. In single
+   * precision, records are rounded to the nearest 32-bit floating point
+   * values before being passed to record writers, so they can be stored by
+   * utilities::BinaryRecordWriter with RecordPrecision::Single without
+   * further loss, and the synthesis kernels of models that support it are
+   * evaluated in 32-bit floating point to halve their memory traffic. The
+   * resulting error bounds are documented by each model. Defaults to double
+   * precision.
+   * @param[in] precision Precision of generated records
+   */
+  void set_precision(utilities::RecordPrecision precision) {
+    precision_ = precision;
+  };
+
+  /**
+   * Get the floating point precision used for generated records
+   * @return Precision of generated records
+   */
+  utilities::RecordPrecision precision() const { return precision_; };
+
+  /**
+   * Set whether the statistics of the stages timed by utilities::Profiler
+   * should be added to the output of generate as a "Profile" section, in the
+   * format of utilities::Profiler::to_json. Statistics accumulate until the
+   * profiler is reset, and stages are only timed when profiling is compiled
+   * in and enabled. Defaults to false.
+   * @param[in] profile_output Indicates that profile should be output
+   */
+  void set_profile_output(bool profile_output) {
+    profile_output_ = profile_output;
+  };
+
+  /**
+   * Check whether profiling statistics are added to generated output
+   * @return Returns true if profile is output, false otherwise
+   */
+  bool profile_output() const { return profile_output_; };
+
+  /**
+   * Restrict generation to a single shard of the records so that a suite of
+   * events can be spread over separate processes. Records are split into
+   * num_shards contiguous index ranges of nearly equal size and generate
+   * only produces the records of the requested shard, with the same values
+   * they have when the full suite is generated by a single process using
+   * the same seed. Shard outputs can be combined with
+   * utilities::merge_json_records or utilities::merge_binary_records.
+   * @param[in] shard_id Index of shard to generate, less than num_shards
+   * @param[in] num_shards Total number of shards
+   */
+  void set_shard(unsigned int shard_id, unsigned int num_shards) {
+    if (num_shards == 0 || shard_id >= num_shards) {
+      throw std::runtime_error(
+          "\nERROR: in stochastic::StochasticModel::set_shard: Shard index "
+          "must be less than number of shards\n");
+    }
+    shard_id_ = shard_id;
+    num_shards_ = num_shards;
+  };
+
+  /**
+   * Get the index of the shard generated by model
+   * @return Shard index
+   */
+  unsigned int shard_id() const { return shard_id_; };
+
+  /**
+   * Get the total number of shards records are split into
+   * @return Number of shards
+   */
+  unsigned int num_shards() const { return num_shards_; };
+
+  /**
+   * Get the index of the first record in shard
+   * @return Index of first record
+   */
+  unsigned int shard_begin() const { return shard_bound(shard_id_); };
+
+  /**
+   * Get the index one past the last record in shard
+   * @return Index one past last record
+   */
+  unsigned int shard_end() const { return shard_bound(shard_id_ + 1); };
+
  protected:
+  /**
+   * Write profiling statistics to record writer, if requested
+   * @param[in, out] writer Record writer to write profile to
+   */
+  void write_profile(utilities::RecordWriter& writer) const {
+    if (profile_output_) {
+      utilities::JsonObject profile;
+      profile.add_value("Profile", utilities::Profiler::instance()->to_json());
+      writer.write_trailer(profile);
+    }
+  };
+
+  /**
+   * Round time series values to the precision of generated records
+   * @param[in, out] series Time series values to round
+   */
+  void round_to_precision(std::vector<std::vector<double>>& series) const {
+    if (precision_ == utilities::RecordPrecision::Single) {
+      for (auto& values : series) {
+        for (auto& value : values) {
+          value = static_cast<float>(value);
+        }
+      }
+    }
+  };
+
+  /**
+   * Get the index of the first record of a shard
+   * @param[in] shard_id Index of shard
+   * @return Index of first record
+   */
+  unsigned int shard_bound(unsigned int shard_id) const {
+    return static_cast<unsigned int>(
+        static_cast<unsigned long long>(num_records()) * shard_id /
+        num_shards_);
+  };
+
   std::string model_name_ = "StochasticModel"; /**< Name of stochastic model */  
+  unsigned int shard_id_ = 0; /**< Index of shard to generate */
+  unsigned int num_shards_ = 1; /**< Number of shards records are split into */
+  bool profile_output_ = false; /**< Indicates profile should be output */
+  utilities::RecordPrecision precision_ =
+      utilities::RecordPrecision::Double; /**< Precision of generated records */
 };
 }  // namespace stochastic
 
@@ -0,0 +1,100 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utilities {
+
+/**
+ * Fixed-size pool of worker threads used to distribute independent, indexed
+ * work items. The thread calling parallel_for participates in the work, so a
+ * pool of size N uses N - 1 background workers.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @constructor Construct thread pool with requested number of threads
+   * @param[in] num_threads Total number of threads to use, including the
+   *                        calling thread. A value of 0 uses the number of
+   *                        hardware threads available.
+   */
+  explicit ThreadPool(unsigned int num_threads = 0);
+
+  /**
+   * @destructor Virtual destructor. Joins all worker threads.
+   */
+  virtual ~ThreadPool();
+
+  /**
+   * Delete copy constructor
+   */
+  ThreadPool(const ThreadPool&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * Get the total number of threads used by the pool, including the calling
+   * thread
+   * @return Number of threads
+   */
+  unsigned int size() const {
+    return static_cast<unsigned int>(workers_.size()) + 1;
+  };
+
+  /**
+   * Evaluate task for every index in [0, num_items) and block until all items
+   * have been processed. Items are handed out dynamically, so no assumptions
+   * should be made about which thread evaluates an index or in which order.
+   * If any task throws, remaining items are abandoned and the first exception
+   * is rethrown in the calling thread. Tasks must not call parallel_for on the
+   * same pool.
+   * @param[in] num_items Number of work items
+   * @param[in] task Function to evaluate for each work item index
+   */
+  void parallel_for(std::size_t num_items,
+                    const std::function<void(std::size_t)>& task);
+
+  /**
+   * Get the number of hardware threads available, falling back to 1 when
+   * this cannot be determined
+   * @return Number of hardware threads
+   */
+  static unsigned int hardware_threads();
+
+ private:
+  /**
+   * Loop run by each worker thread waiting for and processing work
+   */
+  void worker_loop();
+
+  /**
+   * Process work items of the current job until none remain
+   */
+  void run_items();
+
+  std::vector<std::thread> workers_; /**< Background worker threads */
+  std::mutex dispatch_mutex_; /**< Serializes calls to parallel_for */
+  std::mutex mutex_; /**< Guards job state shared with workers */
+  std::condition_variable work_available_; /**< Signals new job or stop */
+  std::condition_variable work_done_; /**< Signals all workers finished job */
+  const std::function<void(std::size_t)>* task_; /**< Current job task */
+  std::size_t num_items_; /**< Number of items in current job */
+  std::atomic<std::size_t> next_item_; /**< Next unclaimed item index */
+  std::size_t pending_workers_; /**< Workers yet to finish current job */
+  unsigned long long generation_; /**< Job counter used to wake workers */
+  bool stop_; /**< Indicates workers should exit */
+  std::exception_ptr error_; /**< First exception thrown by current job */
+};
+}  // namespace utilities
+
+#endif  // _THREAD_POOL_H_
@@ -1,6 +1,7 @@
 #ifndef _VLACHOS_ET_AL_H_
 #define _VLACHOS_ET_AL_H_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -68,6 +69,34 @@ class VlachosEtAl : public StochasticModel {
               double orientation, unsigned int num_spectra,
               unsigned int num_sims, int seed_value);  
 
+  /**
+   * @constructor Construct scenario specific ground motion model that
+   * generates a single shard of the suite of time histories. All shards of a
+   * suite must be constructed with the same parameters and seed, in which
+   * case each shard produces the same records as a single model generating
+   * the full suite.
+   * @param[in] moment_magnitude Moment magnitude of earthquake scenario
+   * @param[in] rupture_distance Closest-to-site rupture distance in kilometers
+   * @param[in] vs30 Soil shear wave velocity averaged over top 30 meters in
+   *                 meters per second
+   * @param[in] orientation Orientation of acceleration relative to global
+   *                        coordinates. Represents counter-clockwise angle (in
+   *                        degrees) away from x-axis rotating around z-axis in
+   *                        right-handed coordinate system.
+   * @param[in] num_spectra Total number of evolutionary power spectra in
+   *                        suite
+   * @param[in] num_sims Number of simulated ground motion time histories that
+   *                     should be generated per evolutionary power
+   * @param[in] seed_value Value to seed random variables with to ensure
+   *                       repeatability
+   * @param[in] shard_id Index of shard to generate
+   * @param[in] num_shards Total number of shards suite is split into
+   */
+  VlachosEtAl(double moment_magnitude, double rupture_distance, double vs30,
+              double orientation, unsigned int num_spectra,
+              unsigned int num_sims, int seed_value, unsigned int shard_id,
+              unsigned int num_shards);
+
   /**
    * @destructor Virtual destructor
    */
@@ -111,16 +140,131 @@ class VlachosEtAl : public StochasticModel {
                 const std::string& output_location,
                 bool units = false) override;
 
+  /**
+   * Generate ground motion time histories based on input parameters and pass
+   * each event to the record writer as soon as it has been generated. Throws
+   * exception if errors are encountered during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in, out] writer Record writer to write events to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Returns true if successful, false otherwise
+   */
+  bool generate(const std::string& event_name, utilities::RecordWriter& writer,
+                bool units = false) override;
+
+  /**
+   * Get the number of event records produced by model
+   * @return Number of spectra multiplied by number of simulations per spectrum
+   */
+  unsigned int num_records() const override {
+    return num_spectra_ * num_sims_;
+  };
+
+  /**
+   * Generate a single ground motion event on demand. Record index i
+   * corresponds to simulation i % num_sims of spectrum i / num_sims and is
+   * identical to the i-th event produced by generate for the same random
+   * streams. The amplitude spectrum of the most recently requested spectrum
+   * is cached, so iterating over records in order computes each spectrum once.
+   * Throws exception if index is out of range or errors are encountered
+   * during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in] index Index of record to generate
+   * @param[out] event Event metadata without time series data
+   * @param[out] series Acceleration time histories in x and y directions
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Returns true if successful, false otherwise
+   */
+  bool generate_record(const std::string& event_name, unsigned int index,
+                       utilities::JsonObject& event,
+                       std::vector<std::vector<double>>& series,
+                       bool units = false) override;
+
+  /**
+   * Set the number of threads used to generate time histories. Results for a
+   * given seed do not depend on the number of threads.
+   * @param[in] num_threads Number of threads to use. A value of 0 uses the
+   *                        number of hardware threads available.
+   */
+  void set_num_threads(unsigned int num_threads) { num_threads_ = num_threads; };
+
+  /**
+   * Get the number of threads used to generate time histories
+   * @return Number of threads, where 0 indicates all hardware threads
+   */
+  unsigned int num_threads() const { return num_threads_; };
+
+  /**
+   * Tabulate the inverse CDFs of the Beta, inverse Gaussian and Student's t
+   * marginal distributions of the model parameters and transform the
+   * parameter realizations to physical space again using the tables. Seeded
+   * models redraw the same realizations as during construction. Must not be
+   * called while generating time histories.
+   * @param[in] tolerance Maximum interpolation error of tabulated inverse
+   *                      CDFs
+   */
+  void set_quantile_tolerance(double tolerance);
+
+  /**
+   * Get the interpolation error tolerance of tabulated inverse CDFs
+   * @return Tolerance, where 0 indicates inverse CDFs are evaluated exactly
+   */
+  double quantile_tolerance() const { return quantile_tolerance_; };
+
   /**
    * Compute a family of time histories for a particular power spectrum
    * @param[in, out] time_histories Location where time histories should be
    *                                stored
    * @param[in] parameters Set of model parameters to use for calculating power
    *                       specturm and time histories
+   * @param[in] spectrum_index Index of power spectrum the family belongs to.
+   *                           Used to select the random streams of the
+   *                           family.
+   *                           Defaults to 0.
    * @return Returns true if successful, false otherwise
    */
   bool time_history_family(std::vector<std::vector<double>>& time_histories,
-                           const Eigen::VectorXd& parameters) const;
+                           const Eigen::VectorXd& parameters,
+                           unsigned int spectrum_index = 0) const;
+
+  /**
+   * Compute the discretized evolutionary power spectrum for a set of model
+   * parameters along with the impulse response of the highpass Butterworth
+   * filter used in post-processing
+   * @param[in] parameters Set of model parameters to use for calculating power
+   *                       specturm
+   * @param[out] power_spectrum Matrix to store values of power spectrum over
+   *                            range of frequencies at specified times to
+   * @param[out] impulse_response Vector to store filter impulse response to
+   * @return Returns true if successful, false otherwise
+   */
+  bool power_spectrum_and_filter(const Eigen::VectorXd& parameters,
+                                 Eigen::MatrixXd& power_spectrum,
+                                 std::vector<double>& impulse_response) const;
+
+  /**
+   * Compute the amplitudes of the harmonics summed in Eq-19 for a set of
+   * model parameters, which are the square root of the discretized
+   * evolutionary power spectrum scaled by the frequency step, along with the
+   * impulse response of the highpass Butterworth filter used in
+   * post-processing. Amplitudes are stored row-major so the amplitudes at
+   * each time are contiguous, and can be shared by all time history
+   * realizations of the spectrum.
+   * @param[in] parameters Set of model parameters to use for calculating power
+   *                       specturm
+   * @param[out] amplitudes Matrix to store harmonic amplitudes to, where rows
+   *                        correspond to times and columns to frequencies
+   * @param[out] impulse_response Vector to store filter impulse response to
+   * @return Returns true if successful, false otherwise
+   */
+  bool amplitude_spectrum_and_filter(
+      const Eigen::VectorXd& parameters,
+      numeric_utils::RowMatrixXd& amplitudes,
+      std::vector<double>& impulse_response) const;
 
   /**
    * Simulate fully non-stationary ground motion sample realization based on
@@ -129,9 +273,39 @@ class VlachosEtAl : public StochasticModel {
    * @param[in, out] time_history Location where time history should be stored
    * @param[in] power_spectrum Matrix containing values of power spectrum over
    *                           range of frequencies at specified times.
+   * @param[in, out] random_stream Random stream to draw phase angles from
    */
   void simulate_time_history(std::vector<double>& time_history,
-                             const Eigen::MatrixXd& power_spectrum) const;
+                             const Eigen::MatrixXd& power_spectrum,
+                             numeric_utils::RandomStream& random_stream) const;
+
+  /**
+   * Simulate fully non-stationary ground motion sample realization from
+   * precomputed harmonic amplitudes, as described by Eq-19 on page 8
+   * @param[in, out] time_history Location where time history should be stored
+   * @param[in] amplitudes Harmonic amplitudes computed by
+   *                       amplitude_spectrum_and_filter
+   * @param[in, out] random_stream Random stream to draw phase angles from
+   */
+  void synthesize_time_history(
+      std::vector<double>& time_history,
+      const numeric_utils::RowMatrixXd& amplitudes,
+      numeric_utils::RandomStream& random_stream) const;
+
+  /**
+   * Simulate fully non-stationary ground motion sample realization from
+   * precomputed single precision harmonic amplitudes, as described by Eq-19
+   * on page 8. Harmonics are summed in 32-bit floating point, with errors
+   * bounded as described for numeric_utils::harmonic_synthesis, and the
+   * phase angles drawn match those of the double precision version.
+   * @param[in, out] time_history Location where time history should be stored
+   * @param[in] amplitudes Single precision harmonic amplitudes
+   * @param[in, out] random_stream Random stream to draw phase angles from
+   */
+  void synthesize_time_history(
+      std::vector<double>& time_history,
+      const numeric_utils::RowMatrixXf& amplitudes,
+      numeric_utils::RandomStream& random_stream) const;
 
   /**
    * Post-process the input time history as described in Vlachos et al. using
@@ -246,6 +420,55 @@ class VlachosEtAl : public StochasticModel {
                            std::vector<double>& y_accels, bool g_units) const;
 
  private:
+  /**
+   * Get the random stream for a particular time history realization
+   * @param[in] spectrum_index Index of power spectrum
+   * @param[in] sim_index Index of simulation for power spectrum
+   * @return Random stream for realization
+   */
+  numeric_utils::RandomStream realization_stream(
+      unsigned int spectrum_index, unsigned int sim_index) const;
+
+  /**
+   * Transform realizations of normal model parameters to physical space and
+   * identify valid modal frequency parameters for every spectrum
+   */
+  void transform_model_parameters();
+
+  /**
+   * Create metadata for a ground motion event
+   * @param[in] name Name of event
+   * @param[in] num_steps Number of time steps in event time histories
+   * @return JsonObject containing event metadata without time series data
+   */
+  utilities::JsonObject event_metadata(const std::string& name,
+                                       std::size_t num_steps) const;
+
+  /**
+   * Get the frequencies of the harmonics summed in Eq-19 and draw their
+   * random phase angles
+   * @param[in] num_freqs Number of harmonics
+   * @param[in, out] random_stream Random stream to draw phase angles from
+   * @param[out] frequencies Vector to store angular frequencies to
+   * @param[out] phase_angles Vector to store phase angles to
+   */
+  void harmonic_phases(unsigned int num_freqs,
+                       numeric_utils::RandomStream& random_stream,
+                       std::vector<double>& frequencies,
+                       std::vector<double>& phase_angles) const;
+
+  /**
+   * Compute the discretized evolutionary power spectrum in row-major order
+   * along with the impulse response of the highpass Butterworth filter
+   * @param[in] parameters Set of model parameters to use for calculating power
+   *                       specturm
+   * @param[out] power_spectrum Matrix to store values of power spectrum to
+   * @param[out] impulse_response Vector to store filter impulse response to
+   */
+  void spectrum_and_filter(const Eigen::VectorXd& parameters,
+                           numeric_utils::RowMatrixXd& power_spectrum,
+                           std::vector<double>& impulse_response) const;
+
   double moment_magnitude_; /**< Moment magnitude for scenario */
   double rupture_dist_; /**< Closest-to-site rupture distance in kilometers */
   double vs30_; /**< Soil shear wave velocity averaged over top 30 meters in
@@ -260,10 +483,25 @@ class VlachosEtAl : public StochasticModel {
                              that should be generated per evolutionary power
                              spectrum */
   int seed_value_; /**< Integer to seed random distributions with */
+  unsigned long long stream_seed_; /**< Seed for time history random streams */
+  unsigned int num_threads_; /**< Number of threads used for generation */
+  double quantile_tolerance_ = 0.0; /**< Tolerance of tabulated inverse CDFs,
+                                       0 if evaluated exactly */
+  unsigned int record_spectrum_; /**< Index of spectrum cached for on demand
+                                    record generation */
+  numeric_utils::RowMatrixXd record_amplitudes_; /**< Cached amplitude
+                                                   spectrum */
+  numeric_utils::RowMatrixXf record_amplitudes_single_; /**< Cached single
+                                                          precision amplitude
+                                                          spectrum */
+  std::vector<double> record_impulse_response_; /**< Cached filter impulse
+                                                   response */
   Eigen::VectorXd means_; /**< Mean values of model parameters */
   Eigen::MatrixXd covariance_; /**< Covariance matrix for model parameters */
   std::vector<std::shared_ptr<stochastic::Distribution>>
       model_parameters_; /**< Distrubutions for 18-parameter model */
+  std::shared_ptr<const stochastic::Distribution>
+      std_normal_dist_; /**< Standard normal distribution */
   Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>
       parameter_realizations_; /**< Random realizations of normal model parameters */
   Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>
@@ -127,6 +127,47 @@ class WittigSinha : public StochasticModel {
   bool generate(const std::string& event_name,
                 const std::string& output_location, bool units = false) override;
 
+  /**
+   * Generate wind velocity time histories based on Wittig & Sinha (1975) model
+   * with provided inputs and pass event to the record writer
+   * @param[in] event_name Name to assign to event
+   * @param[in, out] writer Record writer to write events to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Defaults to false where time histories
+   *                  are returned in units of m/s
+   * @return Returns true if successful, false otherwise
+   */
+  bool generate(const std::string& event_name, utilities::RecordWriter& writer,
+                bool units = false) override;
+
+  /**
+   * Get the number of event records produced by model
+   * @return Number of horizontal locations at which velocities are generated
+   */
+  unsigned int num_records() const override {
+    return static_cast<unsigned int>(local_x_.size() * local_y_.size());
+  };
+
+  /**
+   * Generate wind velocity time histories at all floors for a single
+   * horizontal location on demand. Record index i corresponds to the random
+   * stream of location i, so record 0 is identical to the event produced by
+   * generate for the same random streams. Throws exception if index is out
+   * of range or errors are encountered during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in] index Index of record to generate
+   * @param[out] event Event metadata without time series data
+   * @param[out] series Velocity time histories for each floor
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Defaults to false where time histories
+   *                  are returned in units of m/s
+   * @return Returns true if successful, false otherwise
+   */
+  bool generate_record(const std::string& event_name, unsigned int index,
+                       utilities::JsonObject& event,
+                       std::vector<std::vector<double>>& series,
+                       bool units = false) override;
+
   /**
    * Calculate the cross-spectral density matrix 
    * @param[in] frequency Frequency at which to calculate cross-spectral density
@@ -137,9 +178,12 @@ class WittigSinha : public StochasticModel {
   /**
    * Generate matrix of complex random number from standard normal distribution scaled
    * by lower Cholesky decomposition of the cross-spectral density matrix
+   * @param[in] location_index Index of horizontal location the random numbers
+   *                           are for. Each location uses an independent
+   *                           random stream. Defaults to 0.
    * @return A matrix containing complex random numbers
    */
-  Eigen::MatrixXcd complex_random_numbers() const;
+  Eigen::MatrixXcd complex_random_numbers(unsigned int location_index = 0) const;
 
   /**
    * Generate velocity time histories at vertical location specified
@@ -157,12 +201,35 @@ class WittigSinha : public StochasticModel {
                                         unsigned int column_index,
                                         bool units) const;
 
+  /**
+   * Generate velocity time histories at all vertical locations using a single
+   * batch of inverse Fast Fourier Transforms
+   * @param[in] random_numbers Matrix of complex random numbers to use for
+   *                           velocity time history generation where each
+   *                           column corresponds to a vertical location
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Otherwise time histories are returned
+   *                  in units of m/s
+   * @return Vector containing velocity time histories for each vertical
+   *         location
+   */
+  std::vector<std::vector<double>> gen_location_hists(
+      const Eigen::MatrixXcd& random_numbers, bool units) const;
+
  private:
+  /**
+   * Create metadata for wind event with patterns and time series for each
+   * floor
+   * @return JsonObject containing event metadata without time series data
+   */
+  utilities::JsonObject event_metadata() const;
+
   std::string exposure_category_; /**< Exposure category for building based on ASCE-7 */
   double gust_speed_; /**< Gust speed for wind */
   double bldg_height_; /**< Height of building */
   unsigned int num_floors_; /**< Number of floors */
   int seed_value_; /**< Integer to seed random distributions with */
+  unsigned long long stream_seed_; /**< Seed for random streams */
   std::vector<double> heights_; /**< Locations along building height at which
                                    velocities are generated */
   std::vector<double> local_x_; /**< Locations along local x-axis at which to
@@ -60,6 +60,10 @@ void config::initialize() {
   static Register<stochastic::StochasticModel, stochastic::VlachosEtAl, double,
                   double, double, double, unsigned int, unsigned int, int>
       vlachos_et_al_seed("VlachosSiteSpecificEQ");
+  static Register<stochastic::StochasticModel, stochastic::VlachosEtAl, double,
+                  double, double, double, unsigned int, unsigned int, int,
+                  unsigned int, unsigned int>
+      vlachos_et_al_shard("VlachosSiteSpecificEQ");
   static Register<stochastic::StochasticModel, stochastic::DabaghiDerKiureghian,
                   stochastic::FaultType, stochastic::SimulationType, double,
                   double, double, double, double, double, unsigned int,
@@ -70,6 +74,11 @@ void config::initialize() {
                   double, double, double, double, double, unsigned int,
                   unsigned int, bool, int>
       dabaghi_der_kiureghian_seed("DabaghiDerKiureghianNFGM");
+  static Register<stochastic::StochasticModel, stochastic::DabaghiDerKiureghian,
+                  stochastic::FaultType, stochastic::SimulationType, double,
+                  double, double, double, double, double, unsigned int,
+                  unsigned int, bool, int, unsigned int, unsigned int>
+      dabaghi_der_kiureghian_shard("DabaghiDerKiureghianNFGM");
 
   // Wind
   static Register<stochastic::StochasticModel, stochastic::WittigSinha,
@@ -18,12 +18,16 @@
 #include "beta_dist.h"
 #include "dabaghi_der_kiureghian.h"
 #include "factory.h"
-#include "function_dispatcher.h"
+#include "filter_cache.h"
 #include "json_object.h"
+#include "levenberg_marquardt.h"
 #include "nelder_mead.h"
 #include "normal_dist.h"
 #include "normal_multivar.h"
 #include "numeric_utils.h"
+#include "profiler.h"
+#include "record_writer.h"
+#include "thread_pool.h"
 
 stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
     stochastic::FaultType faulting, stochastic::SimulationType simulation_type,
@@ -42,6 +46,7 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
       truncate_{truncate},
       num_realizations_{num_realizations},
       seed_value_{std::numeric_limits<int>::infinity()},
+      stream_seed_{numeric_utils::reserve_stream_seed()},
       time_step_{0.005}
 {
   model_name_ = "DabaghiDerKiureghian";
@@ -180,6 +185,8 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
 
   params_fitted3_ << 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0;
   // clang-format on  
+
+  build_marginal_transforms();
 }
 
 stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
@@ -199,6 +206,9 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
       truncate_{truncate},
       num_realizations_{num_realizations},
       seed_value_{seed_value},
+      stream_seed_{seed_value != std::numeric_limits<int>::infinity()
+                       ? static_cast<unsigned long long>(seed_value)
+                       : numeric_utils::reserve_stream_seed()},
       time_step_{0.005}
 {
   model_name_ = "DabaghiDerKiureghian";
@@ -337,186 +347,165 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
 
   params_fitted3_ << 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0;
   // clang-format on
+
+  build_marginal_transforms();
+}
+
+stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
+    stochastic::FaultType faulting, stochastic::SimulationType simulation_type,
+    double moment_magnitude, double depth_to_rupt, double rupture_distance,
+    double vs30, double s_or_d, double theta_or_phi, unsigned int num_sims,
+    unsigned int num_realizations, bool truncate, int seed_value,
+    unsigned int shard_id, unsigned int num_shards)
+    : DabaghiDerKiureghian(faulting, simulation_type, moment_magnitude,
+                           depth_to_rupt, rupture_distance, vs30, s_or_d,
+                           theta_or_phi, num_sims, num_realizations, truncate,
+                           seed_value) {
+  set_shard(shard_id, num_shards);
 }
 
 utilities::JsonObject stochastic::DabaghiDerKiureghian::generate(
     const std::string& event_name, bool units) {
+  utilities::MemoryRecordWriter events;
+  generate(event_name, events, units);
+  return events.get_json();
+}
 
-  // Create vectors for pulse-like and non-pulse-like motions
-  std::vector<std::vector<std::vector<double>>> pulse_motions_comp1(
-      num_sims_pulse_, std::vector<std::vector<double>>(num_realizations_,
-                                                        std::vector<double>()));
-
-  std::vector<std::vector<std::vector<double>>> pulse_motions_comp2(
-      num_sims_pulse_, std::vector<std::vector<double>>(num_realizations_,
-                                                        std::vector<double>()));
-
-  std::vector<std::vector<std::vector<double>>> nopulse_motions_comp1(
-      num_sims_nopulse_, std::vector<std::vector<double>>(
-                             num_realizations_, std::vector<double>()));
-
-  std::vector<std::vector<std::vector<double>>> nopulse_motions_comp2(
-      num_sims_nopulse_, std::vector<std::vector<double>>(
-                             num_realizations_, std::vector<double>()));
-
-  // Generated simulated acceleration time histories
+bool stochastic::DabaghiDerKiureghian::generate(
+    const std::string& event_name, utilities::RecordWriter& writer,
+    bool units) {
+  std::vector<std::vector<double>> accels(2);
+
+  // Generated simulated acceleration time histories and write events once
+  // all realizations for a parameter set have been generated. Parameter sets
+  // are processed in blocks the size of the thread pool, where each worker
+  // simulates, truncates and baseline corrects all realizations of a set in
+  // its own workspace. Sets only depend on their simulated parameters, so
+  // results do not depend on the number of threads.
   try {
-    // Simulate model parameters
-    Eigen::MatrixXd parameters_pulse =
-        simulate_model_parameters(true, num_sims_pulse_);
-    Eigen::MatrixXd parameters_nopulse =
-        simulate_model_parameters(false, num_sims_nopulse_);
-
-    // Simulate pulse-like motions
-    for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        simulate_near_fault_ground_motion(
-            true, parameters_pulse.row(i), pulse_motions_comp1[i],
-            pulse_motions_comp2[i], num_realizations_);
-    } 
-
-    // Simulate non-pulse-like motions
-    for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-      simulate_near_fault_ground_motion(
-          false, parameters_nopulse.row(i), nopulse_motions_comp1[i],
-          nopulse_motions_comp2[i], num_realizations_);
+    // Draw new parameters and seeds for every call when no seed has been
+    // provided
+    if (seed_value_ == std::numeric_limits<int>::infinity()) {
+      stream_seed_ = numeric_utils::reserve_stream_seed();
+      parameters_simulated_ = false;
+      record_set_cached_ = false;
     }
 
-    // If requested, truncate and baseline correct time histories
-    double gfactor = 981;
-    unsigned int fit_order = 5;
-    if (truncate_) {
-      // First truncate motions
-      for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        truncate_time_histories(pulse_motions_comp1[i], pulse_motions_comp2[i],
-                                gfactor);
-      }
-
-      for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-        truncate_time_histories(nopulse_motions_comp1[i],
-                                nopulse_motions_comp2[i], gfactor);
-      }
-
-      // Baseline correct truncated pulse-like motions
-      for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        for (unsigned int j = 0; j < num_realizations_; ++j) {
-          baseline_correct_time_history(pulse_motions_comp1[i][j], gfactor,
-                                        fit_order);
-          baseline_correct_time_history(pulse_motions_comp2[i][j], gfactor,
-                                        fit_order);
-        }
-      }
+    // Simulate model parameters. Parameters are simulated for all sets, even
+    // when generating a single shard, so every set receives the same random
+    // draws as when generating the full suite.
+    simulate_suite_parameters();
 
-      // Baseline correct trunacted non-pulse-like motions
-      for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
+    unsigned int first_record = shard_begin();
+    unsigned int end_record = shard_end();
+    if (first_record == end_record) {
+      write_profile(writer);
+      return true;
+    }
+    unsigned int first_set = first_record / num_realizations_;
+    unsigned int end_set =
+        (end_record + num_realizations_ - 1) / num_realizations_;
+
+    utilities::ThreadPool thread_pool(num_threads_);
+    unsigned int block_size =
+        std::min(thread_pool.size(), end_set - first_set);
+    // Workspaces holding components of motions for each set in block, reused
+    // across blocks
+    std::vector<std::vector<std::vector<double>>> motions_comp1(
+        block_size, std::vector<std::vector<double>>(num_realizations_));
+    std::vector<std::vector<std::vector<double>>> motions_comp2(
+        block_size, std::vector<std::vector<double>>(num_realizations_));
+
+    // Loop over simulations for different parameter sets for pulse-like
+    // motions followed by non-pulse-like motions
+    for (unsigned int block_start = first_set; block_start < end_set;
+         block_start += block_size) {
+      unsigned int num_block_sets =
+          std::min(block_size, end_set - block_start);
+
+      thread_pool.parallel_for(num_block_sets, [&](std::size_t i) {
+        simulate_parameter_set(block_start + i, motions_comp1[i],
+                               motions_comp2[i]);
+      });
+
+      // Write events for sets in block
+      for (unsigned int i = 0; i < num_block_sets; ++i) {
+        unsigned int k = block_start + i;
+
+        // Loop over number of realizations per parameter set realization
         for (unsigned int j = 0; j < num_realizations_; ++j) {
-          baseline_correct_time_history(nopulse_motions_comp1[i][j], gfactor,
-                                        fit_order);
-          baseline_correct_time_history(nopulse_motions_comp2[i][j], gfactor,
-                                        fit_order);
+          unsigned int record = k * num_realizations_ + j;
+          if (record < first_record || record >= end_record) {
+            continue;
+          }
+          auto event_data = event_metadata(record_name(event_name, k, j),
+                                           motions_comp1[i][j].size());
+
+          convert_time_history_units(motions_comp1[i][j], units);
+          convert_time_history_units(motions_comp2[i][j], units);
+          accels[0].swap(motions_comp1[i][j]);
+          accels[1].swap(motions_comp2[i][j]);
+          round_to_precision(accels);
+
+          writer.write_record(event_data, accels);
         }
       }
     }
+
+    write_profile(writer);
   } catch (const std::exception& e) {
     std::cerr << e.what();
     throw;
   }
 
-  // Create JsonObject for events
-  auto events = utilities::JsonObject();
-  std::vector<utilities::JsonObject> events_array(
-      num_realizations_ * (num_sims_pulse_ + num_sims_nopulse_));
-
-  // Add pattern information for JSON
-  auto pattern_x = utilities::JsonObject();
-  auto pattern_y = utilities::JsonObject();  
-  pattern_x.add_value("type", "UniformAcceleration");
-  pattern_x.add_value("timeSeries", "accel_x");
-  pattern_x.add_value("dof", 1);
-  pattern_y.add_value("type", "UniformAcceleration");
-  pattern_y.add_value("timeSeries", "accel_y");
-  pattern_y.add_value("dof", 2);
+  return true;
+}
 
-  // Create JSON for specific event
-  auto event_data = utilities::JsonObject();
-  // Loop over simulations for different parameter sets for pulse-like
-  // motions
-  for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-    // Loop over number of realizations per parameter set realization    
-    for (unsigned int j = 0; j < num_realizations_; ++j) {
-      event_data.add_value("name", event_name + "_ParameterSetPulse" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", pulse_motions_comp1[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary      
-      std::vector<double> x_accels(pulse_motions_comp1[i][j].size());
-      std::vector<double> y_accels(pulse_motions_comp2[i][j].size());
-      convert_time_history_units(pulse_motions_comp1[i][j], units);
-      convert_time_history_units(pulse_motions_comp2[i][j], units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", pulse_motions_comp1[i][j]);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", pulse_motions_comp2[i][j]);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_realizations_ + j] = event_data;
-      event_data.clear();
-    }
+bool stochastic::DabaghiDerKiureghian::generate_record(
+    const std::string& event_name, unsigned int index,
+    utilities::JsonObject& event, std::vector<std::vector<double>>& series,
+    bool units) {
+  if (index >= num_records()) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::DabaghiDerKiureghian::generate_record: "
+        "Record index out of range\n");
   }
-  
 
-  // Loop over different simulations for parameter sets non-pulse-like
-  // motions
-  for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-    // Loop over number of realizations per parameter set realization
-    for (unsigned int j = 0; j < num_realizations_; ++j) {
-      event_data.add_value("name", event_name + "_ParameterSetNoPulse" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j + num_sims_pulse_));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", nopulse_motions_comp1[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary
-      std::vector<double> x_accels(nopulse_motions_comp1[i][j].size());
-      std::vector<double> y_accels(nopulse_motions_comp2[i][j].size());
-      convert_time_history_units(nopulse_motions_comp1[i][j], units);
-      convert_time_history_units(nopulse_motions_comp2[i][j], units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", nopulse_motions_comp1[i][j]);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", nopulse_motions_comp2[i][j]);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_realizations_ + j +
-                   num_realizations_ * num_sims_pulse_] = event_data;
-      event_data.clear();
+  unsigned int set_index = index / num_realizations_;
+  unsigned int realization = index % num_realizations_;
+
+  try {
+    // Model parameters are shared with generate, so every record index
+    // refers to the same parameter set
+    simulate_suite_parameters();
+
+    // Truncation couples the realizations of a parameter set, so the full
+    // set is simulated and cached until a different set is requested
+    if (!record_set_cached_ || record_set_ != set_index) {
+      record_set_cached_ = false;
+      record_motions_comp1_.resize(num_realizations_);
+      record_motions_comp2_.resize(num_realizations_);
+      simulate_parameter_set(set_index, record_motions_comp1_,
+                             record_motions_comp2_);
+      record_set_ = set_index;
+      record_set_cached_ = true;
     }
-  }
 
-  events.add_value("Events", events_array);
+    series.resize(2);
+    series[0] = record_motions_comp1_[realization];
+    series[1] = record_motions_comp2_[realization];
+    convert_time_history_units(series[0], units);
+    convert_time_history_units(series[1], units);
+    round_to_precision(series);
+
+    event = event_metadata(record_name(event_name, set_index, realization),
+                           series[0].size());
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    throw;
+  }
 
-  return events;
+  return true;
 }
 
 bool stochastic::DabaghiDerKiureghian::generate(
@@ -526,8 +515,9 @@ bool stochastic::DabaghiDerKiureghian::generate(
   
   // Generate pool of acceleration time histories
   try{
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+    utilities::JsonRecordWriter writer(output_location);
+    generate(event_name, writer, units);
+    writer.close();
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -577,6 +567,7 @@ unsigned int stochastic::DabaghiDerKiureghian::simulate_pulse_type(
 
 Eigen::MatrixXd stochastic::DabaghiDerKiureghian::simulate_model_parameters(
     bool pulse_like, unsigned int num_sims) {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::simulate_model_parameters");
   // Calculate covariance matrix
   Eigen::MatrixXd error_cov =
       pulse_like
@@ -675,135 +666,139 @@ Eigen::VectorXd
 }
 
 void stochastic::DabaghiDerKiureghian::transform_parameters_from_normal_space(
-    bool pulse_like, Eigen::VectorXd& parameters) {
-  Eigen::VectorXd transformed_params(parameters.size());
-  auto standard_normal =
+    bool pulse_like, Eigen::VectorXd& parameters) const {
+  const auto& marginal_transforms =
+      pulse_like ? marginal_transforms_pulse_ : marginal_transforms_nopulse_;
+
+  // Each parameter depends only on its own normal variable, so parameters
+  // are transformed in place
+  for (auto const& transform : marginal_transforms) {
+    double& parameter = parameters(transform.index);
+
+    switch (transform.type) {
+      case MarginalTransform::Type::Lognormal:
+        parameter = std::exp(parameter);
+        break;
+
+      case MarginalTransform::Type::Beta:
+        parameter = transform.distribution->inv_cumulative_dist_func(
+                        standard_normal_->cumulative_dist_func(parameter)) *
+                        (transform.upper_bound - transform.lower_bound) +
+                    transform.lower_bound;
+        break;
+
+      case MarginalTransform::Type::LogBeta:
+        parameter = std::exp(
+            transform.distribution->inv_cumulative_dist_func(
+                standard_normal_->cumulative_dist_func(parameter)) *
+                (transform.upper_bound - transform.lower_bound) +
+            transform.lower_bound);
+        break;
+
+      case MarginalTransform::Type::Uniform:
+        parameter = standard_normal_->cumulative_dist_func(parameter) *
+                        (transform.upper_bound - transform.lower_bound) +
+                    transform.lower_bound;
+        break;
+
+      case MarginalTransform::Type::DoubleExponential:
+        parameter = inv_double_exp(
+            standard_normal_->cumulative_dist_func(parameter),
+            transform.param_a, transform.param_b, transform.param_c,
+            transform.lower_bound);
+        break;
+    }
+  }
+}
+
+void stochastic::DabaghiDerKiureghian::set_quantile_tolerance(
+    double tolerance) {
+  if (!(tolerance > 0.0)) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::DabaghiDerKiureghian::set_quantile_tolerance: "
+        "Tolerance must be positive\n");
+  }
+
+  quantile_tolerance_ = tolerance;
+  build_marginal_transforms();
+
+  // Parameters and cached records depend on marginal transforms
+  parameters_simulated_ = false;
+  record_set_cached_ = false;
+}
+
+void stochastic::DabaghiDerKiureghian::build_marginal_transforms() {
+  using Type = MarginalTransform::Type;
+
+  standard_normal_ =
       Factory<stochastic::Distribution, double, double>::instance()->create(
           "NormalDist", std::move(0.0), std::move(1.0));
 
-  if (pulse_like) {
-    std::vector<unsigned int> indices = {0, 1, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, 16};
-    for (auto const& index : indices) {
-      transformed_params(index) = std::exp(parameters(index));
-    }
+  // Pulse-like parameters: gamma is beta, nu is uniform, f' is
+  // double-exponential and depth_to_rupt is log-beta for residual and
+  // pulse-only motions, and remaining parameters are lognormal
+  marginal_transforms_pulse_.clear();
+  for (unsigned int index : {0, 1, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, 16}) {
+    marginal_transforms_pulse_.push_back(
+        make_marginal_transform(Type::Lognormal, index, index));
+  }
+  marginal_transforms_pulse_.push_back(
+      make_marginal_transform(Type::Beta, 2, 2));
+  marginal_transforms_pulse_.push_back(
+      make_marginal_transform(Type::Uniform, 3, 3));
+  marginal_transforms_pulse_.push_back(
+      make_marginal_transform(Type::DoubleExponential, 10, 10));
+  marginal_transforms_pulse_.push_back(
+      make_marginal_transform(Type::LogBeta, 11, 11));
+  marginal_transforms_pulse_.push_back(
+      make_marginal_transform(Type::DoubleExponential, 17, 17));
+  marginal_transforms_pulse_.push_back(
+      make_marginal_transform(Type::LogBeta, 18, 18));
+
+  // Non-pulse-like parameters: f' and depth_to_rupt of both components use
+  // the residual and pulse-only fits, and remaining parameters are lognormal
+  marginal_transforms_nopulse_.clear();
+  for (unsigned int index : {0, 1, 2, 3, 4, 7, 8, 9, 10, 11}) {
+    marginal_transforms_nopulse_.push_back(
+        make_marginal_transform(Type::Lognormal, index, index));
+  }
+  marginal_transforms_nopulse_.push_back(
+      make_marginal_transform(Type::DoubleExponential, 5, 10));
+  marginal_transforms_nopulse_.push_back(
+      make_marginal_transform(Type::LogBeta, 6, 11));
+  marginal_transforms_nopulse_.push_back(
+      make_marginal_transform(Type::DoubleExponential, 12, 17));
+  marginal_transforms_nopulse_.push_back(
+      make_marginal_transform(Type::LogBeta, 13, 18));
+}
 
-    // Calculate gamma
-    auto beta_dist =
+stochastic::DabaghiDerKiureghian::MarginalTransform
+    stochastic::DabaghiDerKiureghian::make_marginal_transform(
+        MarginalTransform::Type type, unsigned int index,
+        unsigned int fitted_index) const {
+  MarginalTransform transform;
+  transform.type = type;
+  transform.index = index;
+  transform.lower_bound = params_lower_bound_(fitted_index);
+  transform.upper_bound = params_upper_bound_(fitted_index);
+  transform.param_a = params_fitted1_(fitted_index);
+  transform.param_b = params_fitted2_(fitted_index);
+  transform.param_c = params_fitted3_(fitted_index);
+
+  if (type == MarginalTransform::Type::Beta ||
+      type == MarginalTransform::Type::LogBeta) {
+    double alpha = params_fitted1_(fitted_index),
+           beta = params_fitted2_(fitted_index);
+    auto distribution =
         Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(2)),
-            std::move(params_fitted2_(2)));
-
-    transformed_params(2) =
-        ((beta_dist->inv_cumulative_dist_func(
-              standard_normal->cumulative_dist_func(
-                  std::vector<double>{parameters(2)})))
-             .at(0)) *
-            (params_upper_bound_(2) - params_lower_bound_(2)) +
-        params_lower_bound_(2);
-
-    // Calculate nu
-    auto uniform_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "UniformDist", std::move(params_lower_bound_(3)),
-            std::move(params_upper_bound_(3)));
-
-    transformed_params(3) = (uniform_dist->inv_cumulative_dist_func(
-                                 standard_normal->cumulative_dist_func(
-                                     std::vector<double>{parameters(3)})))
-                                .at(0);
-
-    // Calculate f' residual
-    transformed_params(10) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(10)})[0],
-                       params_fitted1_(10), params_fitted2_(10),
-                       params_fitted3_(10), params_lower_bound_(10));
-
-    // Calculate depth_to_rupt residual
-    beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(11)),
-            std::move(params_fitted2_(11)));
-
-    transformed_params(11) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(11)})))
-                      .at(0)) *
-                     (params_upper_bound_(11) - params_lower_bound_(11)) +
-                 params_lower_bound_(11));
-
-    // Calculate f' pulse-only
-    transformed_params(17) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(17)})[0],
-                       params_fitted1_(17), params_fitted2_(17),
-                       params_fitted3_(17), params_lower_bound_(17));
-
-    // Calculate depth_to_rupt pulse-only
-    beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(18)),
-            std::move(params_fitted2_(18)));
-
-    transformed_params(18) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(18)})))
-                      .at(0)) *
-                     (params_upper_bound_(18) - params_lower_bound_(18)) +
-                 params_lower_bound_(18));
-  } else {
-    std::vector<unsigned int> indices = {0, 1, 2, 3, 4, 7, 8, 9, 10, 11};
-    for (auto const& index : indices) {
-      transformed_params(index) = std::exp(parameters(index));
+            "BetaDist", std::move(alpha), std::move(beta));
+    if (quantile_tolerance_ > 0.0) {
+      distribution->tabulate_inv_cumulative_dist_func(quantile_tolerance_);
     }
-
-    // Calculate f' component 1
-    transformed_params(5) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(5)})[0],
-                       params_fitted1_(10), params_fitted2_(10),
-                       params_fitted3_(10), params_lower_bound_(10));
-
-    // Calculate depth_to_rupture component 1
-    auto beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(11)),
-            std::move(params_fitted2_(11)));
-
-    transformed_params(6) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(6)})))
-                      .at(0)) *
-                     (params_upper_bound_(11) - params_lower_bound_(11)) +
-                 params_lower_bound_(11));
-
-    // Calculate f' component 2
-    transformed_params(12) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(12)})[0],
-                       params_fitted1_(17), params_fitted2_(17),
-                       params_fitted3_(17), params_lower_bound_(17));
-
-    // Calculate depth_to_rupture compenent 2
-    beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(18)),
-            std::move(params_fitted2_(18)));
-
-    transformed_params(13) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(13)})))
-                      .at(0)) *
-                     (params_upper_bound_(18) - params_lower_bound_(18)) +
-                 params_lower_bound_(18));
+    transform.distribution = distribution;
   }
 
-  // Set input vector of parameters to transformed parameters
-  parameters = transformed_params;
+  return transform;
 }
 
 double stochastic::DabaghiDerKiureghian::inv_double_exp(
@@ -830,10 +825,12 @@ double stochastic::DabaghiDerKiureghian::inv_double_exp(
 }
 
 void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
-    bool pulse_like, const Eigen::VectorXd& parameters,
+    bool pulse_like, const Eigen::VectorXd& parameters, unsigned int set_index,
     std::vector<std::vector<double>>& accel_comp_1,
     std::vector<std::vector<double>>& accel_comp_2,
     unsigned int num_gms) const {
+  SMELT_PROFILE_SCOPE(
+      "DabaghiDerKiureghian::simulate_near_fault_ground_motion");
 
   // Extract parameters for two components of ground motion
   Eigen::VectorXd alpha_1(7);
@@ -846,11 +843,13 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
     alpha_2 = parameters.segment(7, 7);
   }
 
-  // Set modulating and filter parameters
+  // Set modulating and filter parameters. Components have similar duration
+  // parameters, so the first component warm starts the second.
   Eigen::VectorXd modulating_params_1 =
       backcalculate_modulating_params(alpha_1.segment(0, 4), start_time_);
-  Eigen::VectorXd modulating_params_2 =
-      backcalculate_modulating_params(alpha_2.segment(0, 4), start_time_);
+  Eigen::VectorXd modulating_params_2 = backcalculate_modulating_params(
+      alpha_2.segment(0, 4), start_time_,
+      ModulatingFitMode::LevenbergMarquardt, modulating_params_1.head(3));
 
   Eigen::VectorXd filter_params_1 = alpha_1.segment(4, 3);
   Eigen::VectorXd filter_params_2 = alpha_2.segment(4, 3);
@@ -866,11 +865,16 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
 
   num_steps = num_steps % 2 == 1 ? num_steps + 1 : num_steps;
 
-  // Generated modulated filtered white noise
+  // Generated modulated filtered white noise, using a random stream specific
+  // to the parameter set and component
+  auto random_stream_1 = parameter_set_stream(set_index, 0);
+  auto random_stream_2 = parameter_set_stream(set_index, 1);
   auto white_noise_1 = simulate_white_noise(
-      modulating_params_1, filter_params_1, num_steps, num_gms);
+      modulating_params_1, filter_params_1, num_steps, random_stream_1,
+      num_gms);
   auto white_noise_2 = simulate_white_noise(
-      modulating_params_2, filter_params_2, num_steps, num_gms);
+      modulating_params_2, filter_params_2, num_steps, random_stream_2,
+      num_gms);
 
   // Calculate high-pass filter and padding
   double freq_corner = std::pow(10.0, 1.4071 - 0.3452 * moment_magnitude_);
@@ -902,12 +906,10 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
   }
 
   // Apply filter to padded acceleration time histories
-  accel_comp_1.resize(num_gms);
-  accel_comp_2.resize(num_gms);
-  for (unsigned int i = 0; i < num_gms; ++i) {
-    accel_comp_1[i] = filter_acceleration(accel_padded_1.row(i), freq_corner, filter_order);
-    accel_comp_2[i] = filter_acceleration(accel_padded_2.row(i), freq_corner, filter_order);    
-  }
+  accel_comp_1 =
+      filter_acceleration_batch(accel_padded_1, freq_corner, filter_order);
+  accel_comp_2 =
+      filter_acceleration_batch(accel_padded_2, freq_corner, filter_order);
 
   // Rescale time histories for energy consistency:
   // Target Arias intensity for rescaling after high-pass filter in g-sec
@@ -977,34 +979,89 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
 
 Eigen::VectorXd
     stochastic::DabaghiDerKiureghian::backcalculate_modulating_params(
-        const Eigen::VectorXd& q_params, double t0) const {
+        const Eigen::VectorXd& q_params, double t0, ModulatingFitMode mode,
+        const Eigen::VectorXd& initial_guess) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::backcalculate_modulating_params");
+
+  // Only Levenberg-Marquardt is warm started from the initial guess. Fits
+  // that can't match all targets depend on the starting point, so the guess
+  // is part of the cache key.
+  bool warm_start = mode == ModulatingFitMode::LevenbergMarquardt &&
+                    initial_guess.size() == 3;
+  Eigen::VectorXd cache_guess =
+      warm_start ? initial_guess : Eigen::VectorXd();
+
+  // Skip fit if parameters have already been back-calculated
+  Eigen::VectorXd parameters(4);
+  if (modulating_params_cache_ &&
+      modulating_params_cache_->find(q_params, t0, static_cast<int>(mode),
+                                     cache_guess, parameters)) {
+    return parameters;
+  }
+
   double arias_intensity = q_params(0) / 981,  // Convert from cm/s to g-s
     d595 = q_params(1), d05 = q_params(2),
     d030 = q_params(3), d095 = d05 + d595,
     t30 = t0 + d030;
 
   // Search for local minimum by trying several starting points
-  optimization::NelderMead minimizer(1e-10);
-  std::vector<double> diffs(6);
-  std::function<double(const std::vector<double>&)> error_function =
-      std::bind(&stochastic::DabaghiDerKiureghian::calc_parameter_error, this,
-                std::placeholders::_1, d05, d030, d095, t0);
-
-  // Iterate over starting points
   std::vector<std::vector<double>> starting_points = {
       {1.0, 0.2, t30}, {2.0, 0.2, t30}, {5.0, 0.2, t30},
       {1.0, 1.0, t30}, {2.0, 1.0, t30}, {5.0, 1.0, t30}};
-  std::vector<double> deltas(starting_points[0].size());
 
-  unsigned int point_counter = 0;
-  for (auto& point : starting_points) {
-    for (unsigned int i = 0; i < deltas.size(); ++i) {
-      deltas[i] = std::abs(point[i]) < 1.0e-6 ? 0.00025 : 0.05 * std::abs(point[i]);
-    }
+  // Try initial guess first since it is usually close to the solution
+  if (warm_start) {
+    starting_points.insert(
+        starting_points.begin(),
+        std::vector<double>{initial_guess(0), initial_guess(1),
+                            initial_guess(2)});
+  }
+  std::vector<double> diffs(starting_points.size(),
+                            std::numeric_limits<double>::infinity());
+
+  if (mode == ModulatingFitMode::NelderMead) {
+    optimization::NelderMead minimizer(1e-10);
+    std::function<double(const std::vector<double>&)> error_function =
+        std::bind(&stochastic::DabaghiDerKiureghian::calc_parameter_error,
+                  this, std::placeholders::_1, d05, d030, d095, t0);
+    std::vector<double> deltas(starting_points[0].size());
+
+    // Iterate over starting points
+    for (unsigned int i = 0; i < starting_points.size(); ++i) {
+      auto& point = starting_points[i];
+      for (unsigned int j = 0; j < deltas.size(); ++j) {
+        deltas[j] =
+            std::abs(point[j]) < 1.0e-6 ? 0.00025 : 0.05 * std::abs(point[j]);
+      }
 
-    point = minimizer.minimize(point, deltas, error_function);
-    diffs[point_counter] = error_function(point);
-    ++point_counter;
+      point = minimizer.minimize(point, deltas, error_function);
+      diffs[i] = error_function(point);
+    }
+  } else {
+    // Solutions matching all three target durations are unique, so remaining
+    // starting points are skipped once the error measure vanishes
+    double converged_error = 1.0e-12;
+    optimization::LevenbergMarquardt solver(1e-10);
+    optimization::LevenbergMarquardt::ResidualFunction residual_function =
+        [this, d05, d030, d095, t0](const Eigen::VectorXd& point,
+                                    Eigen::VectorXd& residuals,
+                                    Eigen::MatrixXd& jacobian) -> bool {
+      return calc_parameter_residuals(point, d05, d030, d095, t0, residuals,
+                                      jacobian);
+    };
+
+    Eigen::VectorXd point(3);
+    for (unsigned int i = 0; i < starting_points.size(); ++i) {
+      point << starting_points[i][0], starting_points[i][1],
+          starting_points[i][2];
+      point = solver.minimize(point, residual_function);
+      starting_points[i] = {point(0), point(1), point(2)};
+      diffs[i] = solver.get_minimum();
+
+      if (point(0) >= 0.0 && diffs[i] < converged_error) {
+        break;
+      }
+    }
   }
 
   // To avoid negative values of alpha, multiply cost value by 10000 if so
@@ -1018,7 +1075,6 @@ Eigen::VectorXd
   auto min_index = std::distance(
       std::begin(diffs), std::min_element(std::begin(diffs), std::end(diffs)));
 
-  Eigen::VectorXd parameters(4);
   parameters << starting_points[min_index][0], starting_points[min_index][1],
       starting_points[min_index][2], std::numeric_limits<double>::infinity();
 
@@ -1027,12 +1083,19 @@ Eigen::VectorXd
       ((M_PI / 2.0) * ((parameters[2] - t0) / (2.0 * parameters[0] + 1.0) +
                        1.0 / (2.0 * parameters[1]))));
 
+  if (modulating_params_cache_) {
+    modulating_params_cache_->insert(q_params, t0, static_cast<int>(mode),
+                                     cache_guess, parameters);
+  }
+
   return parameters;
 }
 
 double stochastic::DabaghiDerKiureghian::calc_parameter_error(
     const std::vector<double>& parameters, double d05_target,
     double d030_target, double d095_target, double t0) const {
+  SMELT_PROFILE_COUNT("DabaghiDerKiureghian::calc_parameter_error", 1);
+
   // Modulating function parameters
   double alpha = parameters[0], beta = parameters[1], t_max_q = parameters[2];
 
@@ -1091,10 +1154,65 @@ double stochastic::DabaghiDerKiureghian::calc_parameter_error(
          std::pow(d095_target - d095_fit, 2);
 }
 
+bool stochastic::DabaghiDerKiureghian::calc_parameter_residuals(
+    const Eigen::VectorXd& parameters, double d05_target, double d030_target,
+    double d095_target, double t0, Eigen::VectorXd& residuals,
+    Eigen::MatrixXd& jacobian) const {
+  SMELT_PROFILE_COUNT("DabaghiDerKiureghian::calc_parameter_residuals", 1);
+
+  // Modulating function parameters
+  double alpha = parameters(0), beta = parameters(1),
+         duration = parameters(2) - t0;
+
+  if (!(duration > 0.0 && beta > 0.0 && 2.0 * alpha + 1.0 > 0.0)) {
+    return false;
+  }
+
+  double exponent = 2.0 * alpha + 1.0;
+  double total = duration + exponent / (2.0 * beta);
+  std::vector<double> percentages = {0.05, 0.30, 0.95};
+  std::vector<double> targets = {d05_target, d030_target, d095_target};
+
+  residuals.resize(3);
+  jacobian.resize(3, 3);
+
+  for (unsigned int i = 0; i < percentages.size(); ++i) {
+    // Time to percentage of Arias intensity in build-up phase of modulating
+    // function, d = (p * duration^(2 alpha) * total)^(1 / (2 alpha + 1))
+    double log_fit = (std::log(percentages[i]) +
+                      2.0 * alpha * std::log(duration) + std::log(total)) /
+                     exponent;
+    double fit = std::exp(log_fit);
+
+    if (fit <= duration) {
+      residuals(i) = fit - targets[i];
+      jacobian(i, 0) =
+          fit * (2.0 * std::log(duration) + 1.0 / (beta * total) -
+                 2.0 * log_fit) /
+          exponent;
+      jacobian(i, 1) = -fit / (2.0 * beta * beta * total);
+      jacobian(i, 2) = fit * (2.0 * alpha / duration + 1.0 / total) / exponent;
+    } else {
+      // Time falls in exponential decay phase after t_max_q
+      double growth = 2.0 * beta * duration / exponent + 1.0;
+      double log_remaining = std::log((1.0 - percentages[i]) * growth);
+      residuals(i) = duration - log_remaining / (2.0 * beta) - targets[i];
+      jacobian(i, 0) = 2.0 * duration / (exponent * exponent * growth);
+      jacobian(i, 1) = log_remaining / (2.0 * beta * beta) -
+                       duration / (beta * exponent * growth);
+      jacobian(i, 2) = 1.0 - 1.0 / (exponent * growth);
+    }
+  }
+
+  return true;
+}
+
 Eigen::MatrixXd stochastic::DabaghiDerKiureghian::simulate_white_noise(
     const Eigen::VectorXd& modulating_params,
     const Eigen::VectorXd& filter_params, unsigned int num_steps,
-    unsigned int num_gms) const {
+    numeric_utils::RandomStream& random_stream, unsigned int num_gms,
+    ImpulseResponseMode mode) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::simulate_white_noise");
   // CALCULATE MODULATING FUNCTION:
   auto modulating_func =
       calc_modulating_func(num_steps, start_time_, modulating_params);
@@ -1113,16 +1231,10 @@ Eigen::MatrixXd stochastic::DabaghiDerKiureghian::simulate_white_noise(
       calc_linear_filter(num_steps, filter_params, t01, tmid, t99);
 
   // Generate white noise
-  auto generator =
-      seed_value_ != std::numeric_limits<int>::infinity()
-          ? boost::random::mt19937(static_cast<unsigned int>(seed_value_))
-          : boost::random::mt19937(
-                static_cast<unsigned int>(std::time(nullptr)));
-  
   boost::random::normal_distribution<> distribution(0.0, 1.0);
-  boost::random::variate_generator<boost::random::mt19937&,
+  boost::random::variate_generator<numeric_utils::RandomStream&,
                                    boost::random::normal_distribution<>>
-      noise_gen(generator, distribution);
+      noise_gen(random_stream, distribution);
 
   Eigen::MatrixXd white_noise(num_gms, num_steps);
   for (unsigned int i = 0; i < num_gms; ++i) {
@@ -1131,11 +1243,9 @@ Eigen::MatrixXd stochastic::DabaghiDerKiureghian::simulate_white_noise(
     }
   }
 
-  // Calculate impulse response
-  Eigen::MatrixXd impulse_response = calc_impulse_response_filter(
-      num_steps, frequency_filter, filter_params(2));
-
-  auto freq_func = white_noise * impulse_response;
+  // Apply impulse response filter
+  Eigen::MatrixXd freq_func = filter_white_noise(
+      white_noise, frequency_filter, filter_params(2), mode);
 
   Eigen::MatrixXd filtered_white_noise(num_gms, num_steps);
   // Convert modulating function to Eigen::VectorXd
@@ -1237,6 +1347,7 @@ std::vector<double> stochastic::DabaghiDerKiureghian::calc_linear_filter(
 Eigen::MatrixXd stochastic::DabaghiDerKiureghian::calc_impulse_response_filter(
     unsigned int num_steps, const std::vector<double>& input_filter,
     double zeta) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::calc_impulse_response_filter");
   Eigen::MatrixXd impulse_response =
       Eigen::MatrixXd::Zero(num_steps, num_steps);
 
@@ -1270,36 +1381,163 @@ Eigen::MatrixXd stochastic::DabaghiDerKiureghian::calc_impulse_response_filter(
   return impulse_response;
 }
 
+namespace {
+/**
+ * Accumulate truncated time-varying impulse responses excited by white noise
+ * @tparam Tscalar Type used to accumulate filtered white noise
+ * @param[in] white_noise Matrix where each row is a white noise time history
+ * @param[in] input_filter Input filter coefficients to use in impulse
+ *                         response
+ * @param[in] zeta Filter parameter
+ * @param[in] time_step Temporal discretization
+ * @param[in] tolerance Envelope value relative to peak below which impulse
+ *                      responses are truncated
+ * @param[out] denominator Vector to store sum of squared impulse responses to
+ * @param[out] filtered_noise Matrix to store unnormalized filtered white noise
+ *                            to
+ */
+template <typename Tscalar>
+void accumulate_impulse_responses(
+    const Eigen::MatrixXd& white_noise, const std::vector<double>& input_filter,
+    double zeta, double time_step, double tolerance,
+    Eigen::VectorXd& denominator,
+    Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>& filtered_noise) {
+  using RowVectorX = Eigen::Matrix<Tscalar, 1, Eigen::Dynamic>;
+  unsigned int num_steps = white_noise.cols();
+
+  Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic> noise =
+      white_noise.cast<Tscalar>();
+  filtered_noise.setZero(white_noise.rows(), num_steps);
+  denominator = Eigen::VectorXd::Zero(num_steps);
+  Eigen::RowVectorXd impulse(num_steps);
+  RowVectorX scalar_impulse(num_steps);
+  double damping = std::sqrt(1.0 - zeta * zeta);
+  double log_tolerance = -std::log(tolerance);
+
+  for (unsigned int i = 0; i < num_steps; ++i) {
+    double omega = input_filter[i];
+    double decay = zeta * omega * time_step;
+
+    // Number of steps before envelope of impulse response decays below
+    // tolerance
+    unsigned int length = num_steps - i;
+    if (decay > 0.0 && log_tolerance / decay + 2.0 < length) {
+      length = static_cast<unsigned int>(std::ceil(log_tolerance / decay)) + 2;
+    }
+
+    // Damped sinusoid h(t) = omega / sqrt(1 - zeta^2) * exp(-zeta * omega * t)
+    // * sin(omega * sqrt(1 - zeta^2) * t) satisfies the second-order
+    // recursion h[j] = 2 r cos(theta) h[j-1] - r^2 h[j-2]. The recursion is
+    // always evaluated in double precision since its errors compound.
+    double ratio = std::exp(-decay);
+    double theta = omega * damping * time_step;
+    double coeff_1 = 2.0 * ratio * std::cos(theta);
+    double coeff_2 = ratio * ratio;
+
+    impulse(0) = 0.0;
+    if (length > 1) {
+      impulse(1) = (omega / damping) * ratio * std::sin(theta);
+    }
+    for (unsigned int j = 2; j < length; ++j) {
+      impulse(j) = coeff_1 * impulse(j - 1) - coeff_2 * impulse(j - 2);
+    }
+
+    // Accumulate squared impulse response for normalization and contribution
+    // of white noise at current step to subsequent steps
+    denominator.segment(i, length) +=
+        impulse.head(length).transpose().array().square().matrix();
+    scalar_impulse.head(length) = impulse.head(length).cast<Tscalar>();
+    filtered_noise.middleCols(i, length).noalias() +=
+        noise.col(i) * scalar_impulse.head(length);
+  }
+}
+}  // namespace
+
+Eigen::MatrixXd stochastic::DabaghiDerKiureghian::filter_white_noise(
+    const Eigen::MatrixXd& white_noise, const std::vector<double>& input_filter,
+    double zeta, ImpulseResponseMode mode, double tolerance) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::filter_white_noise");
+
+  unsigned int num_steps = white_noise.cols();
+
+  if (mode == ImpulseResponseMode::Dense) {
+    return white_noise *
+           calc_impulse_response_filter(num_steps, input_filter, zeta);
+  }
+
+  Eigen::MatrixXd filtered_noise;
+  Eigen::VectorXd denominator;
+
+  if (precision_ == utilities::RecordPrecision::Single) {
+    Eigen::MatrixXf single_noise;
+    accumulate_impulse_responses(white_noise, input_filter, zeta, time_step_,
+                                 tolerance, denominator, single_noise);
+    filtered_noise = single_noise.cast<double>();
+  } else {
+    accumulate_impulse_responses(white_noise, input_filter, zeta, time_step_,
+                                 tolerance, denominator, filtered_noise);
+  }
+
+  denominator = denominator.array().sqrt();
+  denominator(0) = 0.1;
+
+  for (unsigned int i = 0; i < filtered_noise.rows(); ++i) {
+    filtered_noise.row(i) =
+        filtered_noise.row(i).cwiseQuotient(denominator.transpose());
+  }
+
+  return filtered_noise;
+}
+
 std::vector<double> stochastic::DabaghiDerKiureghian::filter_acceleration(
     const Eigen::VectorXd& accel_history, double freq_corner,
     unsigned int filter_order) const {
+  return filter_acceleration_batch(accel_history.transpose(), freq_corner,
+                                   filter_order)[0];
+}
 
-  // Calculate normalized cutoff frequency
-  std::vector<std::complex<double>> accel_fft(accel_history.size());
-
-  // Compute FFT of acceleration history
-  numeric_utils::fft(accel_history, accel_fft);
+std::vector<std::vector<double>>
+    stochastic::DabaghiDerKiureghian::filter_acceleration_batch(
+        const Eigen::MatrixXd& accel_histories, double freq_corner,
+        unsigned int filter_order) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::filter_acceleration_batch");
+
+  // Compute non-redundant half of FFT of all acceleration histories. Padded
+  // lengths depend on the parameters of each realization, so batch shapes
+  // rarely repeat and plans are not kept in the plan cache.
+  Eigen::MatrixXcd accel_fft;
+  numeric_utils::real_fft_batch(accel_histories, accel_fft, true, false);
+
+  // Get filter coefficients, shared between records with the same length
+  auto filter_mask =
+      signal_processing::FilterCache::instance()->acausal_highpass_filter(
+          filter_order, freq_corner, time_step_, accel_histories.cols());
+  const std::vector<double>& filter = *filter_mask;
+
+  // Filter accelerations in frequency domain. Filter is symmetric, so only
+  // the first N/2+1 coefficients are needed.
+  for (unsigned int i = 0; i < accel_fft.cols(); ++i) {
+    accel_fft.col(i) *= filter[i];
+  }
 
-  // Get filter coefficients
-  auto filter = Dispatcher<std::vector<double>, double, double, unsigned int,
-                           unsigned int>::instance()
-                    ->dispatch("AcausalHighpassButterworth", freq_corner,
-                               time_step_, filter_order, accel_fft.size());
+  // Compute inverse FFT of filtered transformed accelerations
+  Eigen::MatrixXd filtered_accels;
+  numeric_utils::inverse_real_fft_batch(accel_fft, filtered_accels,
+                                        accel_histories.cols(), true, false);
 
-  // Filter acceleration in frequency domain
-  for (unsigned int i = 0; i < accel_fft.size(); ++i) {
-    accel_fft[i] = accel_fft[i] * filter[i];
+  std::vector<std::vector<double>> filtered_acc(
+      filtered_accels.rows(), std::vector<double>(filtered_accels.cols()));
+  for (unsigned int i = 0; i < filtered_accels.rows(); ++i) {
+    Eigen::VectorXd::Map(filtered_acc[i].data(), filtered_accels.cols()) =
+        filtered_accels.row(i);
   }
 
-  // Compute inverse FFT of filtered transformed acceleration
-  std::vector<double> filtered_acc(accel_fft.size());
-  numeric_utils::inverse_fft(accel_fft, filtered_acc);
-
   return filtered_acc;
 }
 
 std::vector<double> stochastic::DabaghiDerKiureghian::calc_pulse_acceleration(
     unsigned int num_steps, const Eigen::VectorXd& parameters) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::calc_pulse_acceleration");
   double pulse_velocity = parameters(0);  
   double pulse_frequency = 1.0 / parameters(1);
   double oscillation_param = parameters(2);  
@@ -1341,6 +1579,7 @@ void stochastic::DabaghiDerKiureghian::truncate_time_histories(
     std::vector<std::vector<double>>& accel_comp_1,
     std::vector<std::vector<double>>& accel_comp_2, double gfactor,
     double amplitude_lim, double pgd_lim) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::truncate_time_histories");
 
   // Iterate over time histories
   for (unsigned int i = 0; i < accel_comp_1.size(); ++i) {
@@ -1457,6 +1696,7 @@ void stochastic::DabaghiDerKiureghian::truncate_time_histories(
 void stochastic::DabaghiDerKiureghian::baseline_correct_time_history(
     std::vector<double>& time_history, double gfactor,
     unsigned int order) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::baseline_correct_time_history");
 
   // Calculate velocity and displacment time histories
   std::vector<double> vel_series(time_history.size());
@@ -1490,8 +1730,9 @@ void stochastic::DabaghiDerKiureghian::baseline_correct_time_history(
   auto velocity_poly = numeric_utils::polynomial_derivative(displacement_poly);
   auto accel_poly = numeric_utils::polynomial_derivative(velocity_poly);
 
-  // Calculate acceleration correction based on polynomial
-  auto accel_correction =
+  // Calculate acceleration correction based on polynomial. Evaluated into a
+  // vector since the quotient expression would reference a temporary
+  Eigen::VectorXd accel_correction =
       numeric_utils::evaluate_polynomial(accel_poly, times) / gfactor;
 
   // Correct time series based on acceleration correction
@@ -1508,3 +1749,101 @@ void stochastic::DabaghiDerKiureghian::convert_time_history_units(
     val = val * conversion_factor;
   }
 }
+
+void stochastic::DabaghiDerKiureghian::simulate_parameter_set(
+    unsigned int set_index, std::vector<std::vector<double>>& accel_comp_1,
+    std::vector<std::vector<double>>& accel_comp_2) const {
+  double gfactor = 981;
+  unsigned int fit_order = 5;
+
+  bool pulse_like = set_index < num_sims_pulse_;
+  unsigned int i = pulse_like ? set_index : set_index - num_sims_pulse_;
+
+  simulate_near_fault_ground_motion(
+      pulse_like,
+      pulse_like ? parameters_pulse_.row(i) : parameters_nopulse_.row(i),
+      set_index, accel_comp_1, accel_comp_2, num_realizations_);
+
+  // If requested, truncate and baseline correct time histories
+  if (truncate_) {
+    truncate_time_histories(accel_comp_1, accel_comp_2, gfactor);
+
+    for (unsigned int j = 0; j < num_realizations_; ++j) {
+      baseline_correct_time_history(accel_comp_1[j], gfactor, fit_order);
+      baseline_correct_time_history(accel_comp_2[j], gfactor, fit_order);
+    }
+  }
+}
+
+void stochastic::DabaghiDerKiureghian::simulate_suite_parameters() {
+  if (parameters_simulated_) {
+    return;
+  }
+
+  // Restart seeded sample generator so that parameters do not depend on
+  // draws made before, such as by earlier calls to generate
+  if (seed_value_ != std::numeric_limits<int>::infinity()) {
+    sample_generator_ =
+        Factory<numeric_utils::RandomGenerator, int>::instance()->create(
+            "MultivariateNormal", std::move(seed_value_));
+  }
+
+  parameters_pulse_ = simulate_model_parameters(true, num_sims_pulse_);
+  parameters_nopulse_ = simulate_model_parameters(false, num_sims_nopulse_);
+  parameters_simulated_ = true;
+}
+
+numeric_utils::RandomStream
+    stochastic::DabaghiDerKiureghian::parameter_set_stream(
+        unsigned int set_index, unsigned int component) const {
+  return numeric_utils::RandomStream(stream_seed_,
+                                     numeric_utils::stream_id(model_name_),
+                                     set_index, component);
+}
+
+std::string stochastic::DabaghiDerKiureghian::record_name(
+    const std::string& event_name, unsigned int set_index,
+    unsigned int realization) const {
+  return set_index < num_sims_pulse_
+             ? event_name + "_ParameterSetPulse" + std::to_string(set_index) +
+                   "_Sim" + std::to_string(realization)
+             : event_name + "_ParameterSetNoPulse" +
+                   std::to_string(set_index - num_sims_pulse_) + "_Sim" +
+                   std::to_string(realization + num_sims_pulse_);
+}
+
+utilities::JsonObject stochastic::DabaghiDerKiureghian::event_metadata(
+    const std::string& name, std::size_t num_steps) const {
+  SMELT_PROFILE_SCOPE("DabaghiDerKiureghian::event_metadata");
+  // Add pattern information for JSON
+  auto pattern_x = utilities::JsonObject();
+  auto pattern_y = utilities::JsonObject();  
+  pattern_x.add_value("type", "UniformAcceleration");
+  pattern_x.add_value("timeSeries", "accel_x");
+  pattern_x.add_value("dof", 1);
+  pattern_y.add_value("type", "UniformAcceleration");
+  pattern_y.add_value("timeSeries", "accel_y");
+  pattern_y.add_value("dof", 2);
+
+  // Time series descriptions for x and y directions
+  auto time_history_x = utilities::JsonObject();
+  auto time_history_y = utilities::JsonObject();
+  time_history_x.add_value("name", "accel_x");
+  time_history_x.add_value("type", "Value");
+  time_history_x.add_value("dT", time_step_);
+  time_history_y.add_value("name", "accel_y");
+  time_history_y.add_value("type", "Value");
+  time_history_y.add_value("dT", time_step_);
+
+  auto event_data = utilities::JsonObject();
+  event_data.add_value("name", name);
+  event_data.add_value("type", "Seismic");
+  event_data.add_value("dT", time_step_);
+  event_data.add_value("numSteps", num_steps);
+  event_data.add_value(
+      "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
+  event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
+                                         time_history_x, time_history_y});
+
+  return event_data;
+}
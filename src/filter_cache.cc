@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "filter.h"
+#include "filter_cache.h"
+
+signal_processing::FilterCache* signal_processing::FilterCache::instance() {
+  static FilterCache cache;
+  return &cache;
+}
+
+signal_processing::FilterCache::FilterCache(std::size_t capacity)
+    : capacity_{capacity} {}
+
+template <typename Tdesign, typename Tcompute>
+std::shared_ptr<const Tdesign>
+    signal_processing::FilterCache::find_or_compute(
+        std::map<Key, std::shared_ptr<const Tdesign>>& table, const Key& key,
+        Tcompute compute) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto design = table.find(key);
+    if (design != table.end()) {
+      return design->second;
+    }
+  }
+
+  // Compute design outside of lock so that misses on other keys, and nested
+  // lookups of coefficients, are not blocked
+  std::shared_ptr<const Tdesign> design =
+      std::make_shared<const Tdesign>(compute());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (table.size() >= capacity_ && table.find(key) == table.end()) {
+    table.clear();
+  }
+  return table.emplace(key, std::move(design)).first->second;
+}
+
+std::shared_ptr<const std::vector<std::vector<double>>>
+    signal_processing::FilterCache::highpass_butterworth(int filter_order,
+                                                         double cutoff_freq,
+                                                         double time_step) {
+  return find_or_compute(
+      butterworth_, Key(filter_order, cutoff_freq, time_step, 0),
+      [filter_order, cutoff_freq, time_step]() {
+        // Normalize cutoff frequency by the Nyquist frequency
+        return hp_butterworth()(filter_order,
+                                cutoff_freq / (1.0 / time_step / 2.0));
+      });
+}
+
+std::shared_ptr<const std::vector<double>>
+    signal_processing::FilterCache::highpass_impulse_response(
+        int filter_order, double cutoff_freq, double time_step,
+        int num_samples) {
+  return find_or_compute(
+      impulse_responses_,
+      Key(filter_order, cutoff_freq, time_step,
+          static_cast<std::size_t>(num_samples)),
+      [this, filter_order, cutoff_freq, time_step, num_samples]() {
+        auto coefficients =
+            highpass_butterworth(filter_order, cutoff_freq, time_step);
+        return impulse_response()((*coefficients)[0], (*coefficients)[1],
+                                  filter_order, num_samples);
+      });
+}
+
+std::shared_ptr<const std::vector<double>>
+    signal_processing::FilterCache::acausal_highpass_filter(
+        unsigned int filter_order, double freq_corner, double time_step,
+        unsigned int num_samples) {
+  return find_or_compute(
+      acausal_filters_,
+      Key(static_cast<int>(filter_order), freq_corner, time_step, num_samples),
+      [filter_order, freq_corner, time_step, num_samples]() {
+        return signal_processing::acausal_highpass_filter()(
+            freq_corner, time_step, filter_order, num_samples);
+      });
+}
+
+std::size_t signal_processing::FilterCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return butterworth_.size() + impulse_responses_.size() +
+         acausal_filters_.size();
+}
+
+void signal_processing::FilterCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  butterworth_.clear();
+  impulse_responses_.clear();
+  acausal_filters_.clear();
+}
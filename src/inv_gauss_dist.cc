@@ -1,6 +1,8 @@
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/inverse_gaussian.hpp>
 #include "inv_gauss_dist.h"
+#include "quantile_table.h"
 
 stochastic::InverseGaussianDistribution::InverseGaussianDistribution(
     double mean, double std_dev)
@@ -26,10 +28,42 @@ std::vector<double>
     stochastic::InverseGaussianDistribution::inv_cumulative_dist_func(
         const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
+
+double stochastic::InverseGaussianDistribution::cumulative_dist_func(
+    double location) const {
+  return cdf(distribution_, location);
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
+double stochastic::InverseGaussianDistribution::inv_cumulative_dist_func(
+    double probability) const {
+  if (quantile_table_) {
+    return quantile_table_->evaluate(probability);
+  }
+  return quantile(distribution_, probability);
+}
+
+void stochastic::InverseGaussianDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations, std::size_t size) const {
+  if (quantile_table_) {
+    quantile_table_->evaluate(probabilities, evaluations, size);
+    return;
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
     evaluations[i] = quantile(distribution_, probabilities[i]);
   }
+}
 
-  return evaluations;
+bool stochastic::InverseGaussianDistribution::tabulate_inv_cumulative_dist_func(
+    double tolerance) {
+  quantile_table_.reset(new QuantileTable(
+      [this](double probability) {
+        return quantile(distribution_, probability);
+      },
+      tolerance));
+  return true;
 }
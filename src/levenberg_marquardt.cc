@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <Eigen/Dense>
+#include "levenberg_marquardt.h"
+
+Eigen::VectorXd optimization::LevenbergMarquardt::minimize(
+    const Eigen::VectorXd& initial_point,
+    const ResidualFunction& residual_function) {
+  num_iters_ = 0;
+  func_min_ = std::numeric_limits<double>::infinity();
+
+  Eigen::VectorXd point = initial_point;
+  Eigen::VectorXd residuals;
+  Eigen::MatrixXd jacobian;
+
+  if (!residual_function(point, residuals, jacobian) ||
+      !residuals.allFinite() || !jacobian.allFinite()) {
+    return point;
+  }
+  func_min_ = residuals.squaredNorm();
+
+  Eigen::VectorXd trial_point(point.size());
+  Eigen::VectorXd trial_residuals;
+  Eigen::MatrixXd trial_jacobian;
+
+  // Approximate Hessian and gradient of half the sum of squared residuals
+  Eigen::MatrixXd hessian = jacobian.transpose() * jacobian;
+  Eigen::VectorXd gradient = jacobian.transpose() * residuals;
+  double damping = INITIAL_DAMPING_;
+
+  while (num_iters_ < max_iters_ && func_min_ > 0.0) {
+    ++num_iters_;
+
+    // Solve damped normal equations for step, scaling damping by the
+    // diagonal so that the step is invariant to scaling of parameters
+    Eigen::MatrixXd damped_hessian = hessian;
+    for (unsigned int i = 0; i < point.size(); ++i) {
+      damped_hessian(i, i) +=
+          damping * std::max(hessian(i, i), std::numeric_limits<double>::min());
+    }
+    Eigen::VectorXd step = -damped_hessian.ldlt().solve(gradient);
+
+    // Limit step relative to magnitude of point, since steps along directions
+    // where the objective is flat are otherwise unbounded
+    double step_ratio = 0.0;
+    for (unsigned int i = 0; i < point.size(); ++i) {
+      step_ratio = std::max(step_ratio, std::abs(step(i)) /
+                                            std::max(std::abs(point(i)), 1.0));
+    }
+    if (step_ratio > MAX_STEP_RATIO_) {
+      step *= MAX_STEP_RATIO_ / step_ratio;
+    }
+    trial_point = point + step;
+
+    double trial_value = std::numeric_limits<double>::infinity();
+    if (step.allFinite() &&
+        residual_function(trial_point, trial_residuals, trial_jacobian) &&
+        trial_residuals.allFinite() && trial_jacobian.allFinite()) {
+      trial_value = trial_residuals.squaredNorm();
+    }
+
+    // Reject steps that leave the domain or increase the objective, moving
+    // towards gradient descent with shorter steps
+    if (!(trial_value < func_min_)) {
+      damping *= 10.0;
+      if (damping > MAX_DAMPING_) {
+        break;
+      }
+      continue;
+    }
+
+    double change = func_min_ - trial_value;
+    point.swap(trial_point);
+    residuals.swap(trial_residuals);
+    jacobian.swap(trial_jacobian);
+    func_min_ = trial_value;
+    hessian = jacobian.transpose() * jacobian;
+    gradient = jacobian.transpose() * residuals;
+    damping = std::max(0.1 * damping, std::numeric_limits<double>::epsilon());
+
+    // Check if step or relative change in objective is sufficiently small
+    if (step.norm() <= tolerance_ * (point.norm() + tolerance_) ||
+        change <= tolerance_ * func_min_) {
+      break;
+    }
+  }
+
+  return point;
+}
@@ -1,5 +1,8 @@
+#include <cmath>
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/lognormal.hpp>
+#include <mkl.h>
 #include "lognormal_dist.h"
 
 stochastic::LognormalDistribution::LognormalDistribution(double mean, double std_dev)
@@ -12,21 +15,58 @@ stochastic::LognormalDistribution::LognormalDistribution(double mean, double std
 std::vector<double> stochastic::LognormalDistribution::cumulative_dist_func(
     const std::vector<double>& locations) const {
   std::vector<double> evaluations(locations.size());
-
-  for (unsigned int i = 0; i < locations.size(); ++i) {
-    evaluations[i] = cdf(distribution_, locations[i]);
-  }
-
+  cumulative_dist_func(locations.data(), evaluations.data(), locations.size());
   return evaluations;
 }
 
 std::vector<double> stochastic::LognormalDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
+
+double stochastic::LognormalDistribution::cumulative_dist_func(
+    double location) const {
+  return cdf(distribution_, location);
+}
+
+double stochastic::LognormalDistribution::inv_cumulative_dist_func(
+    double probability) const {
+  return quantile(distribution_, probability);
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
-    evaluations[i] = quantile(distribution_, probabilities[i]);
+void stochastic::LognormalDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations, std::size_t size) const {
+  // Invalid locations are evaluated by Boost, so errors match scalar overload
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!(locations[i] >= 0.0 && std::isfinite(locations[i]))) {
+      cdf(distribution_, locations[i]);
+    }
   }
 
-  return evaluations;
+  // Zero locations map to log of zero, which has CDF of zero
+  vdLn(static_cast<MKL_INT>(size), locations, evaluations);
+  for (std::size_t i = 0; i < size; ++i) {
+    evaluations[i] = (evaluations[i] - mean_) / std_dev_;
+  }
+  vdCdfNorm(static_cast<MKL_INT>(size), evaluations, evaluations);
+}
+
+void stochastic::LognormalDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations, std::size_t size) const {
+  // Probabilities outside [0, 1) are evaluated by Boost, so errors match
+  // scalar overload
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!(probabilities[i] >= 0.0 && probabilities[i] < 1.0)) {
+      quantile(distribution_, probabilities[i]);
+    }
+  }
+
+  vdCdfNormInv(static_cast<MKL_INT>(size), probabilities, evaluations);
+  for (std::size_t i = 0; i < size; ++i) {
+    evaluations[i] = mean_ + std_dev_ * evaluations[i];
+  }
+  vdExp(static_cast<MKL_INT>(size), evaluations, evaluations);
 }
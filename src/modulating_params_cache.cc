@@ -0,0 +1,198 @@
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <Eigen/Dense>
+// JSON for Modern C++ single-include header
+#include <nlohmann/json.hpp>
+#include "modulating_params_cache.h"
+
+stochastic::ModulatingParamsCache::ModulatingParamsCache(std::size_t capacity,
+                                                         double resolution)
+    : capacity_{capacity}, resolution_{resolution} {
+  if (capacity_ == 0 || !(resolution_ > 0.0)) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ModulatingParamsCache::ModulatingParamsCache: "
+        "Capacity and resolution must be positive\n");
+  }
+}
+
+bool stochastic::ModulatingParamsCache::find(const Eigen::VectorXd& q_params,
+                                             double t0, int solver,
+                                             Eigen::VectorXd& parameters) {
+  return find(q_params, t0, solver, Eigen::VectorXd(), parameters);
+}
+
+bool stochastic::ModulatingParamsCache::find(
+    const Eigen::VectorXd& q_params, double t0, int solver,
+    const Eigen::VectorXd& initial_guess, Eigen::VectorXd& parameters) {
+  auto key = make_key(q_params, t0, solver, initial_guess);
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto entry = index_.find(key);
+  if (entry == index_.end()) {
+    ++misses_;
+    return false;
+  }
+
+  // Move entry to front of list as most recently used
+  entries_.splice(entries_.begin(), entries_, entry->second);
+  ++hits_;
+
+  const auto& values = entry->second->second;
+  parameters.resize(values.size());
+  for (unsigned int i = 0; i < values.size(); ++i) {
+    parameters(i) = values[i];
+  }
+
+  return true;
+}
+
+void stochastic::ModulatingParamsCache::insert(
+    const Eigen::VectorXd& q_params, double t0, int solver,
+    const Eigen::VectorXd& parameters) {
+  insert(q_params, t0, solver, Eigen::VectorXd(), parameters);
+}
+
+void stochastic::ModulatingParamsCache::insert(
+    const Eigen::VectorXd& q_params, double t0, int solver,
+    const Eigen::VectorXd& initial_guess, const Eigen::VectorXd& parameters) {
+  Entry entry;
+  entry.first = make_key(q_params, t0, solver, initial_guess);
+  for (unsigned int i = 0; i < entry.second.size(); ++i) {
+    entry.second[i] = parameters(i);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  insert_entry(entry);
+}
+
+bool stochastic::ModulatingParamsCache::load(const std::string& input_file) {
+  std::ifstream input(input_file);
+  if (!input.is_open()) {
+    return false;
+  }
+
+  nlohmann::json cache;
+  try {
+    input >> cache;
+  } catch (const std::exception& e) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ModulatingParamsCache::load: Could not parse "
+        "cache file " +
+        input_file + ": " + e.what() + "\n");
+  }
+
+  // Keys quantized with a different resolution refer to different inputs
+  if (cache.at("resolution").get<double>() != resolution_) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ModulatingParamsCache::load: Resolution of "
+        "cache file " +
+        input_file + " does not match cache\n");
+  }
+
+  // Keys written with a different layout can't be compared with keys of
+  // this cache
+  for (const auto& saved_entry : cache.at("entries")) {
+    if (saved_entry.at("key").size() != std::tuple_size<Key>::value) {
+      throw std::runtime_error(
+          "\nERROR: in stochastic::ModulatingParamsCache::load: Keys in cache "
+          "file " +
+          input_file + " do not match key layout of cache\n");
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& saved_entry : cache.at("entries")) {
+    insert_entry(
+        Entry{saved_entry.at("key").get<Key>(),
+              saved_entry.at("parameters").get<std::array<double, 4>>()});
+  }
+
+  return true;
+}
+
+bool stochastic::ModulatingParamsCache::save(
+    const std::string& output_file) const {
+  nlohmann::json cache;
+  cache["resolution"] = resolution_;
+  cache["entries"] = nlohmann::json::array();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto entry = entries_.rbegin(); entry != entries_.rend(); ++entry) {
+      cache["entries"].push_back(
+          {{"key", entry->first}, {"parameters", entry->second}});
+    }
+  }
+
+  std::ofstream output(output_file);
+  if (!output.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ModulatingParamsCache::save: Could not open " +
+        output_file + " for writing\n");
+  }
+  // Doubles are written with round-trip precision, so loaded parameters
+  // match cached parameters exactly
+  output << cache.dump();
+
+  return true;
+}
+
+std::size_t stochastic::ModulatingParamsCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+std::size_t stochastic::ModulatingParamsCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+std::size_t stochastic::ModulatingParamsCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void stochastic::ModulatingParamsCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+stochastic::ModulatingParamsCache::Key
+    stochastic::ModulatingParamsCache::make_key(
+        const Eigen::VectorXd& q_params, double t0, int solver,
+        const Eigen::VectorXd& initial_guess) const {
+  Key key{{std::llround(q_params(0) / resolution_),
+           std::llround(q_params(1) / resolution_),
+           std::llround(q_params(2) / resolution_),
+           std::llround(q_params(3) / resolution_),
+           std::llround(t0 / resolution_), solver, initial_guess.size(), 0, 0,
+           0}};
+  for (unsigned int i = 0; i < initial_guess.size() && i < 3; ++i) {
+    key[7 + i] = std::llround(initial_guess(i) / resolution_);
+  }
+  return key;
+}
+
+void stochastic::ModulatingParamsCache::insert_entry(const Entry& entry) {
+  auto existing = index_.find(entry.first);
+  if (existing != index_.end()) {
+    existing->second->second = entry.second;
+    entries_.splice(entries_.begin(), entries_, existing->second);
+    return;
+  }
+
+  if (entries_.size() >= capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+
+  entries_.push_front(entry);
+  index_.emplace(entry.first, entries_.begin());
+}
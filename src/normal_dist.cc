@@ -1,5 +1,8 @@
+#include <cmath>
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/normal.hpp>
+#include <mkl.h>
 #include "normal_dist.h"
 
 stochastic::NormalDistribution::NormalDistribution(double mean, double std_dev)
@@ -12,21 +15,55 @@ stochastic::NormalDistribution::NormalDistribution(double mean, double std_dev)
 std::vector<double> stochastic::NormalDistribution::cumulative_dist_func(
     const std::vector<double>& locations) const {
   std::vector<double> evaluations(locations.size());
-
-  for (unsigned int i = 0; i < locations.size(); ++i) {
-    evaluations[i] = cdf(distribution_, locations[i]);
-  }
-
+  cumulative_dist_func(locations.data(), evaluations.data(), locations.size());
   return evaluations;
 }
 
 std::vector<double> stochastic::NormalDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
+
+double stochastic::NormalDistribution::cumulative_dist_func(
+    double location) const {
+  return cdf(distribution_, location);
+}
+
+double stochastic::NormalDistribution::inv_cumulative_dist_func(
+    double probability) const {
+  return quantile(distribution_, probability);
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
-    evaluations[i] = quantile(distribution_, probabilities[i]);
+void stochastic::NormalDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations, std::size_t size) const {
+  // Invalid locations are evaluated by Boost, so errors match scalar overload
+  for (std::size_t i = 0; i < size; ++i) {
+    if (std::isnan(locations[i])) {
+      cdf(distribution_, locations[i]);
+    }
   }
 
-  return evaluations;
+  for (std::size_t i = 0; i < size; ++i) {
+    evaluations[i] = (locations[i] - mean_) / std_dev_;
+  }
+  vdCdfNorm(static_cast<MKL_INT>(size), evaluations, evaluations);
+}
+
+void stochastic::NormalDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations, std::size_t size) const {
+  // Probabilities outside (0, 1) are evaluated by Boost, so errors match
+  // scalar overload
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!(probabilities[i] > 0.0 && probabilities[i] < 1.0)) {
+      quantile(distribution_, probabilities[i]);
+    }
+  }
+
+  vdCdfNormInv(static_cast<MKL_INT>(size), probabilities, evaluations);
+  for (std::size_t i = 0; i < size; ++i) {
+    evaluations[i] = mean_ + std_dev_ * evaluations[i];
+  }
 }
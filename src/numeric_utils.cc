@@ -1,6 +1,14 @@
+#include <algorithm>
+#include <atomic>
 #include <complex>
+#include <cstdint>
+#include <ctime>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <string>
 #include <Eigen/Dense>
 #include <mkl.h>
 #include <mkl_dfti.h>
@@ -21,34 +29,116 @@ Eigen::MatrixXd corr_to_cov(const Eigen::MatrixXd& corr,
   return cov_matrix;
 }
   
+namespace {
+/**
+ * Owner of MKL VSL convolution task that deletes task when destroyed
+ */
+struct ConvolutionTask {
+  ConvolutionTask() : task{nullptr} {}
+  ~ConvolutionTask() {
+    if (task) {
+      vslConvDeleteTask(&task);
+    }
+  }
+  ConvolutionTask(const ConvolutionTask&) = delete;
+  ConvolutionTask& operator=(const ConvolutionTask&) = delete;
+  VSLConvTaskPtr task; /**< MKL VSL convolution task */
+};
+
+/**
+ * Crossover length of shorter convolution input for automatic mode
+ */
+std::atomic<std::size_t> convolution_crossover{64};
+
+/**
+ * Maximum number of convolution tasks cached by each thread
+ */
+const std::size_t MAX_CONVOLUTION_TASKS = 4;
+
+/**
+ * Get plan for real batch transform, either from the plan cache or created
+ * for this call only
+ */
+std::shared_ptr<const FftPlan> real_batch_plan(
+    bool cache_plan, std::size_t length, std::size_t num_transforms,
+    std::size_t input_stride, std::size_t input_distance,
+    std::size_t output_stride, std::size_t output_distance,
+    FftPlan::Direction direction) {
+  if (cache_plan) {
+    return FftPlanCache::instance()->get(
+        length, num_transforms, input_stride, input_distance, output_stride,
+        output_distance, direction, FftPlan::Domain::Real);
+  }
+  return std::make_shared<const FftPlan>(
+      length, num_transforms, input_stride, input_distance, output_stride,
+      output_distance, direction, FftPlan::Domain::Real);
+}
+}  // namespace
+
 bool convolve_1d(const std::vector<double>& input_x,
                  const std::vector<double>& input_y,
-                 std::vector<double>& response) {
+                 std::vector<double>& response, ConvolutionMode mode) {
   bool status = true;
   response.resize(input_x.size() + input_y.size() - 1);
 
+  // Select direct convolution for short inputs and FFT-based convolution
+  // otherwise
+  if (mode == ConvolutionMode::Auto) {
+    mode = std::min(input_x.size(), input_y.size()) > convolution_crossover
+               ? ConvolutionMode::Fft
+               : ConvolutionMode::Direct;
+  }
+  MKL_INT conv_mode = mode == ConvolutionMode::Fft ? VSL_CONV_MODE_FFT
+                                                   : VSL_CONV_MODE_DIRECT;
+
+  // VSL tasks can't be executed concurrently, so tasks are cached per
+  // thread and keyed by mode and input lengths. Input lengths vary between
+  // calls, so only the most recently used tasks are kept, ordered from most
+  // to least recently used.
+  using TaskKey = std::tuple<MKL_INT, std::size_t, std::size_t>;
+  static thread_local std::list<
+      std::pair<TaskKey, std::unique_ptr<ConvolutionTask>>>
+      conv_tasks;
+  TaskKey key = std::make_tuple(conv_mode, input_x.size(), input_y.size());
+  auto cached_task = std::find_if(
+      conv_tasks.begin(), conv_tasks.end(),
+      [&key](const std::pair<TaskKey, std::unique_ptr<ConvolutionTask>>&
+                 entry) { return entry.first == key; });
+  if (cached_task != conv_tasks.end()) {
+    conv_tasks.splice(conv_tasks.begin(), conv_tasks, cached_task);
+  } else {
+    if (conv_tasks.size() >= MAX_CONVOLUTION_TASKS) {
+      conv_tasks.pop_back();
+    }
+    conv_tasks.emplace_front(key, nullptr);
+  }
+  auto& conv_task = conv_tasks.front().second;
+
   // Create convolution status and task pointer
   int conv_status;
-  VSLConvTaskPtr conv_task;
-  // Construct convolution task, with solution mode set to direct
-  conv_status =
-      vsldConvNewTask1D(&conv_task, VSL_CONV_MODE_DIRECT, input_x.size(),
-                        input_y.size(), response.size());
+  if (!conv_task) {
+    conv_task.reset(new ConvolutionTask());
+    // Construct convolution task with requested solution mode
+    conv_status =
+        vsldConvNewTask1D(&conv_task->task, conv_mode, input_x.size(),
+                          input_y.size(), response.size());
+
+    // Check if convolution construction was successful
+    if (conv_status != VSL_STATUS_OK) {
+      conv_tasks.pop_front();
+      throw std::runtime_error(
+          "\nERROR: in numeric_utils::convolve_1d: Error in convolution "
+          "construction\n");
+      status = false;
+    }
 
-  // Check if convolution construction was successful
-  if (conv_status != VSL_STATUS_OK) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::convolve_1d: Error in convolution "
-        "construction\n");
-    status = false;
+    // Set convolution to start at first element in input_y
+    vslConvSetStart(conv_task->task, 0);
   }
 
-  // Set convolution to start at first element in input_y
-  vslConvSetStart(conv_task, 0);
-
   // Execute convolution
-  conv_status = vsldConvExec1D(conv_task, input_x.data(), 1, input_y.data(), 1,
-                               response.data(), 1);
+  conv_status = vsldConvExec1D(conv_task->task, input_x.data(), 1,
+                               input_y.data(), 1, response.data(), 1);
 
   // Check if convolution exectution was successful
   if (conv_status != VSL_STATUS_OK) {
@@ -58,106 +148,251 @@ bool convolve_1d(const std::vector<double>& input_x,
     status = false;
   }
 
-  // Delete convolution task
-  vslConvDeleteTask(&conv_task);
-
   return status;
 }
 
-bool inverse_fft(std::vector<std::complex<double>> input_vector,
-                 std::vector<double>& output_vector) {
-  output_vector.resize(input_vector.size());
-
-  // Create task descriptor and MKL status
-  DFTI_DESCRIPTOR_HANDLE fft_descriptor;
-  MKL_LONG fft_status;
+void set_convolution_crossover(std::size_t crossover_length) {
+  convolution_crossover = crossover_length;
+}
 
+std::size_t get_convolution_crossover() { return convolution_crossover; }
+
+FftPlan::FftPlan(std::size_t length, Direction direction, Domain domain,
+                 Precision precision, Placement placement)
+    : FftPlan(length, 1, 1, 0, 1, 0, direction, domain, precision,
+              placement) {}
+
+FftPlan::FftPlan(std::size_t length, std::size_t num_transforms,
+                 std::size_t input_stride, std::size_t input_distance,
+                 std::size_t output_stride, std::size_t output_distance,
+                 Direction direction, Domain domain, Precision precision,
+                 Placement placement)
+    : length_{length},
+      num_transforms_{num_transforms},
+      direction_{direction},
+      domain_{domain},
+      precision_{precision},
+      placement_{placement},
+      descriptor_{nullptr} {
   // Allocate the descriptor data structure and initializes it with default
   // configuration values
-  fft_status = DftiCreateDescriptor(&fft_descriptor, DFTI_DOUBLE, DFTI_REAL, 1,
-                                input_vector.size());
+  MKL_LONG fft_status = DftiCreateDescriptor(
+      &descriptor_, precision_ == Precision::Double ? DFTI_DOUBLE : DFTI_SINGLE,
+      domain_ == Domain::Complex ? DFTI_COMPLEX : DFTI_REAL, 1,
+      static_cast<MKL_LONG>(length_));
   if (fft_status != DFTI_NO_ERROR) {
     throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in descriptor creation\n");
-    return false;
+        "\nERROR: in numeric_utils::FftPlan::FftPlan: Error in descriptor "
+        "creation\n");
   }
-  
-  // Set configuration value to not do inplace transformation
-  fft_status = DftiSetValue(fft_descriptor, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in setting configuration\n");
-    return false;
+
+  // Set configuration value for placement of transformation results
+  fft_status = DftiSetValue(
+      descriptor_, DFTI_PLACEMENT,
+      placement_ == Placement::InPlace ? DFTI_INPLACE : DFTI_NOT_INPLACE);
+
+  // Store complex side of real domain transforms as the first half of the
+  // conjugate-even sequence
+  if (fft_status == DFTI_NO_ERROR && domain_ == Domain::Real) {
+    fft_status = DftiSetValue(descriptor_, DFTI_CONJUGATE_EVEN_STORAGE,
+                              DFTI_COMPLEX_COMPLEX);
   }
 
-  // Set the backward scale factor to be 1 divided by the size of the input vector
-  // to make the backward tranform the inverse of the forward transform
-  fft_status = DftiSetValue(fft_descriptor, DFTI_BACKWARD_SCALE,
-                            static_cast<double>(1.0 / input_vector.size()));
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in setting backward "
-        "scale factor\n");
-    return false;
-  }  
+  // Set layout of data when transforms are not contiguous
+  if (fft_status == DFTI_NO_ERROR && input_stride != 1) {
+    MKL_LONG strides[2] = {0, static_cast<MKL_LONG>(input_stride)};
+    fft_status = DftiSetValue(descriptor_, DFTI_INPUT_STRIDES, strides);
+  }
+
+  if (fft_status == DFTI_NO_ERROR && output_stride != 1) {
+    MKL_LONG strides[2] = {0, static_cast<MKL_LONG>(output_stride)};
+    fft_status = DftiSetValue(descriptor_, DFTI_OUTPUT_STRIDES, strides);
+  }
+
+  // Set number of transforms and distance between them for batches
+  if (fft_status == DFTI_NO_ERROR && num_transforms_ > 1) {
+    fft_status = DftiSetValue(descriptor_, DFTI_NUMBER_OF_TRANSFORMS,
+                              static_cast<MKL_LONG>(num_transforms_));
+    if (fft_status == DFTI_NO_ERROR) {
+      fft_status = DftiSetValue(descriptor_, DFTI_INPUT_DISTANCE,
+                                static_cast<MKL_LONG>(input_distance));
+    }
+    if (fft_status == DFTI_NO_ERROR) {
+      fft_status = DftiSetValue(descriptor_, DFTI_OUTPUT_DISTANCE,
+                                static_cast<MKL_LONG>(output_distance));
+    }
+  }
 
-  // Perform all initialization for the actual FFT computation
-  fft_status = DftiCommitDescriptor(fft_descriptor);
   if (fft_status != DFTI_NO_ERROR) {
+    DftiFreeDescriptor(&descriptor_);
     throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in committing descriptor\n");
-    return false;
+        "\nERROR: in numeric_utils::FftPlan::FftPlan: Error in setting "
+        "configuration\n");
   }
-  
-  // Compute the backward FFT
-  fft_status = DftiComputeBackward(fft_descriptor, input_vector.data(),
-                                   output_vector.data());
+
+  // Set the backward scale factor to be 1 divided by the length of the
+  // transform to make the backward tranform the inverse of the forward
+  // transform
+  if (direction_ == Direction::Backward) {
+    fft_status = DftiSetValue(descriptor_, DFTI_BACKWARD_SCALE,
+                              1.0 / static_cast<double>(length_));
+    if (fft_status != DFTI_NO_ERROR) {
+      DftiFreeDescriptor(&descriptor_);
+      throw std::runtime_error(
+          "\nERROR: in numeric_utils::FftPlan::FftPlan: Error in setting "
+          "backward scale factor\n");
+    }
+  }
+
+  // Perform all initialization for the actual FFT computation
+  fft_status = DftiCommitDescriptor(descriptor_);
   if (fft_status != DFTI_NO_ERROR) {
+    DftiFreeDescriptor(&descriptor_);
     throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in computing backward FFT\n");
-    return false;
+        "\nERROR: in numeric_utils::FftPlan::FftPlan: Error in committing "
+        "descriptor\n");
   }
-  
+}
+
+FftPlan::~FftPlan() {
   // Free the memory allocated for descriptor
-  fft_status = DftiFreeDescriptor(&fft_descriptor);
+  if (descriptor_) {
+    DftiFreeDescriptor(&descriptor_);
+  }
+}
+
+bool FftPlan::execute(void* input, void* output) const {
+  MKL_LONG fft_status;
+
+  if (direction_ == Direction::Forward) {
+    fft_status = placement_ == Placement::InPlace
+                     ? DftiComputeForward(descriptor_, input)
+                     : DftiComputeForward(descriptor_, input, output);
+  } else {
+    fft_status = placement_ == Placement::InPlace
+                     ? DftiComputeBackward(descriptor_, input)
+                     : DftiComputeBackward(descriptor_, input, output);
+  }
+
   if (fft_status != DFTI_NO_ERROR) {
     throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in freeing FFT descriptor\n");
-    return false;
-  }  
+        "\nERROR: in numeric_utils::FftPlan::execute: Error in computing " +
+        std::string(direction_ == Direction::Forward ? "forward" : "backward") +
+        " FFT\n");
+  }
 
   return true;
 }
 
+std::shared_ptr<const FftPlan> FftPlanCache::get(
+    std::size_t length, FftPlan::Direction direction, FftPlan::Domain domain,
+    FftPlan::Precision precision, FftPlan::Placement placement) {
+  return get(length, 1, 1, 0, 1, 0, direction, domain, precision, placement);
+}
+
+std::shared_ptr<const FftPlan> FftPlanCache::get(
+    std::size_t length, std::size_t num_transforms, std::size_t input_stride,
+    std::size_t input_distance, std::size_t output_stride,
+    std::size_t output_distance, FftPlan::Direction direction,
+    FftPlan::Domain domain, FftPlan::Precision precision,
+    FftPlan::Placement placement) {
+  Key key{length,        num_transforms,  input_stride, input_distance,
+          output_stride, output_distance, direction,    domain,
+          precision,     placement};
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto plan = index_.find(key);
+  if (plan != index_.end()) {
+    plans_.splice(plans_.begin(), plans_, plan->second);
+    return plan->second->second;
+  }
+
+  auto new_plan = std::make_shared<const FftPlan>(
+      length, num_transforms, input_stride, input_distance, output_stride,
+      output_distance, direction, domain, precision, placement);
+  plans_.emplace_front(key, new_plan);
+  index_.emplace(key, plans_.begin());
+  evict();
+
+  return new_plan;
+}
+
+std::size_t FftPlanCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return plans_.size();
+}
+
+std::size_t FftPlanCache::capacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+void FftPlanCache::set_capacity(std::size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  evict();
+}
+
+void FftPlanCache::evict() {
+  while (plans_.size() > capacity_) {
+    index_.erase(plans_.back().first);
+    plans_.pop_back();
+  }
+}
+
+void FftPlanCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  plans_.clear();
+}
+
+bool inverse_fft(const std::complex<double>* input, std::size_t length,
+                 std::size_t input_stride, double* output,
+                 std::size_t output_stride) {
+  // Backward real transform only reads first half of conjugate-even input
+  return inverse_real_fft(input, length, input_stride, output, output_stride);
+}
+
+bool inverse_fft(std::complex<double>* data, std::size_t length,
+                 std::size_t stride) {
+  // Get cached plan for in place backward complex transform
+  return FftPlanCache::instance()
+      ->get(length, 1, stride, 0, stride, 0, FftPlan::Direction::Backward,
+            FftPlan::Domain::Complex, FftPlan::Precision::Double,
+            FftPlan::Placement::InPlace)
+      ->execute(data);
+}
+
+bool inverse_fft(const std::vector<std::complex<double>>& input_vector,
+                 std::vector<double>& output_vector) {
+  output_vector.resize(input_vector.size());
+
+  return inverse_fft(input_vector.data(), input_vector.size(), 1,
+                     output_vector.data(), 1);
+}
+
 bool inverse_fft(const Eigen::VectorXcd& input_vector,
                  Eigen::VectorXd& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<std::complex<double>> input_vals(input_vector.size());
-  std::vector<double> outputs(input_vals.size());
-  Eigen::VectorXcd::Map(&input_vals[0], input_vector.size()) = input_vector;
+  output_vector.resize(input_vector.size());
  
   try {
-    inverse_fft(input_vals, outputs);
+    inverse_fft(input_vector.data(), input_vector.size(), 1,
+                output_vector.data(), 1);
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::inverse_fft (With Eigen Vectors):"
               << e.what() << std::endl;
   }
 
-  // Convert output from std vector to Eigen vector
-  output_vector = Eigen::Map<Eigen::VectorXd>(outputs.data(), outputs.size());
-
   return true;
 }
 
 bool inverse_fft(const Eigen::VectorXcd& input_vector,
                  std::vector<double>& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<std::complex<double>> input_vals(input_vector.size());
-  Eigen::VectorXcd::Map(&input_vals[0], input_vector.size()) = input_vector;
   output_vector.resize(input_vector.size());  
  
   try {
-    inverse_fft(input_vals, output_vector);
+    inverse_fft(input_vector.data(), input_vector.size(), 1,
+                output_vector.data(), 1);
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::inverse_fft (With Eigen Vectors):"
               << e.what() << std::endl;
@@ -166,92 +401,55 @@ bool inverse_fft(const Eigen::VectorXcd& input_vector,
   return true;  
 }
 
-bool fft(std::vector<double> input_vector,
-         std::vector<std::complex<double>>& output_vector) {
-  // Convert input vector to complex values
-  std::vector<std::complex<double>> input_complex(input_vector.size());
-  std::copy(input_vector.begin(), input_vector.end(), input_complex.begin());
-  
-  output_vector.resize(input_vector.size());
-
-  // Create task descriptor and MKL status
-  DFTI_DESCRIPTOR_HANDLE fft_descriptor;
-  MKL_LONG fft_status;
-
-  // Allocate the descriptor data structure and initializes it with default
-  // configuration values
-  fft_status = DftiCreateDescriptor(&fft_descriptor, DFTI_DOUBLE, DFTI_COMPLEX,
-                                    1, input_complex.size());
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in descriptor creation\n");
-    return false;
-  }
-  
-  // Set configuration value to not do inplace transformation
-  fft_status = DftiSetValue(fft_descriptor, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in setting configuration\n");
-    return false;
-  }
+bool fft(const double* input, std::size_t length, std::size_t input_stride,
+         std::complex<double>* output, std::size_t output_stride) {
+  // Compute first half of spectrum using real-to-complex transform
+  real_fft(input, length, input_stride, output, output_stride);
 
-  // Perform all initialization for the actual FFT computation
-  fft_status = DftiCommitDescriptor(fft_descriptor);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in committing descriptor\n");
-    return false;
-  }
-  
-  // Compute the backward FFT
-  fft_status = DftiComputeForward(fft_descriptor, input_complex.data(),
-                                  output_vector.data());
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in computing FFT\n");
-    return false;
+  // Fill second half of spectrum using conjugate symmetry
+  for (std::size_t i = length / 2 + 1; i < length; ++i) {
+    output[i * output_stride] = std::conj(output[(length - i) * output_stride]);
   }
-  
-  // Free the memory allocated for descriptor
-  fft_status = DftiFreeDescriptor(&fft_descriptor);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in freeing FFT descriptor\n");
-    return false;
-  }  
 
   return true;
 }
 
+bool fft(std::complex<double>* data, std::size_t length, std::size_t stride) {
+  // Get cached plan for in place forward complex transform
+  return FftPlanCache::instance()
+      ->get(length, 1, stride, 0, stride, 0, FftPlan::Direction::Forward,
+            FftPlan::Domain::Complex, FftPlan::Precision::Double,
+            FftPlan::Placement::InPlace)
+      ->execute(data);
+}
+
+bool fft(const std::vector<double>& input_vector,
+         std::vector<std::complex<double>>& output_vector) {
+  output_vector.resize(input_vector.size());
+
+  return fft(input_vector.data(), input_vector.size(), 1, output_vector.data(),
+             1);
+}
+
 bool fft(const Eigen::VectorXd& input_vector, Eigen::VectorXcd& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<double> input_vals(input_vector.size());
-  std::vector<std::complex<double>> outputs(input_vals.size());
-  Eigen::VectorXd::Map(&input_vals[0], input_vector.size()) = input_vector;
+  output_vector.resize(input_vector.size());
  
   try {
-    fft(input_vals, outputs);
+    fft(input_vector.data(), input_vector.size(), 1, output_vector.data(), 1);
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::fft (With Eigen Vectors):"
               << e.what() << std::endl;
   }
 
-  // Convert output from std vector to Eigen vector
-  output_vector = Eigen::Map<Eigen::VectorXcd>(outputs.data(), outputs.size());
-
   return true;
 }
 
 bool fft(const Eigen::VectorXd& input_vector,
                  std::vector<std::complex<double>>& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<double> input_vals(input_vector.size());
-  Eigen::VectorXd::Map(&input_vals[0], input_vector.size()) = input_vector;
   output_vector.resize(input_vector.size());  
  
   try {
-    fft(input_vals, output_vector);
+    fft(input_vector.data(), input_vector.size(), 1, output_vector.data(), 1);
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::fft (With Eigen Vector and STL vector):"
               << e.what() << std::endl;
@@ -259,7 +457,176 @@ bool fft(const Eigen::VectorXd& input_vector,
 
   return true;  
 }  
-  
+
+bool real_fft(const double* input, std::size_t length,
+              std::size_t input_stride, std::complex<double>* output,
+              std::size_t output_stride) {
+  // Get cached plan for forward real transform and compute FFT. Out of place
+  // transforms do not modify input.
+  return FftPlanCache::instance()
+      ->get(length, 1, input_stride, 0, output_stride, 0,
+            FftPlan::Direction::Forward, FftPlan::Domain::Real)
+      ->execute(const_cast<double*>(input), output);
+}
+
+bool inverse_real_fft(const std::complex<double>* input, std::size_t length,
+                      std::size_t input_stride, double* output,
+                      std::size_t output_stride) {
+  // Get cached plan for backward real transform and compute inverse FFT
+  return FftPlanCache::instance()
+      ->get(length, 1, input_stride, 0, output_stride, 0,
+            FftPlan::Direction::Backward, FftPlan::Domain::Real)
+      ->execute(const_cast<std::complex<double>*>(input), output);
+}
+
+bool real_fft(const std::vector<double>& input_vector,
+              std::vector<std::complex<double>>& output_vector) {
+  output_vector.resize(input_vector.size() / 2 + 1);
+
+  return real_fft(input_vector.data(), input_vector.size(), 1,
+                  output_vector.data(), 1);
+}
+
+bool inverse_real_fft(const std::vector<std::complex<double>>& input_vector,
+                      std::vector<double>& output_vector, std::size_t length) {
+  if (input_vector.size() != length / 2 + 1) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::inverse_real_fft: Input spectrum does not "
+        "have length / 2 + 1 bins\n");
+  }
+
+  output_vector.resize(length);
+
+  return inverse_real_fft(input_vector.data(), length, 1, output_vector.data(),
+                          1);
+}
+
+bool real_fft_batch(const Eigen::MatrixXd& input_matrix,
+                    Eigen::MatrixXcd& output_matrix, bool rowwise,
+                    bool cache_plan) {
+  // Eigen matrices are column major, so rows are strided by the number of
+  // rows and columns are contiguous
+  std::size_t rows = static_cast<std::size_t>(input_matrix.rows());
+  std::size_t cols = static_cast<std::size_t>(input_matrix.cols());
+
+  if (rowwise) {
+    output_matrix.resize(rows, cols / 2 + 1);
+    real_batch_plan(cache_plan, cols, rows, rows, 1, rows, 1,
+                    FftPlan::Direction::Forward)
+        ->execute(const_cast<double*>(input_matrix.data()),
+                  output_matrix.data());
+  } else {
+    output_matrix.resize(rows / 2 + 1, cols);
+    real_batch_plan(cache_plan, rows, cols, 1, rows, 1, rows / 2 + 1,
+                    FftPlan::Direction::Forward)
+        ->execute(const_cast<double*>(input_matrix.data()),
+                  output_matrix.data());
+  }
+
+  return true;
+}
+
+bool inverse_real_fft_batch(const Eigen::MatrixXcd& input_matrix,
+                            Eigen::MatrixXd& output_matrix, std::size_t length,
+                            bool rowwise, bool cache_plan) {
+  std::size_t rows = static_cast<std::size_t>(input_matrix.rows());
+  std::size_t cols = static_cast<std::size_t>(input_matrix.cols());
+
+  if ((rowwise ? cols : rows) != length / 2 + 1) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::inverse_real_fft_batch: Input spectra do "
+        "not have length / 2 + 1 bins\n");
+  }
+
+  if (rowwise) {
+    output_matrix.resize(rows, length);
+    real_batch_plan(cache_plan, length, rows, rows, 1, rows, 1,
+                    FftPlan::Direction::Backward)
+        ->execute(const_cast<std::complex<double>*>(input_matrix.data()),
+                  output_matrix.data());
+  } else {
+    output_matrix.resize(length, cols);
+    real_batch_plan(cache_plan, length, cols, 1, rows, 1, length,
+                    FftPlan::Direction::Backward)
+        ->execute(const_cast<std::complex<double>*>(input_matrix.data()),
+                  output_matrix.data());
+  }
+
+  return true;
+}
+
+bool fft_batch(const double* input, std::complex<double>* output,
+               std::size_t length, std::size_t num_transforms,
+               std::size_t input_stride, std::size_t input_distance,
+               std::size_t output_stride, std::size_t output_distance) {
+  // Compute first half of each spectrum using real-to-complex transform
+  FftPlanCache::instance()
+      ->get(length, num_transforms, input_stride, input_distance,
+            output_stride, output_distance, FftPlan::Direction::Forward,
+            FftPlan::Domain::Real)
+      ->execute(const_cast<double*>(input), output);
+
+  // Fill second half of each spectrum using conjugate symmetry
+  for (std::size_t i = 0; i < num_transforms; ++i) {
+    std::complex<double>* spectrum = output + i * output_distance;
+    for (std::size_t j = length / 2 + 1; j < length; ++j) {
+      spectrum[j * output_stride] =
+          std::conj(spectrum[(length - j) * output_stride]);
+    }
+  }
+
+  return true;
+}
+
+bool fft_batch(const Eigen::MatrixXd& input_matrix,
+               Eigen::MatrixXcd& output_matrix, bool rowwise) {
+  output_matrix.resize(input_matrix.rows(), input_matrix.cols());
+
+  // Eigen matrices are column major, so rows are strided by the number of
+  // rows and columns are contiguous
+  std::size_t rows = static_cast<std::size_t>(input_matrix.rows());
+  std::size_t cols = static_cast<std::size_t>(input_matrix.cols());
+
+  if (rowwise) {
+    return fft_batch(input_matrix.data(), output_matrix.data(), cols, rows,
+                     rows, 1, rows, 1);
+  } else {
+    return fft_batch(input_matrix.data(), output_matrix.data(), rows, cols, 1,
+                     rows, 1, rows);
+  }
+}
+
+bool inverse_fft_batch(const std::complex<double>* input, double* output,
+                       std::size_t length, std::size_t num_transforms,
+                       std::size_t input_stride, std::size_t input_distance,
+                       std::size_t output_stride,
+                       std::size_t output_distance) {
+  // Out of place 1-dimensional transforms do not modify input
+  FftPlanCache::instance()
+      ->get(length, num_transforms, input_stride, input_distance,
+            output_stride, output_distance, FftPlan::Direction::Backward,
+            FftPlan::Domain::Real)
+      ->execute(const_cast<std::complex<double>*>(input), output);
+
+  return true;
+}
+
+bool inverse_fft_batch(const Eigen::MatrixXcd& input_matrix,
+                       Eigen::MatrixXd& output_matrix, bool rowwise) {
+  output_matrix.resize(input_matrix.rows(), input_matrix.cols());
+
+  std::size_t rows = static_cast<std::size_t>(input_matrix.rows());
+  std::size_t cols = static_cast<std::size_t>(input_matrix.cols());
+
+  if (rowwise) {
+    return inverse_fft_batch(input_matrix.data(), output_matrix.data(), cols,
+                             rows, rows, 1, rows, 1);
+  } else {
+    return inverse_fft_batch(input_matrix.data(), output_matrix.data(), rows,
+                             cols, 1, rows, 1, rows);
+  }
+}
+
 double trapazoid_rule(const std::vector<double>& input_vector, double spacing) {
   double result = (input_vector[0] + input_vector[input_vector.size() - 1]) / 2.0;
 
@@ -280,6 +647,126 @@ double trapazoid_rule(const Eigen::VectorXd& input_vector, double spacing) {
   return result * spacing;
 }
 
+namespace {
+/**
+ * Get pointer to contiguous row-major amplitudes for a block of times. Column
+ * major amplitudes are copied to the input buffer.
+ */
+const double* block_amplitudes(const Eigen::MatrixXd& amplitudes,
+                               unsigned int block_start,
+                               unsigned int block_size,
+                               RowMatrixXd& buffer) {
+  buffer = amplitudes.middleRows(block_start, block_size);
+  return buffer.data();
+}
+
+/**
+ * Get pointer to contiguous row-major amplitudes for a block of times.
+ * Row-major amplitudes are read in place.
+ * @tparam Tscalar Type of amplitudes
+ */
+template <typename Tscalar>
+const Tscalar* block_amplitudes(
+    const Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::RowMajor>& amplitudes,
+    unsigned int block_start, unsigned int /*block_size*/,
+    Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic,
+                  Eigen::RowMajor>& /*buffer*/) {
+  return amplitudes.data() + block_start * amplitudes.cols();
+}
+
+/**
+ * Sum harmonics using angle-addition recurrence with periodic
+ * resynchronization. Harmonics are advanced in the scalar type of the
+ * amplitudes, while angles used for resynchronization are always evaluated
+ * in double precision.
+ * @tparam Tmatrix Type of amplitude matrix
+ */
+template <typename Tmatrix>
+void synthesize_harmonics(const Tmatrix& amplitudes,
+                          const std::vector<double>& frequencies,
+                          const std::vector<double>& phases, double time_step,
+                          std::vector<typename Tmatrix::Scalar>& output,
+                          unsigned int resync_interval) {
+  using Scalar = typename Tmatrix::Scalar;
+  using ArrayX = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+  const unsigned int num_times = amplitudes.rows(),
+                     num_freqs = amplitudes.cols();
+
+  if (frequencies.size() != num_freqs || phases.size() != num_freqs) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::harmonic_synthesis: Number of frequencies "
+        "and phases must match number of amplitude columns\n");
+  }
+
+  resync_interval = std::max(resync_interval, 1u);
+  output.assign(num_times, Scalar(0));
+
+  Eigen::Map<const Eigen::ArrayXd> freqs(frequencies.data(), num_freqs);
+  Eigen::Map<const Eigen::ArrayXd> phase(phases.data(), num_freqs);
+
+  // Rotation applied to each harmonic over a single time step
+  Eigen::ArrayXd step_angles = freqs * time_step;
+  ArrayX step_cos = step_angles.cos().template cast<Scalar>();
+  ArrayX step_sin = step_angles.sin().template cast<Scalar>();
+
+  ArrayX cosines(num_freqs), sines(num_freqs), next_cosines(num_freqs);
+  // Amplitudes for a block of times stored with frequencies contiguous
+  Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> buffer;
+
+  for (unsigned int block_start = 0; block_start < num_times;
+       block_start += resync_interval) {
+    unsigned int block_size = std::min(resync_interval, num_times - block_start);
+
+    // Resynchronize harmonics with direct evaluation
+    Eigen::ArrayXd angles = freqs * (block_start * time_step) + phase;
+    cosines = angles.cos().template cast<Scalar>();
+    sines = angles.sin().template cast<Scalar>();
+
+    const Scalar* block =
+        block_amplitudes(amplitudes, block_start, block_size, buffer);
+
+    for (unsigned int i = 0; i < block_size; ++i) {
+      Eigen::Map<const ArrayX> row_amplitudes(block + i * num_freqs,
+                                              num_freqs);
+      output[block_start + i] = (row_amplitudes * cosines).sum();
+
+      // Advance harmonics to next time step
+      next_cosines = cosines * step_cos - sines * step_sin;
+      sines = sines * step_cos + cosines * step_sin;
+      cosines = next_cosines;
+    }
+  }
+}
+}  // namespace
+
+void harmonic_synthesis(const Eigen::MatrixXd& amplitudes,
+                        const std::vector<double>& frequencies,
+                        const std::vector<double>& phases, double time_step,
+                        std::vector<double>& output,
+                        unsigned int resync_interval) {
+  synthesize_harmonics(amplitudes, frequencies, phases, time_step, output,
+                       resync_interval);
+}
+
+void harmonic_synthesis(const RowMatrixXd& amplitudes,
+                        const std::vector<double>& frequencies,
+                        const std::vector<double>& phases, double time_step,
+                        std::vector<double>& output,
+                        unsigned int resync_interval) {
+  synthesize_harmonics(amplitudes, frequencies, phases, time_step, output,
+                       resync_interval);
+}
+
+void harmonic_synthesis(const RowMatrixXf& amplitudes,
+                        const std::vector<double>& frequencies,
+                        const std::vector<double>& phases, double time_step,
+                        std::vector<float>& output,
+                        unsigned int resync_interval) {
+  synthesize_harmonics(amplitudes, frequencies, phases, time_step, output,
+                       resync_interval);
+}
+
 Eigen::VectorXd polyfit_intercept(const Eigen::VectorXd& points,
                                        const Eigen::VectorXd& data,
 				       double intercept,
@@ -382,4 +869,91 @@ std::vector<double> evaluate_polynomial(const std::vector<double>& coefficients,
 
   return evaluations;
 }  
+
+RandomStream::RandomStream(unsigned long long seed, std::uint32_t model,
+                           std::uint32_t spectrum, std::uint32_t sim,
+                           std::uint32_t stream)
+    : seed_{seed},
+      key_{{static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32) ^ model}},
+      counter_{{0, stream, sim, spectrum}},
+      block_{{0, 0, 0, 0}},
+      position_{4} {}
+
+RandomStream::result_type RandomStream::operator()() {
+  if (position_ == 4) {
+    generate_block();
+    ++counter_[0];
+    position_ = 0;
+  }
+
+  return block_[position_++];
+}
+
+double RandomStream::uniform() {
+  // Combine 27 and 26 bits for 53-bit mantissa
+  std::uint32_t upper = (*this)() >> 5;
+  std::uint32_t lower = (*this)() >> 6;
+  return (upper * 67108864.0 + lower) * (1.0 / 9007199254740992.0);
+}
+
+void RandomStream::discard(unsigned long long count) {
+  // Use up values remaining in current block first
+  while (count > 0 && position_ < 4) {
+    ++position_;
+    --count;
+  }
+
+  counter_[0] += static_cast<std::uint32_t>(count / 4);
+
+  if (count % 4 != 0) {
+    generate_block();
+    ++counter_[0];
+    position_ = static_cast<unsigned int>(count % 4);
+  }
+}
+
+RandomStream RandomStream::split(std::uint32_t stream) const {
+  return RandomStream(seed_, key_[1] ^ static_cast<std::uint32_t>(seed_ >> 32),
+                      counter_[3], counter_[2], stream);
+}
+
+void RandomStream::generate_block() {
+  // Philox4x32-10 multipliers and Weyl sequence key increments
+  const std::uint64_t multiplier_0 = 0xD2511F53, multiplier_1 = 0xCD9E8D57;
+  const std::uint32_t weyl_0 = 0x9E3779B9, weyl_1 = 0xBB67AE85;
+
+  std::array<std::uint32_t, 4> state = counter_;
+  std::array<std::uint32_t, 2> key = key_;
+
+  for (unsigned int round = 0; round < 10; ++round) {
+    std::uint64_t product_0 = multiplier_0 * state[0];
+    std::uint64_t product_1 = multiplier_1 * state[2];
+
+    state = {{static_cast<std::uint32_t>(product_1 >> 32) ^ state[1] ^ key[0],
+              static_cast<std::uint32_t>(product_1),
+              static_cast<std::uint32_t>(product_0 >> 32) ^ state[3] ^ key[1],
+              static_cast<std::uint32_t>(product_0)}};
+
+    key[0] += weyl_0;
+    key[1] += weyl_1;
+  }
+
+  block_ = state;
+}
+
+std::uint32_t stream_id(const std::string& name) {
+  std::uint32_t hash = 2166136261u;
+  for (auto character : name) {
+    hash ^= static_cast<unsigned char>(character);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+unsigned long long reserve_stream_seed() {
+  static std::atomic<unsigned long long> next_seed{
+      static_cast<unsigned long long>(std::time(nullptr)) << 20};
+  return next_seed++;
+}
 }  // namespace numeric_utils
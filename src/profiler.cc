@@ -0,0 +1,55 @@
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "json_object.h"
+#include "profiler.h"
+
+std::atomic<bool> utilities::Profiler::enabled_{false};
+
+utilities::Profiler* utilities::Profiler::instance() {
+  static Profiler profiler;
+  return &profiler;
+}
+
+utilities::ProfileStage& utilities::Profiler::stage(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& stage = stages_[name];
+  if (!stage) {
+    stage.reset(new ProfileStage(name));
+  }
+  return *stage;
+}
+
+std::vector<utilities::StageStatistics> utilities::Profiler::statistics()
+    const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<StageStatistics> stage_statistics;
+  for (const auto& entry : stages_) {
+    auto count = entry.second->count();
+    if (count > 0) {
+      stage_statistics.push_back(StageStatistics{
+          entry.first, count, 1.0E-9 * entry.second->nanoseconds()});
+    }
+  }
+  return stage_statistics;
+}
+
+utilities::JsonObject utilities::Profiler::to_json() const {
+  JsonObject profile;
+  for (const auto& stage : statistics()) {
+    JsonObject stage_json;
+    stage_json.add_value("count", stage.count);
+    stage_json.add_value("seconds", stage.seconds);
+    profile.add_value(stage.name, stage_json);
+  }
+  return profile;
+}
+
+void utilities::Profiler::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : stages_) {
+    entry.second->reset();
+  }
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "quantile_table.h"
+
+stochastic::QuantileTable::QuantileTable(
+    std::function<double(double)> quantile, double tolerance)
+    : quantile_{std::move(quantile)}, tolerance_{tolerance} {
+  if (!(tolerance_ > 0.0)) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::QuantileTable::QuantileTable: Tolerance must "
+        "be positive\n");
+  }
+}
+
+double stochastic::QuantileTable::evaluate(double probability) const {
+  std::call_once(built_, [this]() { build(); });
+  return interpolate(probability);
+}
+
+void stochastic::QuantileTable::evaluate(const double* probabilities,
+                                         double* locations,
+                                         std::size_t size) const {
+  std::call_once(built_, [this]() { build(); });
+  for (std::size_t i = 0; i < size; ++i) {
+    locations[i] = interpolate(probabilities[i]);
+  }
+}
+
+std::size_t stochastic::QuantileTable::num_intervals() const {
+  std::call_once(built_, [this]() { build(); });
+  return coefficients_.size() / 4;
+}
+
+void stochastic::QuantileTable::build() const {
+  auto logistic = [](double logit) { return 1.0 / (1.0 + std::exp(-logit)); };
+  auto within_tolerance = [this](double interpolated, double exact) {
+    return std::abs(interpolated - exact) <=
+           tolerance_ * std::max(std::abs(exact), 1.0);
+  };
+
+  std::size_t num_intervals = INITIAL_INTERVALS_;
+  double spacing = 2.0 * MAX_LOGIT_ / num_intervals;
+  std::vector<double> nodes(num_intervals + 1), midpoints(num_intervals);
+  for (std::size_t i = 0; i <= num_intervals; ++i) {
+    nodes[i] = quantile_(logistic(-MAX_LOGIT_ + i * spacing));
+  }
+  for (std::size_t i = 0; i < num_intervals; ++i) {
+    midpoints[i] = quantile_(logistic(-MAX_LOGIT_ + (i + 0.5) * spacing));
+  }
+
+  std::vector<double> coefficients, quarter_points, slopes;
+  std::vector<bool> converged;
+
+  while (true) {
+    // Slopes at nodes from fourth order central differences, second order
+    // near the ends of the grid, limited so that the interpolant is monotone
+    // (Fritsch & Carlson, 1980)
+    slopes.resize(num_intervals + 1);
+    slopes[0] = (-3.0 * nodes[0] + 4.0 * nodes[1] - nodes[2]) / (2.0 * spacing);
+    slopes[num_intervals] =
+        (3.0 * nodes[num_intervals] - 4.0 * nodes[num_intervals - 1] +
+         nodes[num_intervals - 2]) /
+        (2.0 * spacing);
+    slopes[1] = (nodes[2] - nodes[0]) / (2.0 * spacing);
+    slopes[num_intervals - 1] =
+        (nodes[num_intervals] - nodes[num_intervals - 2]) / (2.0 * spacing);
+    for (std::size_t i = 2; i < num_intervals - 1; ++i) {
+      slopes[i] = (nodes[i - 2] - 8.0 * nodes[i - 1] + 8.0 * nodes[i + 1] -
+                   nodes[i + 2]) /
+                  (12.0 * spacing);
+    }
+    for (std::size_t i = 0; i <= num_intervals; ++i) {
+      double left = i > 0 ? (nodes[i] - nodes[i - 1]) / spacing
+                          : (nodes[1] - nodes[0]) / spacing;
+      double right = i < num_intervals ? (nodes[i + 1] - nodes[i]) / spacing
+                                       : left;
+      slopes[i] = std::min(std::max(slopes[i], 0.0),
+                           3.0 * std::min(left, right));
+    }
+
+    // Cubic coefficients in normalized coordinate within each interval
+    coefficients.resize(4 * num_intervals);
+    for (std::size_t i = 0; i < num_intervals; ++i) {
+      double rise = nodes[i + 1] - nodes[i], lower_slope = spacing * slopes[i],
+             upper_slope = spacing * slopes[i + 1];
+      coefficients[4 * i] = nodes[i];
+      coefficients[4 * i + 1] = lower_slope;
+      coefficients[4 * i + 2] = 3.0 * rise - 2.0 * lower_slope - upper_slope;
+      coefficients[4 * i + 3] = lower_slope + upper_slope - 2.0 * rise;
+    }
+
+    // Check interpolation error at quarter points and midpoints of intervals.
+    // Errors in slopes cancel at midpoints, so midpoints alone underestimate
+    // the error. Quarter points are the midpoints of the refined grid.
+    quarter_points.resize(2 * num_intervals);
+    converged.assign(num_intervals, true);
+    bool all_converged = true;
+    for (std::size_t i = 0; i < num_intervals; ++i) {
+      auto interpolate_at = [&coefficients, i](double offset) {
+        return coefficients[4 * i] +
+               offset * (coefficients[4 * i + 1] +
+                         offset * (coefficients[4 * i + 2] +
+                                   offset * coefficients[4 * i + 3]));
+      };
+      quarter_points[2 * i] =
+          quantile_(logistic(-MAX_LOGIT_ + (i + 0.25) * spacing));
+      quarter_points[2 * i + 1] =
+          quantile_(logistic(-MAX_LOGIT_ + (i + 0.75) * spacing));
+      if (!within_tolerance(interpolate_at(0.25), quarter_points[2 * i]) ||
+          !within_tolerance(interpolate_at(0.5), midpoints[i]) ||
+          !within_tolerance(interpolate_at(0.75), quarter_points[2 * i + 1])) {
+        converged[i] = false;
+        all_converged = false;
+      }
+    }
+
+    if (all_converged || 2 * num_intervals > MAX_INTERVALS_) {
+      break;
+    }
+
+    // Refine grid, reusing midpoints as new nodes and quarter points as new
+    // midpoints
+    std::vector<double> refined_nodes(2 * num_intervals + 1);
+    for (std::size_t i = 0; i < num_intervals; ++i) {
+      refined_nodes[2 * i] = nodes[i];
+      refined_nodes[2 * i + 1] = midpoints[i];
+    }
+    refined_nodes[2 * num_intervals] = nodes[num_intervals];
+    nodes = std::move(refined_nodes);
+    midpoints.swap(quarter_points);
+    num_intervals *= 2;
+    spacing /= 2.0;
+  }
+
+  // Restrict table to central range of intervals meeting tolerance, so
+  // heavy tails fall back to the exact quantile function
+  std::size_t center = num_intervals / 2;
+  std::size_t lower = center, upper = center;
+  while (upper < num_intervals && converged[upper]) {
+    ++upper;
+  }
+  while (lower > 0 && converged[lower - 1]) {
+    --lower;
+  }
+
+  coefficients_ = std::move(coefficients);
+  spacing_ = spacing;
+  lower_index_ = lower;
+  upper_index_ = upper;
+}
+
+double stochastic::QuantileTable::interpolate(double probability) const {
+  // Logit of probability locates interval in uniform grid
+  double position =
+      (std::log(probability) - std::log1p(-probability) + MAX_LOGIT_) /
+      spacing_;
+
+  // Negated comparisons also catch NaN positions
+  if (!(position >= static_cast<double>(lower_index_) &&
+        position < static_cast<double>(upper_index_))) {
+    return quantile_(probability);
+  }
+
+  std::size_t index = static_cast<std::size_t>(position);
+  double offset = position - index;
+  const double* coefficients = &coefficients_[4 * index];
+  return coefficients[0] +
+         offset * (coefficients[1] +
+                   offset * (coefficients[2] + offset * coefficients[3]));
+}
@@ -0,0 +1,766 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// JSON for Modern C++ single-include header
+#include <nlohmann/json.hpp>
+#include "json_object.h"
+#include "profiler.h"
+#include "record_writer.h"
+
+namespace {
+// Identifier at start of binary record files
+const char binary_magic[8] = {'S', 'M', 'E', 'L', 'T', 'B', 'I', 'N'};
+// Current binary record format version
+const std::uint32_t binary_version = 2;
+// Byte order mark, read back byte reversed on hosts with other byte order
+const std::uint64_t binary_byte_order = 0x0102030405060708ULL;
+// Key of array of events in JSON output
+const std::string events_key = "Events";
+// Spaces used for indentation in pretty JSON output
+const std::string indentation(64, ' ');
+// Key of profiling statistics in JSON output
+const std::string profile_key = "Profile";
+
+/**
+ * Add profiling statistics of one output to running totals. Counts and times
+ * of stages present in both are summed, other stages are copied.
+ * @param[in, out] total Total statistics of each stage
+ * @param[in] profile Statistics of each stage to add
+ */
+void add_profile(nlohmann::json& total, const nlohmann::json& profile) {
+  for (auto stage = profile.begin(); stage != profile.end(); ++stage) {
+    auto& total_stage = total[stage.key()];
+    for (auto value = stage->begin(); value != stage->end(); ++value) {
+      auto& total_value = total_stage[value.key()];
+      if (total_value.is_null()) {
+        total_value = *value;
+      } else if (value->is_number_unsigned() &&
+                 total_value.is_number_unsigned()) {
+        total_value = total_value.get<unsigned long long>() +
+                      value->get<unsigned long long>();
+      } else {
+        total_value = total_value.get<double>() + value->get<double>();
+      }
+    }
+  }
+}
+
+/**
+ * Get number of bytes needed to pad input length to multiple of 8
+ * @param[in] length Length in bytes
+ * @return Number of padding bytes
+ */
+std::uint64_t padding(std::uint64_t length) { return (8 - length % 8) % 8; }
+
+/**
+ * Write integer value to output stream
+ * @param[in] output Stream to write to
+ * @param[in] value Value to write
+ */
+template <typename Tint>
+void write_integer(std::ofstream& output, Tint value) {
+  output.write(reinterpret_cast<const char*>(&value), sizeof(Tint));
+}
+
+/**
+ * Read integer value from input stream
+ * @param[in] input Stream to read from
+ * @return Value read
+ */
+template <typename Tint>
+Tint read_integer(std::ifstream& input) {
+  Tint value = 0;
+  input.read(reinterpret_cast<char*>(&value), sizeof(Tint));
+  if (!input) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordReader: Unexpected end of "
+        "file\n");
+  }
+  return value;
+}
+
+/**
+ * Write JSON as length-prefixed, space-padded string
+ * @param[in] output Stream to write to
+ * @param[in] value JSON value to write
+ */
+void write_json(std::ofstream& output, const nlohmann::json& value) {
+  std::string text = value.dump();
+  text.append(padding(text.size()), ' ');
+  write_integer<std::uint64_t>(output, text.size());
+  output.write(text.data(), text.size());
+}
+
+/**
+ * Read JSON with input length in bytes
+ * @param[in] input Stream to read from
+ * @param[in] length Number of bytes to read
+ * @return JSON value read
+ */
+nlohmann::json read_json(std::ifstream& input, std::uint64_t length) {
+  std::string text(length, ' ');
+  input.read(&text[0], length);
+  if (!input) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordReader: Unexpected end of "
+        "file\n");
+  }
+  return nlohmann::json::parse(text);
+}
+}  // namespace
+
+utilities::MemoryRecordWriter::MemoryRecordWriter()
+    : header_(json::object()), events_(json::array()) {}
+
+bool utilities::MemoryRecordWriter::write_header(const JsonObject& metadata) {
+  header_ = metadata.get_library_json();
+  return true;
+}
+
+bool utilities::MemoryRecordWriter::write_record(
+    const JsonObject& event, const std::vector<std::vector<double>>& series) {
+  SMELT_PROFILE_SCOPE("MemoryRecordWriter::write_record");
+  auto event_json = event.get_library_json();
+  auto& time_series = event_json["timeSeries"];
+
+  if (time_series.size() != series.size()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::MemoryRecordWriter::write_record: Number of "
+        "time series does not match event metadata\n");
+  }
+
+  for (unsigned int i = 0; i < series.size(); ++i) {
+    time_series[i]["data"] = series[i];
+  }
+  events_.push_back(std::move(event_json));
+
+  return true;
+}
+
+bool utilities::MemoryRecordWriter::write_trailer(const JsonObject& metadata) {
+  auto trailer = metadata.get_library_json();
+  for (auto entry = trailer.begin(); entry != trailer.end(); ++entry) {
+    header_[entry.key()] = *entry;
+  }
+  return true;
+}
+
+bool utilities::MemoryRecordWriter::close() { return true; }
+
+utilities::JsonObject utilities::MemoryRecordWriter::get_json() const {
+  auto output = header_;
+  output["Events"] = events_;
+  return JsonObject(output);
+}
+
+utilities::JsonRecordWriter::JsonRecordWriter(
+    const std::string& output_location, bool pretty, unsigned int precision)
+    : pretty_{pretty},
+      precision_{precision},
+      header_(json::object()),
+      prefix_written_{false},
+      num_records_{0} {
+  output_.open(output_location, std::ios::trunc);
+
+  if (!output_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::JsonRecordWriter::JsonRecordWriter: Could not "
+        "open output location\n");
+  }
+}
+
+utilities::JsonRecordWriter::~JsonRecordWriter() {
+  try {
+    close();
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+  }
+}
+
+bool utilities::JsonRecordWriter::write_header(const JsonObject& metadata) {
+  if (prefix_written_) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::JsonRecordWriter::write_header: Header must be "
+        "written before any records\n");
+  }
+
+  header_ = metadata.get_library_json();
+  return true;
+}
+
+bool utilities::JsonRecordWriter::write_record(
+    const JsonObject& event, const std::vector<std::vector<double>>& series) {
+  SMELT_PROFILE_SCOPE("JsonRecordWriter::write_record");
+  if (!output_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::JsonRecordWriter::write_record: Writer has "
+        "already been closed\n");
+  }
+
+  auto event_json = event.get_library_json();
+  auto time_series = event_json.find("timeSeries");
+  std::size_t num_series =
+      time_series != event_json.end() && time_series->is_array()
+          ? time_series->size()
+          : 0;
+
+  if (num_series != series.size()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::JsonRecordWriter::write_record: Number of "
+        "time series does not match event metadata\n");
+  }
+
+  if (!prefix_written_) {
+    write_prefix();
+  }
+
+  if (num_records_ > 0) {
+    output_.put(',');
+  }
+  write_indent(2);
+
+  // Write event with keys in sorted order, matching library output, and time
+  // series data inserted into each time series object
+  if (event_json.empty()) {
+    output_ << "{}";
+  } else {
+    output_.put('{');
+    bool first_key = true;
+    for (auto entry = event_json.begin(); entry != event_json.end(); ++entry) {
+      if (!first_key) {
+        output_.put(',');
+      }
+      first_key = false;
+      write_indent(3);
+      write_key(entry.key());
+
+      if (entry == time_series && num_series > 0) {
+        output_.put('[');
+        for (std::size_t i = 0; i < num_series; ++i) {
+          if (i > 0) {
+            output_.put(',');
+          }
+          write_indent(4);
+          output_.put('{');
+
+          const auto& series_json = (*time_series)[i];
+          bool data_written = false, first_series_key = true;
+          auto write_series_data = [&]() {
+            if (!first_series_key) {
+              output_.put(',');
+            }
+            first_series_key = false;
+            write_indent(5);
+            write_key("data");
+            write_data(series[i], 5);
+            data_written = true;
+          };
+
+          for (auto series_entry = series_json.begin();
+               series_entry != series_json.end(); ++series_entry) {
+            if (series_entry.key() == "data") {
+              continue;
+            }
+            if (!data_written && series_entry.key() > "data") {
+              write_series_data();
+            }
+            if (!first_series_key) {
+              output_.put(',');
+            }
+            first_series_key = false;
+            write_indent(5);
+            write_key(series_entry.key());
+            write_value(*series_entry, 5);
+          }
+          if (!data_written) {
+            write_series_data();
+          }
+
+          write_indent(4);
+          output_.put('}');
+        }
+        write_indent(3);
+        output_.put(']');
+      } else {
+        write_value(*entry, 3);
+      }
+    }
+    write_indent(2);
+    output_.put('}');
+  }
+
+  if (!output_) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::JsonRecordWriter::write_record: Error when "
+        "writing record\n");
+  }
+
+  ++num_records_;
+  return true;
+}
+
+bool utilities::JsonRecordWriter::write_trailer(const JsonObject& metadata) {
+  if (!output_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::JsonRecordWriter::write_trailer: Writer has "
+        "already been closed\n");
+  }
+
+  auto trailer = metadata.get_library_json();
+  for (auto entry = trailer.begin(); entry != trailer.end(); ++entry) {
+    if (prefix_written_ && entry.key() <= events_key) {
+      throw std::runtime_error(
+          "\nERROR: in utilities::JsonRecordWriter::write_trailer: Keys "
+          "written after records must sort after Events\n");
+    }
+    header_[entry.key()] = *entry;
+  }
+  return true;
+}
+
+bool utilities::JsonRecordWriter::close() {
+  if (!output_.is_open()) {
+    return true;
+  }
+
+  if (!prefix_written_) {
+    write_prefix();
+  }
+
+  // Close array of events
+  if (num_records_ > 0) {
+    write_indent(1);
+  }
+  output_.put(']');
+
+  // Write header metadata sorted after array of events
+  for (auto entry = header_.begin(); entry != header_.end(); ++entry) {
+    if (entry.key() > events_key) {
+      output_.put(',');
+      write_indent(1);
+      write_key(entry.key());
+      write_value(*entry, 1);
+    }
+  }
+
+  write_indent(0);
+  output_ << '}' << std::endl;
+  output_.close();
+
+  if (output_.fail()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::JsonRecordWriter::close: Error when closing "
+        "output location\n");
+  }
+
+  return true;
+}
+
+void utilities::JsonRecordWriter::write_prefix() {
+  output_.put('{');
+
+  // Write header metadata sorted before array of events
+  for (auto entry = header_.begin(); entry != header_.end(); ++entry) {
+    if (entry.key() < events_key) {
+      write_indent(1);
+      write_key(entry.key());
+      write_value(*entry, 1);
+      output_.put(',');
+    }
+  }
+
+  write_indent(1);
+  write_key(events_key);
+  output_.put('[');
+  prefix_written_ = true;
+}
+
+void utilities::JsonRecordWriter::write_indent(unsigned int depth) {
+  if (pretty_) {
+    output_.put('\n');
+    for (unsigned int spaces = 4 * depth; spaces > 0;) {
+      unsigned int num_spaces =
+          std::min(spaces, static_cast<unsigned int>(indentation.size()));
+      output_.write(indentation.data(), num_spaces);
+      spaces -= num_spaces;
+    }
+  }
+}
+
+void utilities::JsonRecordWriter::write_key(const std::string& key) {
+  output_ << json(key).dump() << (pretty_ ? ": " : ":");
+}
+
+void utilities::JsonRecordWriter::write_value(const json& value,
+                                              unsigned int depth) {
+  if (value.is_object() && !value.empty()) {
+    output_.put('{');
+    for (auto entry = value.begin(); entry != value.end(); ++entry) {
+      if (entry != value.begin()) {
+        output_.put(',');
+      }
+      write_indent(depth + 1);
+      write_key(entry.key());
+      write_value(*entry, depth + 1);
+    }
+    write_indent(depth);
+    output_.put('}');
+  } else if (value.is_array() && !value.empty()) {
+    output_.put('[');
+    for (auto entry = value.begin(); entry != value.end(); ++entry) {
+      if (entry != value.begin()) {
+        output_.put(',');
+      }
+      write_indent(depth + 1);
+      write_value(*entry, depth + 1);
+    }
+    write_indent(depth);
+    output_.put(']');
+  } else {
+    // Scalars and empty containers have no nested layout
+    output_ << value.dump();
+  }
+}
+
+void utilities::JsonRecordWriter::write_data(const std::vector<double>& values,
+                                             unsigned int depth) {
+  if (values.empty()) {
+    output_ << "[]";
+    return;
+  }
+
+  char number[64];
+  output_.put('[');
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (i > 0) {
+      output_.put(',');
+    }
+    write_indent(depth + 1);
+
+    if (!std::isfinite(values[i])) {
+      // Library writes non-finite values as null
+      output_ << "null";
+    } else if (precision_ == 0) {
+      // Serialize through the JSON library so output matches library
+      // serialization exactly
+      output_ << json(values[i]).dump();
+    } else {
+      int length = std::snprintf(number, sizeof(number), "%.*g",
+                                 static_cast<int>(precision_), values[i]);
+      output_.write(number, length);
+    }
+  }
+  write_indent(depth);
+  output_.put(']');
+}
+
+utilities::BinaryRecordWriter::BinaryRecordWriter(
+    const std::string& output_location, RecordPrecision precision)
+    : precision_{precision}, header_written_{false}, num_records_{0} {
+  output_.open(output_location, std::ios::binary | std::ios::trunc);
+
+  if (!output_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordWriter::BinaryRecordWriter: Could "
+        "not open output location\n");
+  }
+}
+
+utilities::BinaryRecordWriter::~BinaryRecordWriter() {
+  try {
+    close();
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+  }
+}
+
+bool utilities::BinaryRecordWriter::write_header(const JsonObject& metadata) {
+  if (header_written_) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordWriter::write_header: Header must "
+        "be written before any records\n");
+  }
+
+  write_file_header(metadata.get_library_json());
+  return true;
+}
+
+bool utilities::BinaryRecordWriter::write_record(
+    const JsonObject& event, const std::vector<std::vector<double>>& series) {
+  SMELT_PROFILE_SCOPE("BinaryRecordWriter::write_record");
+  if (!output_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordWriter::write_record: Writer has "
+        "already been closed\n");
+  }
+
+  if (!header_written_) {
+    write_file_header(json::object());
+  }
+
+  write_json(output_, event.get_library_json());
+  write_integer<std::uint64_t>(output_, series.size());
+  for (const auto& values : series) {
+    write_integer<std::uint64_t>(output_, values.size());
+  }
+
+  const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  for (const auto& values : series) {
+    std::uint64_t num_bytes = 0;
+    if (precision_ == RecordPrecision::Double) {
+      num_bytes = values.size() * sizeof(double);
+      output_.write(reinterpret_cast<const char*>(values.data()), num_bytes);
+    } else {
+      buffer_.assign(values.begin(), values.end());
+      num_bytes = buffer_.size() * sizeof(float);
+      output_.write(reinterpret_cast<const char*>(buffer_.data()), num_bytes);
+    }
+    output_.write(zeros, padding(num_bytes));
+  }
+
+  if (!output_) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordWriter::write_record: Error when "
+        "writing record\n");
+  }
+
+  ++num_records_;
+  return true;
+}
+
+bool utilities::BinaryRecordWriter::close() {
+  if (!output_.is_open()) {
+    return true;
+  }
+
+  if (!header_written_) {
+    write_file_header(json::object());
+  }
+
+  // Mark end of records
+  write_integer<std::uint64_t>(output_, 0);
+  output_.close();
+
+  if (output_.fail()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordWriter::close: Error when closing "
+        "output location\n");
+  }
+
+  return true;
+}
+
+void utilities::BinaryRecordWriter::write_file_header(const json& metadata) {
+  output_.write(binary_magic, sizeof(binary_magic));
+  write_integer<std::uint64_t>(output_, binary_byte_order);
+  write_integer<std::uint32_t>(output_, binary_version);
+  write_integer<std::uint32_t>(
+      output_, precision_ == RecordPrecision::Double ? 0 : 1);
+  write_json(output_, metadata);
+  header_written_ = true;
+}
+
+utilities::BinaryRecordReader::BinaryRecordReader(
+    const std::string& input_location)
+    : finished_{false} {
+  input_.open(input_location, std::ios::binary);
+
+  if (!input_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordReader::BinaryRecordReader: Could "
+        "not open input location\n");
+  }
+
+  char magic[8];
+  input_.read(magic, sizeof(magic));
+  if (!input_ || std::memcmp(magic, binary_magic, sizeof(magic)) != 0) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordReader::BinaryRecordReader: Input "
+        "is not a binary record file\n");
+  }
+
+  if (read_integer<std::uint64_t>(input_) != binary_byte_order) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordReader::BinaryRecordReader: Input "
+        "was written on a host with different byte order\n");
+  }
+
+  auto version = read_integer<std::uint32_t>(input_);
+  if (version != binary_version) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::BinaryRecordReader::BinaryRecordReader: "
+        "Unsupported binary record format version\n");
+  }
+
+  precision_ = read_integer<std::uint32_t>(input_) == 0
+                   ? RecordPrecision::Double
+                   : RecordPrecision::Single;
+  header_ = read_json(input_, read_integer<std::uint64_t>(input_));
+}
+
+utilities::JsonObject utilities::BinaryRecordReader::header() const {
+  return JsonObject(header_);
+}
+
+bool utilities::BinaryRecordReader::next(
+    JsonObject& event, std::vector<std::vector<double>>& series) {
+  if (finished_) {
+    return false;
+  }
+
+  auto event_length = read_integer<std::uint64_t>(input_);
+  if (event_length == 0) {
+    finished_ = true;
+    return false;
+  }
+
+  event = JsonObject(read_json(input_, event_length));
+
+  auto num_series = read_integer<std::uint64_t>(input_);
+  series.resize(num_series);
+  for (auto& values : series) {
+    values.resize(read_integer<std::uint64_t>(input_));
+  }
+
+  offsets_.resize(num_series);
+  for (unsigned int i = 0; i < num_series; ++i) {
+    offsets_[i] = static_cast<std::uint64_t>(input_.tellg());
+
+    std::uint64_t num_bytes = 0;
+    if (precision_ == RecordPrecision::Double) {
+      num_bytes = series[i].size() * sizeof(double);
+      input_.read(reinterpret_cast<char*>(series[i].data()), num_bytes);
+    } else {
+      buffer_.resize(series[i].size());
+      num_bytes = buffer_.size() * sizeof(float);
+      input_.read(reinterpret_cast<char*>(buffer_.data()), num_bytes);
+      series[i].assign(buffer_.begin(), buffer_.end());
+    }
+    input_.ignore(padding(num_bytes));
+
+    if (!input_) {
+      throw std::runtime_error(
+          "\nERROR: in utilities::BinaryRecordReader::next: Unexpected end of "
+          "file\n");
+    }
+  }
+
+  return true;
+}
+
+bool utilities::merge_json_records(
+    const std::vector<std::string>& input_locations,
+    const std::string& output_location) {
+  if (input_locations.empty()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::merge_json_records: No input locations "
+        "provided\n");
+  }
+
+  JsonRecordWriter writer(output_location);
+  json header;
+  json profile = json::object();
+  bool has_profile = false;
+  std::vector<std::vector<double>> series;
+
+  for (unsigned int i = 0; i < input_locations.size(); ++i) {
+    std::ifstream input(input_locations[i]);
+    if (!input.is_open()) {
+      throw std::runtime_error(
+          "\nERROR: in utilities::merge_json_records: Could not open input "
+          "location " + input_locations[i] + "\n");
+    }
+
+    json records = json::parse(input);
+    input.close();
+    json events = records[events_key];
+    records.erase(events_key);
+
+    // Profiling statistics differ between shards, so they are summed rather
+    // than compared
+    if (records.count(profile_key) > 0) {
+      add_profile(profile, records[profile_key]);
+      records.erase(profile_key);
+      has_profile = true;
+    }
+
+    if (i == 0) {
+      header = records;
+      writer.write_header(JsonObject(header));
+    } else if (records != header) {
+      throw std::runtime_error(
+          "\nERROR: in utilities::merge_json_records: Header metadata of " +
+          input_locations[i] + " does not match other inputs\n");
+    }
+
+    // Detach time series data from each event and pass to writer
+    for (auto& event : events) {
+      auto& time_series = event["timeSeries"];
+      series.resize(time_series.size());
+      for (unsigned int j = 0; j < time_series.size(); ++j) {
+        const auto& data = time_series[j]["data"];
+        series[j].resize(data.size());
+        for (unsigned int k = 0; k < data.size(); ++k) {
+          // Non-finite values are stored as null
+          series[j][k] = data[k].is_null()
+                             ? std::numeric_limits<double>::quiet_NaN()
+                             : data[k].get<double>();
+        }
+        time_series[j].erase("data");
+      }
+      writer.write_record(JsonObject(event), series);
+    }
+  }
+
+  if (has_profile) {
+    json trailer;
+    trailer[profile_key] = profile;
+    writer.write_trailer(JsonObject(trailer));
+  }
+
+  return writer.close();
+}
+
+bool utilities::merge_binary_records(
+    const std::vector<std::string>& input_locations,
+    const std::string& output_location) {
+  if (input_locations.empty()) {
+    throw std::runtime_error(
+        "\nERROR: in utilities::merge_binary_records: No input locations "
+        "provided\n");
+  }
+
+  // Precision of merged file follows first input
+  BinaryRecordReader first_input(input_locations[0]);
+  auto header = first_input.header();
+  auto precision = first_input.precision();
+  BinaryRecordWriter writer(output_location, precision);
+  writer.write_header(header);
+
+  auto event = JsonObject();
+  std::vector<std::vector<double>> series;
+
+  for (unsigned int i = 0; i < input_locations.size(); ++i) {
+    BinaryRecordReader input(input_locations[i]);
+    if (input.precision() != precision ||
+        input.header().get_library_json() != header.get_library_json()) {
+      throw std::runtime_error(
+          "\nERROR: in utilities::merge_binary_records: Header metadata or "
+          "precision of " + input_locations[i] +
+          " does not match other inputs\n");
+    }
+
+    while (input.next(event, series)) {
+      writer.write_record(event, series);
+    }
+  }
+
+  return writer.close();
+}
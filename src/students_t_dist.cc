@@ -1,6 +1,8 @@
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/students_t.hpp>
 #include "students_t_dist.h"
+#include "quantile_table.h"
 
 stochastic::StudentstDistribution::StudentstDistribution(double mean,
                                                          double std_dev,
@@ -26,11 +28,43 @@ std::vector<double> stochastic::StudentstDistribution::cumulative_dist_func(
 std::vector<double> stochastic::StudentstDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
+
+double stochastic::StudentstDistribution::cumulative_dist_func(
+    double location) const {
+  return cdf(distribution_, (location - mean_) / std_dev_);
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
+double stochastic::StudentstDistribution::inv_cumulative_dist_func(
+    double probability) const {
+  if (quantile_table_) {
+    return quantile_table_->evaluate(probability);
+  }
+  return std_dev_ * quantile(distribution_, probability) + mean_;
+}
+
+void stochastic::StudentstDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations, std::size_t size) const {
+  if (quantile_table_) {
+    quantile_table_->evaluate(probabilities, evaluations, size);
+    return;
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
     evaluations[i] =
         std_dev_ * quantile(distribution_, probabilities[i]) + mean_;
   }
+}
 
-  return evaluations;
+bool stochastic::StudentstDistribution::tabulate_inv_cumulative_dist_func(
+    double tolerance) {
+  quantile_table_.reset(new QuantileTable(
+      [this](double probability) {
+        return std_dev_ * quantile(distribution_, probability) + mean_;
+      },
+      tolerance));
+  return true;
 }
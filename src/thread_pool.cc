@@ -0,0 +1,122 @@
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "thread_pool.h"
+
+utilities::ThreadPool::ThreadPool(unsigned int num_threads)
+    : task_{nullptr},
+      num_items_{0},
+      next_item_{0},
+      pending_workers_{0},
+      generation_{0},
+      stop_{false} {
+  if (num_threads == 0) {
+    num_threads = hardware_threads();
+  }
+
+  workers_.reserve(num_threads - 1);
+  for (unsigned int i = 1; i < num_threads; ++i) {
+    workers_.emplace_back(&ThreadPool::worker_loop, this);
+  }
+}
+
+utilities::ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_available_.notify_all();
+
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void utilities::ThreadPool::parallel_for(
+    std::size_t num_items, const std::function<void(std::size_t)>& task) {
+  // Run serially when there is nothing to distribute
+  if (workers_.empty() || num_items <= 1) {
+    for (std::size_t i = 0; i < num_items; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    num_items_ = num_items;
+    next_item_ = 0;
+    pending_workers_ = workers_.size();
+    error_ = nullptr;
+    ++generation_;
+  }
+  work_available_.notify_all();
+
+  // Calling thread works on items as well
+  run_items();
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this]() { return pending_workers_ == 0; });
+    task_ = nullptr;
+    error = error_;
+    error_ = nullptr;
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+unsigned int utilities::ThreadPool::hardware_threads() {
+  unsigned int num_threads = std::thread::hardware_concurrency();
+  return num_threads == 0 ? 1 : num_threads;
+}
+
+void utilities::ThreadPool::worker_loop() {
+  unsigned long long seen_generation = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_available_.wait(lock, [this, seen_generation]() {
+        return stop_ || generation_ != seen_generation;
+      });
+
+      if (stop_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+
+    run_items();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_workers_ == 0) {
+        work_done_.notify_one();
+      }
+    }
+  }
+}
+
+void utilities::ThreadPool::run_items() {
+  for (std::size_t i = next_item_++; i < num_items_; i = next_item_++) {
+    try {
+      (*task_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      // Abandon remaining items
+      next_item_ = num_items_;
+    }
+  }
+}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/uniform.hpp>
 #include "uniform_dist.h"
@@ -12,21 +15,56 @@ stochastic::UniformDistribution::UniformDistribution(double lower, double upper)
 std::vector<double> stochastic::UniformDistribution::cumulative_dist_func(
     const std::vector<double>& locations) const {
   std::vector<double> evaluations(locations.size());
-
-  for (unsigned int i = 0; i < locations.size(); ++i) {
-    evaluations[i] = cdf(distribution_, locations[i]);
-  }
-
+  cumulative_dist_func(locations.data(), evaluations.data(), locations.size());
   return evaluations;
 }
 
 std::vector<double> stochastic::UniformDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
+
+double stochastic::UniformDistribution::cumulative_dist_func(
+    double location) const {
+  return cdf(distribution_, location);
+}
+
+double stochastic::UniformDistribution::inv_cumulative_dist_func(
+    double probability) const {
+  return quantile(distribution_, probability);
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
-    evaluations[i] = quantile(distribution_, probabilities[i]);
+void stochastic::UniformDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations, std::size_t size) const {
+  // Invalid locations are evaluated by Boost, so errors match scalar overload
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!std::isfinite(locations[i])) {
+      cdf(distribution_, locations[i]);
+    }
   }
 
-  return evaluations;
+  const double width = upper_bound_ - lower_bound_;
+  for (std::size_t i = 0; i < size; ++i) {
+    evaluations[i] = std::min(
+        std::max((locations[i] - lower_bound_) / width, 0.0), 1.0);
+  }
+}
+
+void stochastic::UniformDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations, std::size_t size) const {
+  // Probabilities outside [0, 1] are evaluated by Boost, so errors match
+  // scalar overload
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!(probabilities[i] >= 0.0 && probabilities[i] <= 1.0)) {
+      quantile(distribution_, probabilities[i]);
+    }
+  }
+
+  const double width = upper_bound_ - lower_bound_;
+  for (std::size_t i = 0; i < size; ++i) {
+    evaluations[i] = lower_bound_ + probabilities[i] * width;
+  }
 }
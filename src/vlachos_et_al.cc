@@ -1,26 +1,28 @@
 #define _USE_MATH_DEFINES
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <ctime>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <stdexcept>
 #include <string>
 #include <vector>
-// Boost random generator
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/uniform_real_distribution.hpp>
-#include <boost/random/variate_generator.hpp>
 // Eigen dense matrices
 #include <Eigen/Dense>
 
 #include "factory.h"
+#include "filter_cache.h"
 #include "function_dispatcher.h"
 #include "json_object.h"
 #include "lognormal_dist.h"
 #include "normal_dist.h"
 #include "normal_multivar.h"
 #include "numeric_utils.h"
+#include "profiler.h"
+#include "record_writer.h"
+#include "thread_pool.h"
 #include "vlachos_et_al.h"
 
 stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
@@ -39,6 +41,9 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       num_spectra_{num_spectra},
       num_sims_{num_sims},
       seed_value_{std::numeric_limits<int>::infinity()},
+      stream_seed_{numeric_utils::reserve_stream_seed()},
+      num_threads_{0},
+      record_spectrum_{num_spectra},
       model_parameters_{18} {
   model_name_ = "VlachosEtAl";
   // Factors for site condition based on Vs30
@@ -190,23 +195,14 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       Factory<stochastic::Distribution, double, double>::instance()->create(
           "LognormalDist", std::move(3.658), std::move(0.375));
 
-  // Standard normal distribution with mean at 0.0 and standard deviation of 1.0
-  auto std_normal_dist =
+  // Standard normal distribution with mean at 0.0 and standard deviation of
+  // 1.0, created once here so that parameter identification does not go
+  // through the factory
+  std_normal_dist_ =
       Factory<stochastic::Distribution, double, double>::instance()->create(
           "NormalDist", std::move(0.0), std::move(1.0));
 
-  physical_parameters_.resize(parameter_realizations_.rows(),
-                              parameter_realizations_.cols());
-
-  // Transform sample normal model parameters to physical space
-  for (unsigned int i = 0; i < parameter_realizations_.rows(); ++i) {
-    for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
-      physical_parameters_(i, j) =
-          (model_parameters_[j]->inv_cumulative_dist_func(
-              std_normal_dist->cumulative_dist_func(
-                  std::vector<double>{parameter_realizations_(i, j)})))[0];
-    }
-  }
+  transform_model_parameters();
 }
 
 
@@ -227,6 +223,11 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       num_spectra_{num_spectra},
       num_sims_{num_sims},
       seed_value_{seed_value},
+      stream_seed_{seed_value != std::numeric_limits<int>::infinity()
+                       ? static_cast<unsigned long long>(seed_value)
+                       : numeric_utils::reserve_stream_seed()},
+      num_threads_{0},
+      record_spectrum_{num_spectra},
       model_parameters_{18} {
   model_name_ = "VlachosEtAl";
   // Factors for site condition based on Vs30
@@ -378,99 +379,194 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       Factory<stochastic::Distribution, double, double>::instance()->create(
           "LognormalDist", std::move(3.658), std::move(0.375));
 
-  // Standard normal distribution with mean at 0.0 and standard deviation of 1.0
-  auto std_normal_dist =
+  // Standard normal distribution with mean at 0.0 and standard deviation of
+  // 1.0, created once here so that parameter identification does not go
+  // through the factory
+  std_normal_dist_ =
       Factory<stochastic::Distribution, double, double>::instance()->create(
           "NormalDist", std::move(0.0), std::move(1.0));
 
+  transform_model_parameters();
+}
+
+stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
+                                     double rupture_distance, double vs30,
+                                     double orientation,
+                                     unsigned int num_spectra,
+                                     unsigned int num_sims, int seed_value,
+                                     unsigned int shard_id,
+                                     unsigned int num_shards)
+    : VlachosEtAl(moment_magnitude, rupture_distance, vs30, orientation,
+                  num_spectra, num_sims, seed_value) {
+  set_shard(shard_id, num_shards);
+}
+
+void stochastic::VlachosEtAl::set_quantile_tolerance(double tolerance) {
+  if (!(tolerance > 0.0)) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::set_quantile_tolerance: "
+        "Tolerance must be positive\n");
+  }
+
+  for (auto& distribution : model_parameters_) {
+    distribution->tabulate_inv_cumulative_dist_func(tolerance);
+  }
+  quantile_tolerance_ = tolerance;
+
+  // Restart seeded sample generator so that realizations redrawn during
+  // parameter identification repeat those drawn during construction
+  if (seed_value_ != std::numeric_limits<int>::infinity()) {
+    sample_generator_ =
+        Factory<numeric_utils::RandomGenerator, int>::instance()->create(
+            "MultivariateNormal", std::move(seed_value_));
+    sample_generator_->generate(parameter_realizations_, means_, covariance_,
+                                num_spectra_);
+    parameter_realizations_.transposeInPlace();
+  }
+
+  // Spectrum cached for on demand records depends on physical parameters
+  record_spectrum_ = num_spectra_;
+  transform_model_parameters();
+}
+
+void stochastic::VlachosEtAl::transform_model_parameters() {
   physical_parameters_.resize(parameter_realizations_.rows(),
                               parameter_realizations_.cols());
 
-  // Transform sample normal model parameters to physical space
-  for (unsigned int i = 0; i < parameter_realizations_.rows(); ++i) {
-    for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
-      physical_parameters_(i, j) =
-          (model_parameters_[j]->inv_cumulative_dist_func(
-              std_normal_dist->cumulative_dist_func(
-                  std::vector<double>{parameter_realizations_(i, j)})))[0];
-    }
+  // Transform sample normal model parameters to physical space, one batch
+  // per parameter since columns are contiguous
+  for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
+    std_normal_dist_->cumulative_dist_func(
+        parameter_realizations_.col(j).data(),
+        physical_parameters_.col(j).data(), parameter_realizations_.rows());
+    model_parameters_[j]->inv_cumulative_dist_func(
+        physical_parameters_.col(j).data(), physical_parameters_.col(j).data(),
+        physical_parameters_.rows());
+  }
+
+  // Identify valid modal frequency parameters for every spectrum up front.
+  // Invalid realizations are redrawn from the sample generator, so doing
+  // this here keeps each spectrum fixed for the lifetime of the model
+  // regardless of the order in which spectra are later computed.
+  for (unsigned int i = 0; i < physical_parameters_.rows(); ++i) {
+    physical_parameters_.row(i) =
+        identify_parameters(physical_parameters_.row(i).transpose())
+            .transpose();
   }
 }
 
 utilities::JsonObject stochastic::VlachosEtAl::generate(
     const std::string& event_name, bool units) {
+  utilities::MemoryRecordWriter events;
+  generate(event_name, events, units);
+  return events.get_json();
+}
 
-  // Pool of acceleration time histories based on number of spectra and
-  // simulations requested
-  std::vector<std::vector<std::vector<double>>> acceleration_pool(
-      num_spectra_,
-      std::vector<std::vector<double>>(num_sims_, std::vector<double>()));
+bool stochastic::VlachosEtAl::generate(const std::string& event_name,
+                                       utilities::RecordWriter& writer,
+                                       bool units) {
+  // Draw new seeds for every call when no seed has been provided
+  if (seed_value_ == std::numeric_limits<int>::infinity()) {
+    stream_seed_ = numeric_utils::reserve_stream_seed();
+  }
 
   // Generate family of time histories for each spectrum. Family size is
-  // specified by requested number of simulations per spectra.
+  // specified by requested number of simulations per spectra. Spectra are
+  // processed in blocks the size of the thread pool to bound the number of
+  // power spectra and time histories held in memory, and every (spectrum,
+  // simulation) pair in a block is an independent work item with its own
+  // random stream. Events are written in order once a block is complete.
+  // Only spectra containing records of the requested shard are computed.
   try {
-    for (unsigned int i = 0; i < num_spectra_; ++i) {
-      time_history_family(acceleration_pool[i], physical_parameters_.row(i));
+    unsigned int first_record = shard_begin();
+    unsigned int end_record = shard_end();
+    if (first_record == end_record) {
+      write_profile(writer);
+      return true;
+    }
+    unsigned int first_spectrum = first_record / num_sims_;
+    unsigned int end_spectrum = (end_record + num_sims_ - 1) / num_sims_;
+    auto in_shard = [first_record, end_record, this](unsigned int spectrum,
+                                                     unsigned int sim) {
+      unsigned int record = spectrum * num_sims_ + sim;
+      return record >= first_record && record < end_record;
+    };
+
+    utilities::ThreadPool thread_pool(num_threads_);
+    unsigned int block_size =
+        std::min(thread_pool.size(), end_spectrum - first_spectrum);
+    // In single precision, amplitudes are only kept as 32-bit floats
+    bool single = precision_ == utilities::RecordPrecision::Single;
+    std::vector<numeric_utils::RowMatrixXd> amplitude_spectra(block_size);
+    std::vector<numeric_utils::RowMatrixXf> single_spectra(
+        single ? block_size : 0);
+    std::vector<std::vector<double>> impulse_responses(block_size);
+    std::vector<std::vector<std::vector<double>>> acceleration_pool(
+        block_size, std::vector<std::vector<double>>(num_sims_));
+    std::vector<std::vector<double>> accels(2);
+
+    for (unsigned int block_start = first_spectrum; block_start < end_spectrum;
+         block_start += block_size) {
+      unsigned int num_block_spectra =
+          std::min(block_size, end_spectrum - block_start);
+
+      thread_pool.parallel_for(num_block_spectra, [&](std::size_t i) {
+        amplitude_spectrum_and_filter(
+            physical_parameters_.row(block_start + i), amplitude_spectra[i],
+            impulse_responses[i]);
+        if (single) {
+          single_spectra[i] = amplitude_spectra[i].cast<float>();
+          amplitude_spectra[i].resize(0, 0);
+        }
+      });
+
+      thread_pool.parallel_for(
+          num_block_spectra * num_sims_, [&](std::size_t item) {
+            unsigned int i = static_cast<unsigned int>(item / num_sims_);
+            unsigned int j = static_cast<unsigned int>(item % num_sims_);
+            if (!in_shard(block_start + i, j)) {
+              return;
+            }
+            auto& time_history = acceleration_pool[i][j];
+            auto random_stream = realization_stream(block_start + i, j);
+            if (single) {
+              synthesize_time_history(time_history, single_spectra[i],
+                                      random_stream);
+            } else {
+              synthesize_time_history(time_history, amplitude_spectra[i],
+                                      random_stream);
+            }
+            post_process(time_history, impulse_responses[i]);
+          });
+
+      // Write events for spectra in block
+      for (unsigned int i = 0; i < num_block_spectra; ++i) {
+        for (unsigned int j = 0; j < num_sims_; ++j) {
+          if (!in_shard(block_start + i, j)) {
+            continue;
+          }
+          auto event_data = event_metadata(
+              event_name + "_Spectra" + std::to_string(block_start + i) +
+                  "_Sim" + std::to_string(j),
+              acceleration_pool[i][j].size());
+
+          // Rotate accelerations, if necessary
+          rotate_acceleration(acceleration_pool[i][j], accels[0], accels[1],
+                              units);
+          round_to_precision(accels);
+
+          writer.write_record(event_data, accels);
+        }
+      }
     }
+
+    write_profile(writer);
   } catch (const std::exception& e) {
     std::cerr << e.what();
     throw;
   }
 
-  // Create JsonObject for events
-  auto events = utilities::JsonObject();
-  std::vector<utilities::JsonObject> events_array(num_spectra_ * num_sims_);
-
-  // Add pattern information for JSON
-  auto pattern_x = utilities::JsonObject();
-  auto pattern_y = utilities::JsonObject();  
-  pattern_x.add_value("type", "UniformAcceleration");
-  pattern_x.add_value("timeSeries", "accel_x");
-  pattern_x.add_value("dof", 1);
-  pattern_y.add_value("type", "UniformAcceleration");
-  pattern_y.add_value("timeSeries", "accel_y");
-  pattern_y.add_value("dof", 2);
-
-  // Create JSON for specific event
-  auto event_data = utilities::JsonObject();
-  // Loop over spectra
-  for (unsigned int i = 0; i < num_spectra_; ++i) {
-    // Loop over different simulations for current spectra
-    for (unsigned int j = 0; j < num_sims_; ++j) {
-      event_data.add_value("name", event_name + "_Spectra" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", acceleration_pool[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary      
-      std::vector<double> x_accels(acceleration_pool[i][j].size());
-      std::vector<double> y_accels(acceleration_pool[i][j].size());
-      rotate_acceleration(acceleration_pool[i][j], x_accels, y_accels, units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", x_accels);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", y_accels);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_sims_ + j] = event_data;	
-      event_data.clear();
-    }
-  }
-
-  events.add_value("Events", events_array);
-
-  return events;
+  return true;
 }
 
 bool stochastic::VlachosEtAl::generate(const std::string& event_name,
@@ -480,8 +576,9 @@ bool stochastic::VlachosEtAl::generate(const std::string& event_name,
   
   // Generate pool of acceleration time histories
   try{
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+    utilities::JsonRecordWriter writer(output_location);
+    generate(event_name, writer, units);
+    writer.close();
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -491,10 +588,117 @@ bool stochastic::VlachosEtAl::generate(const std::string& event_name,
   return status;
 }
 
+bool stochastic::VlachosEtAl::generate_record(
+    const std::string& event_name, unsigned int index,
+    utilities::JsonObject& event, std::vector<std::vector<double>>& series,
+    bool units) {
+  if (index >= num_records()) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::generate_record: Record index "
+        "out of range\n");
+  }
+
+  unsigned int spectrum_index = index / num_sims_;
+  unsigned int sim_index = index % num_sims_;
+
+  try {
+    // Only recompute amplitude spectrum when moving to a different spectrum
+    // or precision
+    bool single = precision_ == utilities::RecordPrecision::Single;
+    bool cached = single ? record_amplitudes_single_.size() > 0
+                         : record_amplitudes_.size() > 0;
+    if (record_spectrum_ != spectrum_index || !cached) {
+      record_spectrum_ = num_spectra_;
+      amplitude_spectrum_and_filter(physical_parameters_.row(spectrum_index),
+                                    record_amplitudes_,
+                                    record_impulse_response_);
+      record_amplitudes_single_.resize(0, 0);
+      if (single) {
+        record_amplitudes_single_ = record_amplitudes_.cast<float>();
+        record_amplitudes_.resize(0, 0);
+      }
+      record_spectrum_ = spectrum_index;
+    }
+
+    std::vector<double> time_history;
+    auto random_stream = realization_stream(spectrum_index, sim_index);
+    if (single) {
+      synthesize_time_history(time_history, record_amplitudes_single_,
+                              random_stream);
+    } else {
+      synthesize_time_history(time_history, record_amplitudes_,
+                              random_stream);
+    }
+    post_process(time_history, record_impulse_response_);
+
+    event = event_metadata(event_name + "_Spectra" +
+                               std::to_string(spectrum_index) + "_Sim" +
+                               std::to_string(sim_index),
+                           time_history.size());
+
+    // Rotate accelerations, if necessary
+    series.resize(2);
+    rotate_acceleration(time_history, series[0], series[1], units);
+    round_to_precision(series);
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    throw;
+  }
+
+  return true;
+}
+
 bool stochastic::VlachosEtAl::time_history_family(
     std::vector<std::vector<double>>& time_histories,
-    const Eigen::VectorXd& parameters) const {
+    const Eigen::VectorXd& parameters, unsigned int spectrum_index) const {
   bool status = true;
+  numeric_utils::RowMatrixXd amplitudes;
+  std::vector<double> impulse_response;
+
+  try {
+    amplitude_spectrum_and_filter(parameters, amplitudes, impulse_response);
+
+    // Generate family of time histories sharing amplitude spectrum
+    for (unsigned int i = 0; i < num_sims_; ++i) {
+      auto random_stream = realization_stream(spectrum_index, i);
+      synthesize_time_history(time_histories[i], amplitudes, random_stream);
+      post_process(time_histories[i], impulse_response);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
+bool stochastic::VlachosEtAl::power_spectrum_and_filter(
+    const Eigen::VectorXd& parameters, Eigen::MatrixXd& power_spectrum,
+    std::vector<double>& impulse_response) const {
+  numeric_utils::RowMatrixXd spectrum;
+  spectrum_and_filter(parameters, spectrum, impulse_response);
+  power_spectrum = spectrum;
+
+  return true;
+}
+
+bool stochastic::VlachosEtAl::amplitude_spectrum_and_filter(
+    const Eigen::VectorXd& parameters, numeric_utils::RowMatrixXd& amplitudes,
+    std::vector<double>& impulse_response) const {
+  spectrum_and_filter(parameters, amplitudes, impulse_response);
+
+  // Amplitude of each harmonic in Eq-19, including scaling by frequency step
+  amplitudes.array() = 2.0 * std::sqrt(freq_step_) * amplitudes.array().sqrt();
+
+  return true;
+}
+
+void stochastic::VlachosEtAl::spectrum_and_filter(
+    const Eigen::VectorXd& parameters,
+    numeric_utils::RowMatrixXd& power_spectrum,
+    std::vector<double>& impulse_response) const {
+  SMELT_PROFILE_SCOPE("VlachosEtAl::spectrum_and_filter");
   auto identified_parameters = identify_parameters(parameters);
   
   unsigned int num_times =
@@ -558,21 +762,22 @@ bool stochastic::VlachosEtAl::time_history_family(
 
   // Calculate the evolutionary power spectrum with unit variance at
   // each time step
-  Eigen::MatrixXd power_spectrum(times.size(), frequencies.size());
+  power_spectrum.resize(times.size(), frequencies.size());
+
+  Eigen::VectorXd spectrum_row(frequencies.size());
 
   for (unsigned int i = 0; i < times.size(); ++i) {
-    power_spectrum.row(i) =
+    spectrum_row =
         kt_2(std::vector<double>{mode_1_freqs[i], identified_parameters[8], 1.0,
                                  mode_2_freqs[i], identified_parameters[9],
                                  mode_2_participation[i]},
              frequencies, highpass_butter_energy);
 
     double freq_domain_integral =
-      2.0 * numeric_utils::trapazoid_rule(power_spectrum.row(i), freq_step_);
+      2.0 * numeric_utils::trapazoid_rule(spectrum_row, freq_step_);
     
     power_spectrum.row(i) =
-        power_spectrum.row(i) * amplitude_modulation[i] / freq_domain_integral;
-
+        spectrum_row.transpose() * (amplitude_modulation[i] / freq_domain_integral);
   }
 
   // Get coefficients for highpass Butterworth filter  
@@ -582,86 +787,70 @@ bool stochastic::VlachosEtAl::time_history_family(
                            time_step_ +
                        1);
 
-  auto hp_butter =
-      Dispatcher<std::vector<std::vector<double>>, int, double>::instance()
-          ->dispatch("HighPassButter", filter_order,
-                     norm_cutoff_freq / (1.0 / time_step_ / 2.0));
-
-  // Calculate filter impulse response for calculated number of samples
-  auto impulse_response =
-      Dispatcher<std::vector<double>, std::vector<double>, std::vector<double>,
-                 int, int>::instance()
-          ->dispatch("ImpulseResponse", hp_butter[0], hp_butter[1],
-                     filter_order, num_samples);
-  
-  try {
-    // Generate family of time histories
-    for (unsigned int i = 0; i < num_sims_; ++i) {
-      simulate_time_history(time_histories[i], power_spectrum);
-      post_process(time_histories[i], impulse_response);
-    }
-  } catch (const std::exception& e) {
-    std::cerr << e.what();
-    status = false;
-    throw;
-  }
-
-  return status;
+  // Get filter impulse response for calculated number of samples. Filter
+  // design only depends on constants and time step, so it is cached.
+  impulse_response =
+      *signal_processing::FilterCache::instance()->highpass_impulse_response(
+          filter_order, norm_cutoff_freq, time_step_, num_samples);
 }
 
 void stochastic::VlachosEtAl::simulate_time_history(
     std::vector<double>& time_history,
-    const Eigen::MatrixXd& power_spectrum) const {
-  unsigned int num_times = power_spectrum.rows(),
-               num_freqs = power_spectrum.cols();
+    const Eigen::MatrixXd& power_spectrum,
+    numeric_utils::RandomStream& random_stream) const {
+  numeric_utils::RowMatrixXd amplitudes =
+      2.0 * std::sqrt(freq_step_) * power_spectrum.array().sqrt();
+  synthesize_time_history(time_history, amplitudes, random_stream);
+}
 
-  time_history.resize(num_times, 0.0);
+void stochastic::VlachosEtAl::synthesize_time_history(
+    std::vector<double>& time_history,
+    const numeric_utils::RowMatrixXd& amplitudes,
+    numeric_utils::RandomStream& random_stream) const {
+  SMELT_PROFILE_SCOPE("VlachosEtAl::synthesize_time_history");
+  std::vector<double> frequencies, phase_angle;
+  harmonic_phases(amplitudes.cols(), random_stream, frequencies, phase_angle);
+
+  // Sum harmonics with precomputed amplitudes
+  numeric_utils::harmonic_synthesis(amplitudes, frequencies, phase_angle,
+                                    time_step_, time_history);
+}
 
-  std::vector<double> times(num_times);
-  std::vector<double> frequencies(num_freqs);
+void stochastic::VlachosEtAl::synthesize_time_history(
+    std::vector<double>& time_history,
+    const numeric_utils::RowMatrixXf& amplitudes,
+    numeric_utils::RandomStream& random_stream) const {
+  SMELT_PROFILE_SCOPE("VlachosEtAl::synthesize_time_history");
+  std::vector<double> frequencies, phase_angle;
+  harmonic_phases(amplitudes.cols(), random_stream, frequencies, phase_angle);
+
+  // Sum harmonics in single precision
+  std::vector<float> single_history;
+  numeric_utils::harmonic_synthesis(amplitudes, frequencies, phase_angle,
+                                    time_step_, single_history);
+  time_history.assign(single_history.begin(), single_history.end());
+}
 
-  for (unsigned int i = 0; i < times.size(); ++i) {
-    times[i] = i * time_step_;
-  }
+void stochastic::VlachosEtAl::harmonic_phases(
+    unsigned int num_freqs, numeric_utils::RandomStream& random_stream,
+    std::vector<double>& frequencies, std::vector<double>& phase_angles) const {
+  frequencies.resize(num_freqs);
 
   for (unsigned int i = 0; i < frequencies.size(); ++i) {
     frequencies[i] = i * freq_step_;
   }
 
-  static unsigned int history_seed = static_cast<unsigned int>(std::time(nullptr));
-  history_seed = history_seed + 10;
-  
-  auto generator =
-    seed_value_ != std::numeric_limits<int>::infinity()
-    ? boost::random::mt19937(static_cast<unsigned int>(seed_value_ + 10))
-    : boost::random::mt19937(history_seed);
-
-  boost::random::uniform_real_distribution<> distribution(0.0, 2.0 * M_PI);
-  boost::random::variate_generator<boost::random::mt19937&,
-                                   boost::random::uniform_real_distribution<>>
-      angle_gen(generator, distribution);
-
-  std::vector<double> phase_angle(num_freqs, 0.0);
+  phase_angles.resize(num_freqs);
 
-  for (auto & angle : phase_angle) {
-    angle = angle_gen();
-  }
-
-  // Loop over all frequencies and times to calculate time history
-  for (unsigned int i = 0; i < num_times; ++i) {
-    for (unsigned int j = 0; j < num_freqs; ++j) {
-     time_history[i] =
-          time_history[i] +
-          std::sqrt(power_spectrum(i, j)) *
-              std::cos(frequencies[j] * times[i] + phase_angle[j]);      
-    }
-    time_history[i] = 2.0 * std::sqrt(freq_step_) * time_history[i];
+  for (auto & angle : phase_angles) {
+    angle = 2.0 * M_PI * random_stream.uniform();
   }
 }
 
 bool stochastic::VlachosEtAl::post_process(
     std::vector<double>& time_history,
     const std::vector<double>& filter_imp_resp) const {
+  SMELT_PROFILE_SCOPE("VlachosEtAl::post_process");
   
   bool status = true;
   double time_hann_2 = 1.0;
@@ -679,9 +868,10 @@ bool stochastic::VlachosEtAl::post_process(
   }
 
   // Get Hanning window of length window1_size
-  auto hann_window =
-      Dispatcher<Eigen::VectorXd, unsigned int>::instance()->dispatch(
-          "HannWindow", window1_size);
+  static const auto& hann_window_function =
+      Dispatcher<Eigen::VectorXd, unsigned int>::instance()->resolve(
+          "HannWindow");
+  auto hann_window = hann_window_function(window1_size);
 
   window.head(window2_size) = hann_window.head(window2_size);
   window.tail(window2_size) = hann_window.head(window2_size).reverse();
@@ -714,6 +904,7 @@ bool stochastic::VlachosEtAl::post_process(
 
 Eigen::VectorXd stochastic::VlachosEtAl::identify_parameters(
     const Eigen::VectorXd& initial_params) const {
+  SMELT_PROFILE_SCOPE("VlachosEtAl::identify_parameters");
   // Initialize non-dimensional cumulative energy
   std::vector<double> energy(static_cast<unsigned int>(1.0 / 0.05) + 1, 0.0);
 
@@ -735,11 +926,6 @@ Eigen::VectorXd stochastic::VlachosEtAl::identify_parameters(
 
   double mode_1_mean = initial_params(11), mode_2_mean = initial_params(14);
 
-  // Standard normal distribution with mean at 0.0 and standard deviation of 1.0
-  auto std_normal_dist =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.0), std::move(1.0));  
-
   Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> realizations(
       initial_params.size(), 1);
   Eigen::VectorXd transformed_realizations = initial_params;
@@ -761,11 +947,13 @@ Eigen::VectorXd stochastic::VlachosEtAl::identify_parameters(
     sample_generator_->generate(realizations, means_, covariance_, 1);
     
     // Transform parameter realizations to physical space
+    std_normal_dist_->cumulative_dist_func(realizations.data(),
+                                           transformed_realizations.data(),
+                                           initial_params.size());
     for (unsigned int i = 0; i < initial_params.size(); ++i) {
       transformed_realizations(i) =
-          (model_parameters_[i]->inv_cumulative_dist_func(
-              std_normal_dist->cumulative_dist_func(
-                  std::vector<double>{realizations(i, 0)})))[0];
+          model_parameters_[i]->inv_cumulative_dist_func(
+              transformed_realizations(i));
     }
 
     // Calculate dominant modal frequencies
@@ -867,27 +1055,23 @@ Eigen::VectorXd stochastic::VlachosEtAl::kt_2(
     const std::vector<double>& parameters,
     const std::vector<double>& frequencies,
     const std::vector<double>& highpass_butter) const {
-  Eigen::VectorXd power_spectrum(frequencies.size());
-  double mode1 = 0, mode2 = 0;
-  
-  for (unsigned int i = 0; i < frequencies.size(); ++i) {
-    mode1 = parameters[2] *
-            (1.0 + 4.0 * parameters[1] * parameters[1] *
-                       std::pow(frequencies[i] / parameters[0], 2)) /
-            (std::pow(1 - std::pow(frequencies[i] / parameters[0], 2), 2) +
-             4.0 * parameters[1] * parameters[1] *
-                 std::pow(frequencies[i] / parameters[0], 2));
-    mode2 = parameters[5] *
-            (1.0 + 4.0 * parameters[4] * parameters[4] *
-                       std::pow(frequencies[i] / parameters[3], 2)) /
-            (std::pow(1 - std::pow(frequencies[i] / parameters[3], 2), 2) +
-             4.0 * parameters[4] * parameters[4] *
-                 std::pow(frequencies[i] / parameters[3], 2));
-
-    power_spectrum[i] = highpass_butter[i] * (mode1 + mode2);
-  }
-
-  return power_spectrum;
+  Eigen::Map<const Eigen::ArrayXd> freqs(frequencies.data(),
+                                         frequencies.size());
+  Eigen::Map<const Eigen::ArrayXd> butter(highpass_butter.data(),
+                                          highpass_butter.size());
+
+  // Squared ratios of frequencies to modal dominant frequencies
+  Eigen::ArrayXd ratio_1 = (freqs / parameters[0]).square();
+  Eigen::ArrayXd ratio_2 = (freqs / parameters[3]).square();
+  double damping_1 = 4.0 * parameters[1] * parameters[1];
+  double damping_2 = 4.0 * parameters[4] * parameters[4];
+
+  Eigen::ArrayXd mode1 = parameters[2] * (1.0 + damping_1 * ratio_1) /
+                         ((1.0 - ratio_1).square() + damping_1 * ratio_1);
+  Eigen::ArrayXd mode2 = parameters[5] * (1.0 + damping_2 * ratio_2) /
+                         ((1.0 - ratio_2).square() + damping_2 * ratio_2);
+
+  return (butter * (mode1 + mode2)).matrix();
 }
 
 void stochastic::VlachosEtAl::rotate_acceleration(
@@ -917,3 +1101,46 @@ void stochastic::VlachosEtAl::rotate_acceleration(
     }
   }
 }
+
+numeric_utils::RandomStream stochastic::VlachosEtAl::realization_stream(
+    unsigned int spectrum_index, unsigned int sim_index) const {
+  return numeric_utils::RandomStream(stream_seed_,
+                                     numeric_utils::stream_id(model_name_),
+                                     spectrum_index, sim_index);
+}
+
+utilities::JsonObject stochastic::VlachosEtAl::event_metadata(
+    const std::string& name, std::size_t num_steps) const {
+  SMELT_PROFILE_SCOPE("VlachosEtAl::event_metadata");
+  // Add pattern information for JSON
+  auto pattern_x = utilities::JsonObject();
+  auto pattern_y = utilities::JsonObject();  
+  pattern_x.add_value("type", "UniformAcceleration");
+  pattern_x.add_value("timeSeries", "accel_x");
+  pattern_x.add_value("dof", 1);
+  pattern_y.add_value("type", "UniformAcceleration");
+  pattern_y.add_value("timeSeries", "accel_y");
+  pattern_y.add_value("dof", 2);
+
+  // Time series descriptions for x and y directions
+  auto time_history_x = utilities::JsonObject();
+  auto time_history_y = utilities::JsonObject();
+  time_history_x.add_value("name", "accel_x");
+  time_history_x.add_value("type", "Value");
+  time_history_x.add_value("dT", time_step_);
+  time_history_y.add_value("name", "accel_y");
+  time_history_y.add_value("type", "Value");
+  time_history_y.add_value("dT", time_step_);
+
+  auto event_data = utilities::JsonObject();
+  event_data.add_value("name", name);
+  event_data.add_value("type", "Seismic");
+  event_data.add_value("dT", time_step_);
+  event_data.add_value("numSteps", num_steps);
+  event_data.add_value(
+      "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
+  event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
+                                         time_history_x, time_history_y});
+
+  return event_data;
+}
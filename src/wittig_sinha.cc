@@ -2,8 +2,7 @@
 #include <complex>
 #include <ctime>
 #include <string>
-// Boost random generator
-#include <boost/random/mersenne_twister.hpp>
+// Boost random distributions
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/variate_generator.hpp>
 // Eigen dense matrices
@@ -12,6 +11,8 @@
 #include "function_dispatcher.h"
 #include "json_object.h"
 #include "numeric_utils.h"
+#include "profiler.h"
+#include "record_writer.h"
 #include "wittig_sinha.h"
 
 stochastic::WittigSinha::WittigSinha(std::string exposure_category,
@@ -23,6 +24,7 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
       bldg_height_{height},
       num_floors_{num_floors},
       seed_value_{std::numeric_limits<int>::infinity()},
+      stream_seed_{numeric_utils::reserve_stream_seed()},
       local_x_{std::vector<double>(1, 1.0)},
       local_y_{std::vector<double>(1, 1.0)},
       freq_cutoff_{5.0},
@@ -65,6 +67,9 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
                   total_time)
 {
   seed_value_ = seed_value;
+  if (seed_value_ != std::numeric_limits<int>::infinity()) {
+    stream_seed_ = static_cast<unsigned long long>(seed_value_);
+  }
 }
 
 stochastic::WittigSinha::WittigSinha(std::string exposure_category,
@@ -77,6 +82,7 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
       exposure_category_{exposure_category},
       gust_speed_{gust_speed * 0.44704}, // Convert from mph to m/s
       seed_value_{std::numeric_limits<int>::infinity()},
+      stream_seed_{numeric_utils::reserve_stream_seed()},
       heights_{heights},
       local_x_{x_locations},
       local_y_{y_locations},
@@ -114,80 +120,86 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
   : WittigSinha(exposure_category, gust_speed, heights, x_locations, y_locations, total_time)
 {
   seed_value_ = seed_value;
+  if (seed_value_ != std::numeric_limits<int>::infinity()) {
+    stream_seed_ = static_cast<unsigned long long>(seed_value_);
+  }
 }
 
 utilities::JsonObject stochastic::WittigSinha::generate(const std::string& event_name, bool units) {
+  utilities::MemoryRecordWriter event;
+  generate(event_name, event, units);
+  return event.get_json();
+}
+
+bool stochastic::WittigSinha::generate(const std::string& event_name,
+                                       utilities::RecordWriter& writer,
+                                       bool units) {
+  // Consider case when only looking at floor loads, so only have time histories as
+  // one location along the z-axis
+  if (local_x_.size() != 1 || local_y_.size() != 1) {
+    throw std::runtime_error(
+        "ERROR: In stochastic::WittigSinha::generate: Currently, only supports "
+        "time histories along z-axis at single location\n");
+  }
+
+  // Draw new random streams for every call when no seed has been provided
+  if (seed_value_ == std::numeric_limits<int>::infinity()) {
+    stream_seed_ = numeric_utils::reserve_stream_seed();
+  }
+
+  // Metadata for suite of events
+  auto header = utilities::JsonObject();
+  header.add_value("dT", time_step_);
+  header.add_value("numSteps", num_times_);
+  writer.write_header(header);
+
+  // Only event is not part of shard
+  if (shard_begin() != 0 || shard_end() == 0) {
+    write_profile(writer);
+    return true;
+  }
+
   // Initialize wind velocity vectors
-  std::vector<std::vector<std::vector<std::vector<double>>>> wind_vels(
-      local_x_.size(),
-      std::vector<std::vector<std::vector<double>>>(
-          local_y_.size(),
-          std::vector<std::vector<double>>(
-              heights_.size(), std::vector<double>(num_times_, 0.0))));
-
-  Eigen::MatrixXcd complex_random_vals(num_freqs_, heights_.size());
-  
-  // Loop over heights to find time histories
+  std::vector<std::vector<double>> wind_vels(
+      heights_.size(), std::vector<double>(num_times_, 0.0));
+
+  // Find time histories at all heights
   try {
-    for (unsigned int i = 0; i < local_x_.size(); ++i) {
-      for (unsigned int j = 0; j < local_y_.size(); ++j) {
-        // Generate complex random numbers to use for calculation of discrete
-        // time series
-        complex_random_vals = complex_random_numbers();
-        for (unsigned int k = 0; k < heights_.size(); ++k) {
-          wind_vels[i][j][k] = gen_location_hist(complex_random_vals, k, units);
-        }
-      }
-    }
+    // Generate complex random numbers to use for calculation of discrete
+    // time series
+    wind_vels = gen_location_hists(complex_random_numbers(0), units);
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In stochastic::WittigSinha::generate: "
               << e.what() << std::endl;
   }
 
-  // Create JsonObject for event
-  auto event = utilities::JsonObject();
-  event.add_value("dT", time_step_);
-  event.add_value("numSteps", num_times_);
-  
-  // Consider case when only looking at floor loads, so only have time histories as
-  // one location along the z-axis
-  if (local_x_.size() == 1 && local_y_.size() == 1) {
-    // Arrays of patterns and time histories for each floor
-    std::vector<utilities::JsonObject> pattern_array(heights_.size());
-    std::vector<utilities::JsonObject> event_array(1);
-    std::vector<utilities::JsonObject> time_history_array(heights_.size());
-    auto time_history = utilities::JsonObject();
-    event_array[0].add_value("type", "Wind");
-    event_array[0].add_value("subtype", model_name_);
-
-    for (unsigned int i = 0; i < heights_.size(); ++i) {
-      // Create pattern
-      pattern_array[i].add_value("name", std::to_string(i + 1));
-      pattern_array[i].add_value("timeSeries", std::to_string(i + 1));
-      pattern_array[i].add_value("type", "WindFloorLoad");
-      pattern_array[i].add_value("floor", std::to_string(i + 1));
-      pattern_array[i].add_value("dof", 1);
-      pattern_array[i].add_value("profileVelocity", wind_velocities_[i]);
-      
-      // Create time histories
-      time_history.add_value("name", std::to_string(i + 1));
-      time_history.add_value("dT", time_step_);
-      time_history.add_value("type", "Value");
-      time_history.add_value("data", wind_vels[0][0][i]);
-      time_history_array[i] = time_history;
-      time_history.clear();
-    }
-    
-    event_array[0].add_value("timeSeries", time_history_array);
-    event_array[0].add_value("pattern", pattern_array);
-    event.add_value("Events", event_array);   
-  } else {
+  round_to_precision(wind_vels);
+  writer.write_record(event_metadata(), wind_vels);
+  write_profile(writer);
+
+  return true;
+}
+
+bool stochastic::WittigSinha::generate_record(
+    const std::string& event_name, unsigned int index,
+    utilities::JsonObject& event, std::vector<std::vector<double>>& series,
+    bool units) {
+  if (index >= num_records()) {
     throw std::runtime_error(
-        "ERROR: In stochastic::WittigSinha::generate: Currently, only supports "
-        "time histories along z-axis at single location\n");
+        "\nERROR: in stochastic::WittigSinha::generate_record: Record index "
+        "out of range\n");
   }
 
-  return event;
+  try {
+    series = gen_location_hists(complex_random_numbers(index), units);
+    round_to_precision(series);
+    event = event_metadata();
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    throw;
+  }
+
+  return true;
 }
 
 bool stochastic::WittigSinha::generate(const std::string& event_name,
@@ -197,8 +209,9 @@ bool stochastic::WittigSinha::generate(const std::string& event_name,
   bool status = true;
   // Generate time histories at specified locations
   try {
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+    utilities::JsonRecordWriter writer(output_location);
+    generate(event_name, writer, units);
+    writer.close();
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -209,6 +222,7 @@ bool stochastic::WittigSinha::generate(const std::string& event_name,
 }
 
 Eigen::MatrixXd stochastic::WittigSinha::cross_spectral_density(double frequency) const {
+  SMELT_PROFILE_SCOPE("WittigSinha::cross_spectral_density");
   // Coefficient for coherence function
   double coherence_coeff = 10.0;
   Eigen::MatrixXd cross_spectral_density =
@@ -241,18 +255,16 @@ Eigen::MatrixXd stochastic::WittigSinha::cross_spectral_density(double frequency
   return cross_spectral_density.transpose() + cross_spectral_density - diag_mat;
 }
 
-Eigen::MatrixXcd stochastic::WittigSinha::complex_random_numbers() const {
+Eigen::MatrixXcd stochastic::WittigSinha::complex_random_numbers(
+    unsigned int location_index) const {
+  SMELT_PROFILE_SCOPE("WittigSinha::complex_random_numbers");
   // Construct random number generator for standard normal distribution
-  static unsigned int history_seed = static_cast<unsigned int>(std::time(nullptr));
-  history_seed = history_seed + 10;
+  // using stream specific to location
+  numeric_utils::RandomStream generator(
+      stream_seed_, numeric_utils::stream_id(model_name_), 0, location_index);
 
-  auto generator =
-    seed_value_ != std::numeric_limits<int>::infinity()
-    ? boost::random::mt19937(static_cast<unsigned int>(seed_value_ + 10))
-    : boost::random::mt19937(history_seed);
-  
   boost::random::normal_distribution<> distribution;
-  boost::random::variate_generator<boost::random::mt19937&,
+  boost::random::variate_generator<numeric_utils::RandomStream&,
                                    boost::random::normal_distribution<>>
       distribution_gen(generator, distribution);
 
@@ -333,3 +345,73 @@ std::vector<double> stochastic::WittigSinha::gen_location_hist(
   
   return node_time_history;
 }
+
+std::vector<std::vector<double>> stochastic::WittigSinha::gen_location_hists(
+    const Eigen::MatrixXcd& random_numbers, bool units) const {
+  SMELT_PROFILE_SCOPE("WittigSinha::gen_location_hists");
+
+  // Build full range of random numbers for every location as described in
+  // Equations 7 & 8, with one column per location
+  Eigen::MatrixXcd complex_full_range =
+      Eigen::MatrixXcd::Zero(2 * num_freqs_, random_numbers.cols());
+
+  complex_full_range.block(1, 0, num_freqs_, random_numbers.cols()) =
+      random_numbers.topRows(num_freqs_);
+
+  complex_full_range.block(num_freqs_ + 1, 0, num_freqs_ - 1,
+                           random_numbers.cols()) =
+      random_numbers.topRows(num_freqs_ - 1).colwise().reverse().conjugate();
+
+  complex_full_range.row(num_freqs_) =
+      random_numbers.row(num_freqs_ - 1).cwiseAbs().cast<std::complex<double>>();
+
+  // Calculate wind speeds using real portion of inverse Fast Fourier
+  // Transform of all locations at once
+  Eigen::MatrixXd node_time_histories;
+  numeric_utils::inverse_fft_batch(complex_full_range, node_time_histories);
+
+  // Check if time histories need to be converted to ft/s
+  if (units) {
+    node_time_histories *= 3.28084;
+  }
+
+  std::vector<std::vector<double>> location_hists(
+      node_time_histories.cols(),
+      std::vector<double>(node_time_histories.rows()));
+  for (unsigned int i = 0; i < node_time_histories.cols(); ++i) {
+    Eigen::VectorXd::Map(location_hists[i].data(), node_time_histories.rows()) =
+        node_time_histories.col(i);
+  }
+
+  return location_hists;
+}
+
+utilities::JsonObject stochastic::WittigSinha::event_metadata() const {
+  SMELT_PROFILE_SCOPE("WittigSinha::event_metadata");
+  // Arrays of patterns and time histories for each floor
+  std::vector<utilities::JsonObject> pattern_array(heights_.size());
+  std::vector<utilities::JsonObject> time_history_array(heights_.size());
+  auto event = utilities::JsonObject();
+  event.add_value("type", "Wind");
+  event.add_value("subtype", model_name_);
+
+  for (unsigned int i = 0; i < heights_.size(); ++i) {
+    // Create pattern
+    pattern_array[i].add_value("name", std::to_string(i + 1));
+    pattern_array[i].add_value("timeSeries", std::to_string(i + 1));
+    pattern_array[i].add_value("type", "WindFloorLoad");
+    pattern_array[i].add_value("floor", std::to_string(i + 1));
+    pattern_array[i].add_value("dof", 1);
+    pattern_array[i].add_value("profileVelocity", wind_velocities_[i]);
+
+    // Create time histories
+    time_history_array[i].add_value("name", std::to_string(i + 1));
+    time_history_array[i].add_value("dT", time_step_);
+    time_history_array[i].add_value("type", "Value");
+  }
+
+  event.add_value("timeSeries", time_history_array);
+  event.add_value("pattern", pattern_array);
+
+  return event;
+}
@@ -1,5 +1,7 @@
 #include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
@@ -52,7 +54,19 @@ TEST_CASE("Check the dispatcher class implementation", "[Dispatcher]") {
               Approx(answer_2[i]).epsilon(0.01));
     }
     
+    // Resolve functions once and call through handles
+    const auto& add_small_number_handle =
+        Dispatcher<double, int>::instance()->resolve("AddSmallNumber");
+    REQUIRE(add_small_number_handle(5) == Approx(5.0 + 0.01).epsilon(0.01));
+    REQUIRE(&add_small_number_handle ==
+            &Dispatcher<double, int>::instance()->resolve("AddSmallNumber"));
+    REQUIRE(Dispatcher<double, int>::instance()->list() ==
+            std::vector<std::string>{"AddSmallNumber"});
+
     // Create a non-existant element
+    auto add_small_number_dispatcher = Dispatcher<double, int>::instance();
+    REQUIRE_THROWS_AS(add_small_number_dispatcher->resolve("NoFunc"),
+                      std::runtime_error);
     REQUIRE(
         Dispatcher<std::vector<double>, std::vector<double>, double>::instance()
             ->check("NoFunc") == false);
@@ -1,9 +1,13 @@
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
 #include "factory.h"
 #include "normal_dist.h"
+#include "quantile_table.h"
 
 TEST_CASE("Test different distribution types", "[Distributions]") {
 
@@ -113,4 +117,167 @@ TEST_CASE("Test different distribution types", "[Distributions]") {
     REQUIRE(probabilities[2] == Approx(1.0).epsilon(0.01));
     REQUIRE(calced_locations[2] == Approx(1.0).epsilon(0.01));
   }
+
+  SECTION("Test batch and scalar CDF/ICDF match vector interface") {
+    std::vector<std::shared_ptr<stochastic::Distribution>> distributions = {
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "NormalDist", std::move(1.5), std::move(2.0)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "LognormalDist", std::move(0.5), std::move(0.25)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "UniformDist", std::move(-1.0), std::move(3.0)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "BetaDist", std::move(2.0), std::move(5.0))};
+
+    std::vector<double> probabilities = {0.001, 0.1, 0.25, 0.5, 0.75, 0.999};
+
+    for (auto const& distribution : distributions) {
+      auto locations = distribution->inv_cumulative_dist_func(probabilities);
+      auto calced_probabilities =
+          distribution->cumulative_dist_func(locations);
+
+      std::vector<double> batch_locations(probabilities.size());
+      distribution->inv_cumulative_dist_func(
+          probabilities.data(), batch_locations.data(), probabilities.size());
+
+      // Evaluate CDF in place
+      std::vector<double> batch_probabilities = batch_locations;
+      distribution->cumulative_dist_func(batch_probabilities.data(),
+                                         batch_probabilities.data(),
+                                         batch_probabilities.size());
+
+      for (unsigned int i = 0; i < probabilities.size(); ++i) {
+        REQUIRE(calced_probabilities[i] ==
+                Approx(probabilities[i]).epsilon(1.0e-10));
+        REQUIRE(batch_locations[i] == Approx(locations[i]).epsilon(1.0e-12));
+        REQUIRE(batch_probabilities[i] ==
+                Approx(probabilities[i]).epsilon(1.0e-10));
+        REQUIRE(distribution->inv_cumulative_dist_func(probabilities[i]) ==
+                Approx(locations[i]).epsilon(1.0e-12));
+        REQUIRE(distribution->cumulative_dist_func(locations[i]) ==
+                Approx(probabilities[i]).epsilon(1.0e-10));
+      }
+    }
+
+    // Lognormal CDF is zero at zero
+    std::vector<double> locations = {0.0, 1.0};
+    distributions[1]->cumulative_dist_func(locations.data(), locations.data(),
+                                           locations.size());
+    REQUIRE(locations[0] == 0.0);
+    REQUIRE(locations[1] > 0.0);
+  }
+
+  SECTION("Test invalid inputs throw for every CDF/ICDF entry point") {
+    std::vector<std::shared_ptr<stochastic::Distribution>> distributions = {
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "NormalDist", std::move(1.5), std::move(2.0)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "LognormalDist", std::move(0.5), std::move(0.25)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "UniformDist", std::move(-1.0), std::move(3.0))};
+
+    std::vector<double> invalid_probabilities = {-0.1, 1.5, std::nan("")};
+    for (auto const& distribution : distributions) {
+      for (double probability : invalid_probabilities) {
+        // Invalid probability follows valid ones in batch
+        std::vector<double> probabilities = {0.25, 0.5, probability};
+        std::vector<double> locations(probabilities.size());
+        REQUIRE_THROWS_AS(
+            distribution->inv_cumulative_dist_func(probability),
+            std::domain_error);
+        REQUIRE_THROWS_AS(
+            distribution->inv_cumulative_dist_func(probabilities),
+            std::domain_error);
+        REQUIRE_THROWS_AS(distribution->inv_cumulative_dist_func(
+                              probabilities.data(), locations.data(),
+                              probabilities.size()),
+                          std::domain_error);
+      }
+
+      // Locations that are not numbers are invalid for every distribution
+      std::vector<double> locations = {0.5, std::nan("")};
+      std::vector<double> evaluations(locations.size());
+      REQUIRE_THROWS_AS(distribution->cumulative_dist_func(locations[1]),
+                        std::domain_error);
+      REQUIRE_THROWS_AS(distribution->cumulative_dist_func(locations),
+                        std::domain_error);
+      REQUIRE_THROWS_AS(distribution->cumulative_dist_func(
+                            locations.data(), evaluations.data(),
+                            locations.size()),
+                        std::domain_error);
+    }
+
+    // Negative locations are outside support of lognormal distribution
+    std::vector<double> locations = {1.0, -1.0};
+    REQUIRE_THROWS_AS(distributions[1]->cumulative_dist_func(locations[1]),
+                      std::domain_error);
+    REQUIRE_THROWS_AS(distributions[1]->cumulative_dist_func(locations),
+                      std::domain_error);
+    REQUIRE_THROWS_AS(distributions[1]->cumulative_dist_func(
+                          locations.data(), locations.data(), locations.size()),
+                      std::domain_error);
+  }
+}
+
+TEST_CASE("Test tabulated inverse CDF", "[Distributions]") {
+  std::vector<std::shared_ptr<stochastic::Distribution>> distributions = {
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "BetaDist", std::move(2.0), std::move(5.0)),
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "InverseGaussianDist", std::move(1.0), std::move(3.0)),
+      Factory<stochastic::Distribution, double, double, double>::instance()
+          ->create("StudentstDist", std::move(1.0), std::move(0.25),
+                   std::move(5.0))};
+  std::vector<std::shared_ptr<stochastic::Distribution>> exact_distributions = {
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "BetaDist", std::move(2.0), std::move(5.0)),
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "InverseGaussianDist", std::move(1.0), std::move(3.0)),
+      Factory<stochastic::Distribution, double, double, double>::instance()
+          ->create("StudentstDist", std::move(1.0), std::move(0.25),
+                   std::move(5.0))};
+
+  double tolerance = 1.0e-8;
+
+  // Probabilities spanning the tails, including ones beyond the table
+  std::vector<double> probabilities;
+  for (int i = -300; i <= 300; ++i) {
+    probabilities.push_back(1.0 / (1.0 + std::exp(-0.1 * i - 0.0137)));
+  }
+  probabilities.push_back(1.0e-14);
+
+  for (unsigned int j = 0; j < distributions.size(); ++j) {
+    REQUIRE(distributions[j]->tabulate_inv_cumulative_dist_func(tolerance));
+    auto locations =
+        distributions[j]->inv_cumulative_dist_func(probabilities);
+    auto exact_locations =
+        exact_distributions[j]->inv_cumulative_dist_func(probabilities);
+
+    for (unsigned int i = 0; i < probabilities.size(); ++i) {
+      REQUIRE(std::abs(locations[i] - exact_locations[i]) <=
+              tolerance * std::max(std::abs(exact_locations[i]), 1.0));
+      REQUIRE(distributions[j]->inv_cumulative_dist_func(probabilities[i]) ==
+              locations[i]);
+    }
+  }
+
+  // Distributions with inexpensive inverse CDFs are not tabulated
+  auto normal_dist =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "NormalDist", std::move(0.0), std::move(1.0));
+  REQUIRE(!normal_dist->tabulate_inv_cumulative_dist_func(tolerance));
+
+  SECTION("Test table is refined to meet tolerance") {
+    auto quantile = [](double probability) {
+      return probability * probability;
+    };
+    stochastic::QuantileTable coarse_table(quantile, 1.0e-4),
+        fine_table(quantile, 1.0e-10);
+    REQUIRE(coarse_table.num_intervals() < fine_table.num_intervals());
+    REQUIRE(fine_table.evaluate(0.75) == Approx(0.5625).epsilon(1.0e-9));
+    REQUIRE(fine_table.evaluate(0.0) == quantile(0.0));
+
+    REQUIRE_THROWS_AS(stochastic::QuantileTable(quantile, 0.0),
+                      std::runtime_error);
+  }
 }
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <stdexcept>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
 #include "factory.h"
@@ -76,8 +77,16 @@ TEST_CASE("Check the factory class implementation", "[Factory]") {
         Factory<BaseClass>::instance()->create("AnotherDerivedClass");
     REQUIRE(another_derived_class->name() == "AnotherDerivedClass");
 
+    // Resolve factory function once and create through handle
+    auto create_derived_class =
+        Factory<BaseClass>::instance()->resolve("DerivedClass");
+    REQUIRE(create_derived_class()->name() == "DerivedClass");
+    REQUIRE(create_derived_class()->name() == "DerivedClass");
+
     // Create a non-existant element
     REQUIRE(Factory<BaseClass>::instance()->check("Garbage") == false);
+    REQUIRE_THROWS_AS(Factory<BaseClass>::instance()->resolve("Garbage"),
+                      std::runtime_error);
     try {
       auto garbage = Factory<BaseClass>::instance()->create("Garbage");
     } catch (std::exception &exception) {
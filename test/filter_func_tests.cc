@@ -1,5 +1,6 @@
 #include <vector>
 #include <catch2/catch.hpp>
+#include "filter_cache.h"
 #include "function_dispatcher.h"
 
 TEST_CASE("Test filter functions", "[FilterFuncs][Helpers]") {
@@ -152,4 +153,59 @@ TEST_CASE("Test filter functions", "[FilterFuncs][Helpers]") {
       REQUIRE(std::abs(impulse_response[i] - expected_response[i]) < 1E-6);
     }        
   }
+
+  SECTION("Test filter design cache") {
+    signal_processing::FilterCache cache(2);
+
+    // Cutoff of 125 Hz at time step of 0.002 is half the Nyquist frequency
+    int filter_order = 2;
+    double cutoff_freq = 125.0, time_step = 0.002;
+    int num_samples = 5;
+
+    auto impulse_response = cache.highpass_impulse_response(
+        filter_order, cutoff_freq, time_step, num_samples);
+
+    std::vector<double> expected_response = {
+        0.292893218813453, -0.585786437626905, 0.242640687119285,
+        0.100505063388335, -0.041630560342616};
+
+    REQUIRE(impulse_response->size() == expected_response.size());
+    for (unsigned int i = 0; i < impulse_response->size(); ++i) {
+      REQUIRE(std::abs((*impulse_response)[i] - expected_response[i]) < 1E-6);
+    }
+
+    // Repeated requests share the same design
+    REQUIRE(cache.highpass_impulse_response(filter_order, cutoff_freq,
+                                            time_step, num_samples) ==
+            impulse_response);
+    REQUIRE(cache.highpass_butterworth(filter_order, cutoff_freq, time_step) ==
+            cache.highpass_butterworth(filter_order, cutoff_freq, time_step));
+    REQUIRE(cache.size() == 2);
+
+    // Acausal filter matches dispatched filter function
+    unsigned int acausal_order = 4, acausal_samples = 64;
+    auto acausal_filter = cache.acausal_highpass_filter(
+        acausal_order, 0.5, 0.01, acausal_samples);
+    auto expected_filter =
+        Dispatcher<std::vector<double>, double, double, unsigned int,
+                   unsigned int>::instance()
+            ->dispatch("AcausalHighpassButterworth", 0.5, 0.01, acausal_order,
+                       acausal_samples);
+    REQUIRE(*acausal_filter == expected_filter);
+    REQUIRE(cache.acausal_highpass_filter(acausal_order, 0.5, 0.01,
+                                          acausal_samples) == acausal_filter);
+
+    // Different lengths are separate designs, and a full table is cleared
+    // without invalidating designs held by callers
+    auto longer_filter = cache.acausal_highpass_filter(
+        acausal_order, 0.5, 0.01, 2 * acausal_samples);
+    REQUIRE(longer_filter->size() > acausal_filter->size());
+    cache.acausal_highpass_filter(acausal_order, 0.5, 0.01,
+                                  4 * acausal_samples);
+    REQUIRE(cache.size() == 3);
+    REQUIRE(*acausal_filter == expected_filter);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+  }
 }
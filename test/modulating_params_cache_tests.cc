@@ -0,0 +1,178 @@
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <Eigen/Dense>
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "modulating_params_cache.h"
+
+TEST_CASE("Test modulating parameters cache", "[Helpers][Cache]") {
+  Eigen::VectorXd q_params_1(4), q_params_2(4), q_params_3(4);
+  q_params_1 << 12.0, 14.0, 3.9, 5.7;
+  q_params_2 << 9.0, 15.2, 3.9, 5.5;
+  q_params_3 << 30.0, 10.0, 2.5, 4.0;
+  Eigen::VectorXd parameters_1(4), parameters_2(4), parameters_3(4);
+  parameters_1 << 2.1516, 0.1082, 6.5923, 0.0375;
+  parameters_2 << 4.4321, 0.0970, 5.7577, 0.0324;
+  parameters_3 << 1.5, 0.2, 4.0, 0.05;
+
+  SECTION("Test lookup of quantized inputs") {
+    stochastic::ModulatingParamsCache cache(10, 1.0e-6);
+    Eigen::VectorXd parameters;
+
+    REQUIRE(!cache.find(q_params_1, 1.7, 0, parameters));
+    cache.insert(q_params_1, 1.7, 0, parameters_1);
+    REQUIRE(cache.size() == 1);
+
+    REQUIRE(cache.find(q_params_1, 1.7, 0, parameters));
+    REQUIRE(parameters == parameters_1);
+
+    // Inputs within resolution share entry
+    Eigen::VectorXd nearby_q_params = q_params_1.array() + 1.0e-8;
+    REQUIRE(cache.find(nearby_q_params, 1.7 + 1.0e-8, 0, parameters));
+    REQUIRE(parameters == parameters_1);
+
+    // Different start time, solver or initial guess are different entries
+    Eigen::VectorXd initial_guess = parameters_2.head(3);
+    REQUIRE(!cache.find(q_params_1, 0.0, 0, parameters));
+    REQUIRE(!cache.find(q_params_1, 1.7, 1, parameters));
+    REQUIRE(!cache.find(q_params_1, 1.7, 0, initial_guess, parameters));
+    REQUIRE(cache.hits() == 2);
+    REQUIRE(cache.misses() == 4);
+
+    cache.insert(q_params_1, 1.7, 0, initial_guess, parameters_3);
+    REQUIRE(cache.find(q_params_1, 1.7, 0, initial_guess, parameters));
+    REQUIRE(parameters == parameters_3);
+    REQUIRE(cache.find(q_params_1, 1.7, 0, parameters));
+    REQUIRE(parameters == parameters_1);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.hits() == 0);
+    REQUIRE(!cache.find(q_params_1, 1.7, 0, parameters));
+  }
+
+  SECTION("Test least recently used entry is evicted") {
+    stochastic::ModulatingParamsCache cache(2);
+    REQUIRE(cache.capacity() == 2);
+    Eigen::VectorXd parameters;
+
+    cache.insert(q_params_1, 0.0, 0, parameters_1);
+    cache.insert(q_params_2, 0.0, 0, parameters_2);
+    // Use first entry so that second entry is least recently used
+    REQUIRE(cache.find(q_params_1, 0.0, 0, parameters));
+    cache.insert(q_params_3, 0.0, 0, parameters_3);
+
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.find(q_params_1, 0.0, 0, parameters));
+    REQUIRE(!cache.find(q_params_2, 0.0, 0, parameters));
+    REQUIRE(cache.find(q_params_3, 0.0, 0, parameters));
+    REQUIRE(parameters == parameters_3);
+
+    REQUIRE_THROWS_AS(stochastic::ModulatingParamsCache(0),
+                      std::runtime_error);
+  }
+
+  SECTION("Test cache persists to disk") {
+    std::remove("./test_modulating_params_cache.json");
+    Eigen::VectorXd parameters;
+
+    {
+      stochastic::ModulatingParamsCache cache(2);
+      REQUIRE(!cache.load("./test_modulating_params_cache.json"));
+      cache.insert(q_params_1, 0.0, 0, parameters_1);
+      cache.insert(q_params_2, 0.0, 0, parameters_2);
+      cache.find(q_params_1, 0.0, 0, parameters);
+      REQUIRE(cache.save("./test_modulating_params_cache.json"));
+    }
+
+    stochastic::ModulatingParamsCache loaded_cache(2);
+    REQUIRE(loaded_cache.load("./test_modulating_params_cache.json"));
+    REQUIRE(loaded_cache.size() == 2);
+    REQUIRE(loaded_cache.find(q_params_2, 0.0, 0, parameters));
+    REQUIRE(parameters == parameters_2);
+
+    // Recency order is preserved, so first entry is evicted next
+    loaded_cache.insert(q_params_3, 0.0, 0, parameters_3);
+    REQUIRE(!loaded_cache.find(q_params_1, 0.0, 0, parameters));
+
+    stochastic::ModulatingParamsCache coarse_cache(2, 1.0e-3);
+    REQUIRE_THROWS_AS(coarse_cache.load("./test_modulating_params_cache.json"),
+                      std::runtime_error);
+    std::remove("./test_modulating_params_cache.json");
+  }
+
+  SECTION("Test cache is shared by models") {
+    config::initialize();
+    auto cache = std::make_shared<stochastic::ModulatingParamsCache>();
+    stochastic::DabaghiDerKiureghian model(
+        stochastic::FaultType::StrikeSlip, stochastic::SimulationType::NoPulse,
+        6.5, 0.0, 10.0, 760.0, 26.0, 0.0, 1, 1, true, 10);
+    stochastic::DabaghiDerKiureghian other_model(
+        stochastic::FaultType::StrikeSlip, stochastic::SimulationType::NoPulse,
+        6.5, 0.0, 10.0, 760.0, 26.0, 0.0, 1, 1, true, 20);
+    REQUIRE(!model.modulating_params_cache());
+    auto uncached_parameters =
+        model.backcalculate_modulating_params(q_params_1, 1.7);
+
+    model.set_modulating_params_cache(cache);
+    other_model.set_modulating_params_cache(cache);
+    REQUIRE(model.modulating_params_cache() == cache);
+
+    auto parameters = model.backcalculate_modulating_params(q_params_1, 1.7);
+    REQUIRE(cache.use_count() == 3);
+    REQUIRE(cache->misses() == 1);
+    REQUIRE(parameters == uncached_parameters);
+
+    auto cached_parameters =
+        other_model.backcalculate_modulating_params(q_params_1, 1.7);
+    REQUIRE(cache->hits() == 1);
+    REQUIRE(cached_parameters == uncached_parameters);
+
+    // Reference solver is cached separately
+    other_model.backcalculate_modulating_params(
+        q_params_1, 1.7, stochastic::ModulatingFitMode::NelderMead);
+    REQUIRE(cache->misses() == 2);
+    REQUIRE(cache->size() == 2);
+  }
+
+  SECTION("Test cached fits do not depend on insertion order") {
+    config::initialize();
+    stochastic::DabaghiDerKiureghian model(
+        stochastic::FaultType::StrikeSlip, stochastic::SimulationType::NoPulse,
+        6.5, 0.0, 10.0, 760.0, 26.0, 0.0, 1, 1, true, 10);
+
+    // Same targets fit without and with warm starts from different guesses
+    Eigen::VectorXd guess_1 = parameters_1.head(3),
+                    guess_2 = parameters_3.head(3);
+    auto mode = stochastic::ModulatingFitMode::LevenbergMarquardt;
+    auto cold = model.backcalculate_modulating_params(q_params_2, 1.7, mode);
+    auto warm_1 =
+        model.backcalculate_modulating_params(q_params_2, 1.7, mode, guess_1);
+    auto warm_2 =
+        model.backcalculate_modulating_params(q_params_2, 1.7, mode, guess_2);
+
+    // Every fit returns its uncached result whichever fit was cached first
+    for (unsigned int order = 0; order < 3; ++order) {
+      model.set_modulating_params_cache(
+          std::make_shared<stochastic::ModulatingParamsCache>());
+      std::vector<Eigen::VectorXd> guesses = {Eigen::VectorXd(), guess_1,
+                                              guess_2};
+      std::vector<Eigen::VectorXd> expected = {cold, warm_1, warm_2};
+      for (unsigned int i = 0; i < guesses.size(); ++i) {
+        unsigned int index = (order + i) % guesses.size();
+        REQUIRE(model.backcalculate_modulating_params(
+                    q_params_2, 1.7, mode, guesses[index]) == expected[index]);
+      }
+      // Repeated lookups hit cache and give the same results
+      for (unsigned int i = 0; i < guesses.size(); ++i) {
+        REQUIRE(model.backcalculate_modulating_params(
+                    q_params_2, 1.7, mode, guesses[i]) == expected[i]);
+      }
+      REQUIRE(model.modulating_params_cache()->hits() == 3);
+      REQUIRE(model.modulating_params_cache()->size() == 3);
+    }
+  }
+}
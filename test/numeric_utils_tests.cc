@@ -70,6 +70,62 @@ TEST_CASE("Test one dimensional convolution", "[Helpers][Convolution]") {
     REQUIRE(response[2] == Approx(14.0).epsilon(0.01));
     REQUIRE(response[3] == Approx(5.0).epsilon(0.01));
   }  
+
+  SECTION("Direct, FFT and automatic convolution modes agree") {
+    std::vector<double> input_x(150), input_y(90);
+    for (unsigned int i = 0; i < input_x.size(); ++i) {
+      input_x[i] = std::sin(0.1 * i);
+    }
+    for (unsigned int i = 0; i < input_y.size(); ++i) {
+      input_y[i] = std::exp(-0.05 * i);
+    }
+
+    std::vector<double> direct, fft_based, automatic;
+    REQUIRE(numeric_utils::convolve_1d(input_x, input_y, direct,
+                                       numeric_utils::ConvolutionMode::Direct));
+    REQUIRE(numeric_utils::convolve_1d(input_x, input_y, fft_based,
+                                       numeric_utils::ConvolutionMode::Fft));
+
+    // Force automatic mode to use both methods
+    auto crossover = numeric_utils::get_convolution_crossover();
+    numeric_utils::set_convolution_crossover(input_y.size());
+    REQUIRE(numeric_utils::get_convolution_crossover() == input_y.size());
+    REQUIRE(numeric_utils::convolve_1d(input_x, input_y, automatic));
+    for (unsigned int i = 0; i < direct.size(); ++i) {
+      REQUIRE(std::abs(automatic[i] - direct[i]) < 1E-10);
+    }
+    numeric_utils::set_convolution_crossover(input_y.size() - 1);
+    REQUIRE(numeric_utils::convolve_1d(input_x, input_y, automatic));
+    numeric_utils::set_convolution_crossover(crossover);
+
+    REQUIRE(direct.size() == input_x.size() + input_y.size() - 1);
+    REQUIRE(fft_based.size() == direct.size());
+    REQUIRE(automatic.size() == direct.size());
+    for (unsigned int i = 0; i < direct.size(); ++i) {
+      REQUIRE(std::abs(fft_based[i] - direct[i]) < 1E-8);
+      REQUIRE(std::abs(automatic[i] - direct[i]) < 1E-8);
+    }
+
+    // Repeated convolution with cached task gives same result
+    std::vector<double> repeated;
+    numeric_utils::convolve_1d(input_x, input_y, repeated,
+                               numeric_utils::ConvolutionMode::Direct);
+    REQUIRE(repeated == direct);
+
+    // Convolving inputs of many lengths evicts cached tasks and still gives
+    // same result when returning to earlier lengths
+    for (unsigned int length = 10; length < 30; ++length) {
+      std::vector<double> shortened(input_y.begin(), input_y.begin() + length);
+      std::vector<double> result;
+      REQUIRE(numeric_utils::convolve_1d(
+          input_x, shortened, result, numeric_utils::ConvolutionMode::Fft));
+      REQUIRE(result.size() == input_x.size() + length - 1);
+      REQUIRE(std::abs(result[length / 2] - direct[length / 2]) < 1E-8);
+    }
+    numeric_utils::convolve_1d(input_x, input_y, repeated,
+                               numeric_utils::ConvolutionMode::Direct);
+    REQUIRE(repeated == direct);
+  }
 }
 
 TEST_CASE("Test trapazoid rule", "[Helpers][Trapazoid]") {
@@ -116,6 +172,77 @@ TEST_CASE("Test trapazoid rule", "[Helpers][Trapazoid]") {
   }    
 }
 
+TEST_CASE("Test harmonic synthesis", "[Helpers][Synthesis]") {
+  unsigned int num_times = 300, num_freqs = 50;
+  double time_step = 0.01;
+  Eigen::MatrixXd amplitudes = Eigen::MatrixXd::Random(num_times, num_freqs);
+  std::vector<double> frequencies(num_freqs), phases(num_freqs);
+  for (unsigned int j = 0; j < num_freqs; ++j) {
+    frequencies[j] = 0.7 * j;
+    phases[j] = 0.37 * j;
+  }
+
+  std::vector<double> expected(num_times, 0.0);
+  for (unsigned int i = 0; i < num_times; ++i) {
+    for (unsigned int j = 0; j < num_freqs; ++j) {
+      expected[i] += amplitudes(i, j) *
+                     std::cos(frequencies[j] * i * time_step + phases[j]);
+    }
+  }
+
+  SECTION("Test synthesis matches direct evaluation") {
+    // Include interval that does not divide number of times and interval of
+    // 1 where every time step is evaluated directly
+    for (unsigned int interval : {1u, 7u, 64u, 1000u}) {
+      std::vector<double> output;
+      numeric_utils::harmonic_synthesis(amplitudes, frequencies, phases,
+                                        time_step, output, interval);
+      REQUIRE(output.size() == num_times);
+      for (unsigned int i = 0; i < num_times; ++i) {
+        REQUIRE(std::abs(output[i] - expected[i]) < 1e-11);
+      }
+    }
+  }
+
+  SECTION("Test row-major amplitudes give identical results") {
+    numeric_utils::RowMatrixXd row_amplitudes = amplitudes;
+    for (unsigned int interval : {7u, 64u}) {
+      std::vector<double> output, row_output;
+      numeric_utils::harmonic_synthesis(amplitudes, frequencies, phases,
+                                        time_step, output, interval);
+      numeric_utils::harmonic_synthesis(row_amplitudes, frequencies, phases,
+                                        time_step, row_output, interval);
+      REQUIRE(row_output == output);
+    }
+  }
+
+  SECTION("Test single precision synthesis is within error bound") {
+    numeric_utils::RowMatrixXf single_amplitudes = amplitudes.cast<float>();
+    double eps = std::pow(2.0, -24);
+    for (unsigned int interval : {1u, 7u, 64u}) {
+      std::vector<float> output;
+      numeric_utils::harmonic_synthesis(single_amplitudes, frequencies, phases,
+                                        time_step, output, interval);
+      REQUIRE(output.size() == num_times);
+      double bound_factor =
+          (2.0 * interval + std::log2(num_freqs) + 2.0) * eps;
+      for (unsigned int i = 0; i < num_times; ++i) {
+        double bound = bound_factor * amplitudes.row(i).cwiseAbs().sum();
+        REQUIRE(std::abs(output[i] - expected[i]) < bound);
+      }
+    }
+  }
+
+  SECTION("Test mismatched inputs throw") {
+    std::vector<double> output;
+    std::vector<double> short_phases(num_freqs - 1, 0.0);
+    REQUIRE_THROWS_AS(
+        numeric_utils::harmonic_synthesis(amplitudes, frequencies,
+                                          short_phases, time_step, output),
+        std::runtime_error);
+  }
+}
+
 TEST_CASE("Test 1-D inverse Fast Fourier Transform", "[Helpers][FFT]") {
   SECTION("Calculate real portion of one-dimesional inverse FFT") {
     std::vector<std::complex<double>> input_vector = {
@@ -211,6 +338,274 @@ TEST_CASE("Test 1-D Fast Fourier Transform", "[Helpers][FFT]") {
   }
 }
 
+TEST_CASE("Test strided 1-D Fast Fourier Transforms", "[Helpers][FFT]") {
+  SECTION("Transform rows of Eigen matrix without copies") {
+    Eigen::MatrixXd signals(3, 4);
+    signals << 3.0, 1.0, 0.0, 0.0,
+               1.0, 2.0, 3.0, 4.0,
+               0.0, 1.0, 0.0, 1.0;
+
+    // Rows of column major matrix are strided by the number of rows
+    Eigen::MatrixXcd spectra(3, 4);
+    auto status = numeric_utils::fft(signals.data(), 4, 3, spectra.data(), 3);
+
+    REQUIRE(status);
+    REQUIRE(real(spectra(0, 0)) == Approx(4.0).epsilon(0.01));
+    REQUIRE(real(spectra(0, 1)) == Approx(3.0).epsilon(0.01));
+    REQUIRE(imag(spectra(0, 1)) == Approx(-1.0).epsilon(0.01));
+    REQUIRE(real(spectra(0, 2)) == Approx(2.0).epsilon(0.01));
+    REQUIRE(real(spectra(0, 3)) == Approx(3.0).epsilon(0.01));
+    REQUIRE(imag(spectra(0, 3)) == Approx(1.0).epsilon(0.01));
+
+    // Second row starts one element after first row
+    Eigen::MatrixXd recovered(3, 4);
+    numeric_utils::fft(signals.data() + 1, 4, 3, spectra.data() + 1, 3);
+    status = numeric_utils::inverse_fft(spectra.data() + 1, 4, 3,
+                                        recovered.data() + 1, 3);
+
+    REQUIRE(status);
+    for (unsigned int j = 0; j < signals.cols(); ++j) {
+      REQUIRE(recovered(1, j) == Approx(signals(1, j)).epsilon(0.01));
+    }
+  }
+
+  SECTION("Transform complex data in place") {
+    std::vector<std::complex<double>> data = {
+        {1.0, 0.0}, {2.0, -1.0}, {0.0, 3.0}, {-1.0, 0.5}, {2.5, 0.0}};
+    auto original = data;
+
+    REQUIRE(numeric_utils::fft(data.data(), data.size()));
+    REQUIRE(real(data[0]) == Approx(4.5).epsilon(0.01));
+    REQUIRE(imag(data[0]) == Approx(2.5).epsilon(0.01));
+
+    REQUIRE(numeric_utils::inverse_fft(data.data(), data.size()));
+    for (unsigned int i = 0; i < data.size(); ++i) {
+      REQUIRE(std::abs(data[i] - original[i]) < 1E-10);
+    }
+  }
+}
+
+TEST_CASE("Test 1-D real-to-complex Fast Fourier Transform", "[Helpers][FFT]") {
+  SECTION("Real FFT computes non-redundant half of spectrum") {
+    std::vector<double> input_vector = {3.0, 1.0, 0.0, 0.0, 2.0};
+
+    std::vector<std::complex<double>> expected, output_vector;
+    numeric_utils::fft(input_vector, expected);
+    auto status = numeric_utils::real_fft(input_vector, output_vector);
+
+    REQUIRE(status);
+    REQUIRE(output_vector.size() == input_vector.size() / 2 + 1);
+    for (unsigned int i = 0; i < output_vector.size(); ++i) {
+      REQUIRE(std::abs(output_vector[i] - expected[i]) < 1E-10);
+    }
+
+    std::vector<double> recovered;
+    status = numeric_utils::inverse_real_fft(output_vector, recovered,
+                                             input_vector.size());
+
+    REQUIRE(status);
+    REQUIRE(recovered.size() == input_vector.size());
+    for (unsigned int i = 0; i < recovered.size(); ++i) {
+      REQUIRE(recovered[i] + 1.0 == Approx(input_vector[i] + 1.0).epsilon(0.01));
+    }
+
+    REQUIRE_THROWS_AS(
+        numeric_utils::inverse_real_fft(output_vector, recovered, 8),
+        std::runtime_error);
+  }
+
+  SECTION("Batch real FFT of rows and columns round trips") {
+    Eigen::MatrixXd signals(4, 6);
+    for (unsigned int i = 0; i < signals.rows(); ++i) {
+      for (unsigned int j = 0; j < signals.cols(); ++j) {
+        signals(i, j) = std::cos(0.3 * i * j) - 0.1 * i;
+      }
+    }
+
+    Eigen::MatrixXcd spectra;
+    Eigen::MatrixXd recovered;
+    REQUIRE(numeric_utils::real_fft_batch(signals, spectra, true));
+    REQUIRE(spectra.rows() == 4);
+    REQUIRE(spectra.cols() == 4);
+
+    Eigen::VectorXd row = signals.row(2);
+    Eigen::VectorXcd expected;
+    numeric_utils::fft(row, expected);
+    for (unsigned int j = 0; j < spectra.cols(); ++j) {
+      REQUIRE(std::abs(spectra(2, j) - expected(j)) < 1E-10);
+    }
+
+    REQUIRE(numeric_utils::inverse_real_fft_batch(spectra, recovered, 6, true));
+    REQUIRE((recovered - signals).cwiseAbs().maxCoeff() < 1E-10);
+
+    // Uncached batch plans give same result and are not added to cache
+    Eigen::MatrixXcd uncached_spectra;
+    std::size_t cached_plans = numeric_utils::FftPlanCache::instance()->size();
+    REQUIRE(numeric_utils::real_fft_batch(signals, uncached_spectra, true,
+                                          false));
+    REQUIRE(numeric_utils::inverse_real_fft_batch(uncached_spectra, recovered,
+                                                  6, true, false));
+    REQUIRE(numeric_utils::FftPlanCache::instance()->size() == cached_plans);
+    REQUIRE((uncached_spectra - spectra).cwiseAbs().maxCoeff() < 1E-12);
+    REQUIRE((recovered - signals).cwiseAbs().maxCoeff() < 1E-10);
+
+    REQUIRE(numeric_utils::real_fft_batch(signals, spectra));
+    REQUIRE(spectra.rows() == 3);
+    REQUIRE(spectra.cols() == 6);
+    REQUIRE(numeric_utils::inverse_real_fft_batch(spectra, recovered, 4));
+    REQUIRE((recovered - signals).cwiseAbs().maxCoeff() < 1E-10);
+  }
+}
+
+TEST_CASE("Test FFT plans and plan cache", "[Helpers][FFT]") {
+  SECTION("Plan cache returns same plan for same transform") {
+    auto cache = numeric_utils::FftPlanCache::instance();
+    auto forward_plan =
+        cache->get(16, numeric_utils::FftPlan::Direction::Forward);
+    auto same_plan = cache->get(16, numeric_utils::FftPlan::Direction::Forward);
+    auto backward_plan =
+        cache->get(16, numeric_utils::FftPlan::Direction::Backward);
+    auto different_length =
+        cache->get(32, numeric_utils::FftPlan::Direction::Forward);
+
+    REQUIRE(forward_plan == same_plan);
+    REQUIRE(forward_plan != backward_plan);
+    REQUIRE(forward_plan != different_length);
+    REQUIRE(forward_plan->length() == 16);
+    REQUIRE(backward_plan->direction() ==
+            numeric_utils::FftPlan::Direction::Backward);
+
+    // Plans held by callers stay valid after the cache is cleared
+    cache->clear();
+    REQUIRE(cache->size() == 0);
+    std::vector<std::complex<double>> input(16, {1.0, 0.0}), output(16);
+    REQUIRE(forward_plan->execute(input.data(), output.data()));
+    REQUIRE(real(output[0]) == Approx(16.0).epsilon(0.01));
+  }
+
+  SECTION("Plan cache stays within capacity") {
+    auto cache = numeric_utils::FftPlanCache::instance();
+    std::size_t default_capacity = cache->capacity();
+    cache->clear();
+    cache->set_capacity(2);
+
+    auto first_plan = cache->get(8, numeric_utils::FftPlan::Direction::Forward);
+    cache->get(16, numeric_utils::FftPlan::Direction::Forward);
+    // Use first plan again so second plan is least recently used
+    REQUIRE(cache->get(8, numeric_utils::FftPlan::Direction::Forward) ==
+            first_plan);
+    cache->get(32, numeric_utils::FftPlan::Direction::Forward);
+    REQUIRE(cache->size() == 2);
+    REQUIRE(cache->get(8, numeric_utils::FftPlan::Direction::Forward) ==
+            first_plan);
+
+    // Many distinct batch shapes never grow cache beyond capacity
+    for (std::size_t i = 1; i <= 10; ++i) {
+      cache->get(64, i, 1, 64, 1, 33,
+                 numeric_utils::FftPlan::Direction::Forward,
+                 numeric_utils::FftPlan::Domain::Real);
+      REQUIRE(cache->size() <= 2);
+    }
+
+    // Shrinking capacity evicts plans
+    cache->set_capacity(1);
+    REQUIRE(cache->size() == 1);
+
+    cache->set_capacity(default_capacity);
+    cache->clear();
+  }
+
+  SECTION("Explicit plan matches FFT and inverse FFT functions") {
+    std::vector<double> input_vector = {3.0, 1.0, 0.0, 0.0};
+    std::vector<std::complex<double>> expected;
+    numeric_utils::fft(input_vector, expected);
+
+    numeric_utils::FftPlan forward_plan(
+        input_vector.size(), numeric_utils::FftPlan::Direction::Forward);
+    std::vector<std::complex<double>> input_complex(input_vector.begin(),
+                                                    input_vector.end());
+    std::vector<std::complex<double>> output_vector(input_vector.size());
+    forward_plan.execute(input_complex.data(), output_vector.data());
+
+    for (unsigned int i = 0; i < expected.size(); ++i) {
+      REQUIRE(real(output_vector[i]) + 1.0 ==
+              Approx(real(expected[i]) + 1.0).epsilon(0.01));
+      REQUIRE(imag(output_vector[i]) + 1.0 ==
+              Approx(imag(expected[i]) + 1.0).epsilon(0.01));
+    }
+
+    // In place complex round trip recovers input
+    numeric_utils::FftPlan forward_inplace(
+        input_vector.size(), numeric_utils::FftPlan::Direction::Forward,
+        numeric_utils::FftPlan::Domain::Complex,
+        numeric_utils::FftPlan::Precision::Double,
+        numeric_utils::FftPlan::Placement::InPlace);
+    numeric_utils::FftPlan backward_inplace(
+        input_vector.size(), numeric_utils::FftPlan::Direction::Backward,
+        numeric_utils::FftPlan::Domain::Complex,
+        numeric_utils::FftPlan::Precision::Double,
+        numeric_utils::FftPlan::Placement::InPlace);
+    forward_inplace.execute(input_complex.data());
+    backward_inplace.execute(input_complex.data());
+
+    for (unsigned int i = 0; i < input_vector.size(); ++i) {
+      REQUIRE(real(input_complex[i]) + 1.0 ==
+              Approx(input_vector[i] + 1.0).epsilon(0.01));
+      REQUIRE(imag(input_complex[i]) + 1.0 == Approx(1.0).epsilon(0.01));
+    }
+  }
+}
+
+TEST_CASE("Test batched 1-D Fast Fourier Transforms", "[Helpers][FFT]") {
+  Eigen::MatrixXd signals(3, 8);
+  for (unsigned int i = 0; i < signals.rows(); ++i) {
+    for (unsigned int j = 0; j < signals.cols(); ++j) {
+      signals(i, j) = std::sin(1.0 + i * j) + 0.5 * j;
+    }
+  }
+
+  SECTION("Batch FFT of rows and columns matches single FFTs") {
+    Eigen::MatrixXcd row_spectra, col_spectra;
+    REQUIRE(numeric_utils::fft_batch(signals, row_spectra, true));
+    REQUIRE(numeric_utils::fft_batch(signals, col_spectra));
+    REQUIRE(row_spectra.rows() == signals.rows());
+    REQUIRE(col_spectra.cols() == signals.cols());
+
+    for (unsigned int i = 0; i < signals.rows(); ++i) {
+      Eigen::VectorXd row = signals.row(i);
+      Eigen::VectorXcd expected;
+      numeric_utils::fft(row, expected);
+      for (unsigned int j = 0; j < expected.size(); ++j) {
+        REQUIRE(std::abs(row_spectra(i, j) - expected(j)) < 1E-10);
+      }
+    }
+
+    for (unsigned int j = 0; j < signals.cols(); ++j) {
+      Eigen::VectorXd col = signals.col(j);
+      Eigen::VectorXcd expected;
+      numeric_utils::fft(col, expected);
+      for (unsigned int i = 0; i < expected.size(); ++i) {
+        REQUIRE(std::abs(col_spectra(i, j) - expected(i)) < 1E-10);
+      }
+    }
+  }
+
+  SECTION("Batch inverse FFT recovers signals") {
+    Eigen::MatrixXcd spectra;
+    Eigen::MatrixXd recovered;
+    numeric_utils::fft_batch(signals, spectra, true);
+    REQUIRE(numeric_utils::inverse_fft_batch(spectra, recovered, true));
+
+    REQUIRE(recovered.rows() == signals.rows());
+    REQUIRE(recovered.cols() == signals.cols());
+    REQUIRE((recovered - signals).cwiseAbs().maxCoeff() < 1E-10);
+
+    numeric_utils::fft_batch(signals, spectra);
+    REQUIRE(numeric_utils::inverse_fft_batch(spectra, recovered));
+    REQUIRE((recovered - signals).cwiseAbs().maxCoeff() < 1E-10);
+  }
+}
+
 TEST_CASE("Test polynomial curve fitting, derivatives, and evaluation",
           "[Helpers][Polynomial]") {
   SECTION("Fit polynomial with non-zero intercept--should be degree 0") {
@@ -311,3 +706,82 @@ TEST_CASE("Test polynomial curve fitting, derivatives, and evaluation",
     REQUIRE(evaluations[3] == Approx(170.0).epsilon(0.01));
   }    
 }
+
+TEST_CASE("Test counter-based random streams", "[Helpers][RandomStream]") {
+
+  SECTION("Test Philox4x32-10 known answers") {
+    // Known answer vectors from Random123 distribution
+    numeric_utils::RandomStream zero_stream(0);
+    REQUIRE(zero_stream() == 0x6627e8d5u);
+    REQUIRE(zero_stream() == 0xe169c58du);
+    REQUIRE(zero_stream() == 0xbc57ac4cu);
+    REQUIRE(zero_stream() == 0x9b00dbd8u);
+
+    numeric_utils::RandomStream max_stream(0xffffffffffffffffull, 0,
+                                           0xffffffffu, 0xffffffffu,
+                                           0xffffffffu);
+    max_stream.discard(4ull * 0xffffffffull);
+    REQUIRE(max_stream() == 0x408f276du);
+    REQUIRE(max_stream() == 0x41c83b0eu);
+    REQUIRE(max_stream() == 0xa20bc7c6u);
+    REQUIRE(max_stream() == 0x6d5451fdu);
+  }
+
+  SECTION("Test streams are reproducible and independent") {
+    numeric_utils::RandomStream stream_1(10, 1, 2, 3, 0);
+    numeric_utils::RandomStream stream_2(10, 1, 2, 3, 0);
+    numeric_utils::RandomStream other_sim(10, 1, 2, 4, 0);
+    numeric_utils::RandomStream other_model(10, 2, 2, 3, 0);
+    auto split_stream = stream_1.split(1);
+    numeric_utils::RandomStream other_stream(10, 1, 2, 3, 1);
+
+    unsigned int num_sim_matches = 0, num_model_matches = 0;
+    for (unsigned int i = 0; i < 100; ++i) {
+      auto value = stream_1();
+      REQUIRE(value == stream_2());
+      REQUIRE(split_stream() == other_stream());
+      if (value == other_sim()) ++num_sim_matches;
+      if (value == other_model()) ++num_model_matches;
+    }
+    REQUIRE(num_sim_matches == 0);
+    REQUIRE(num_model_matches == 0);
+  }
+
+  SECTION("Test skipping ahead in stream") {
+    numeric_utils::RandomStream sequential(5, 3);
+    numeric_utils::RandomStream skipped(5, 3);
+
+    for (unsigned int i = 0; i < 7; ++i) {
+      sequential();
+    }
+    skipped();
+    skipped.discard(6);
+    REQUIRE(sequential() == skipped());
+
+    for (unsigned int i = 0; i < 1000; ++i) {
+      sequential();
+    }
+    skipped.discard(1000);
+    REQUIRE(sequential() == skipped());
+  }
+
+  SECTION("Test uniform values") {
+    numeric_utils::RandomStream stream(42);
+    double sum = 0.0;
+    unsigned int num_values = 100000;
+    for (unsigned int i = 0; i < num_values; ++i) {
+      double value = stream.uniform();
+      REQUIRE(value >= 0.0);
+      REQUIRE(value < 1.0);
+      sum += value;
+    }
+    REQUIRE(sum / num_values == Approx(0.5).epsilon(0.01));
+
+    REQUIRE(numeric_utils::stream_id("VlachosEtAl") ==
+            numeric_utils::stream_id("VlachosEtAl"));
+    REQUIRE(numeric_utils::stream_id("VlachosEtAl") !=
+            numeric_utils::stream_id("WittigSinha"));
+    REQUIRE(numeric_utils::reserve_stream_seed() !=
+            numeric_utils::reserve_stream_seed());
+  }
+}
@@ -1,9 +1,11 @@
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
+#include "levenberg_marquardt.h"
 #include "nelder_mead.h"
 
 TEST_CASE("Test Nelder-Mead Optimization", "[Helpers][Optimization]") {
@@ -50,3 +52,53 @@ TEST_CASE("Test Nelder-Mead Optimization", "[Helpers][Optimization]") {
     REQUIRE(calced_min_location[1] == Approx(1.0).epsilon(0.01));
   }
 }
+
+TEST_CASE("Test Levenberg-Marquardt Optimization", "[Helpers][Optimization]") {
+
+  // Rosenbrock function as sum of squared residuals
+  optimization::LevenbergMarquardt::ResidualFunction rosenbrock =
+      [](const Eigen::VectorXd& point, Eigen::VectorXd& residuals,
+         Eigen::MatrixXd& jacobian) -> bool {
+    residuals.resize(2);
+    jacobian.resize(2, 2);
+    residuals << 1.0 - point(0), 10.0 * (point(1) - point(0) * point(0));
+    jacobian << -1.0, 0.0, -20.0 * point(0), 10.0;
+    return true;
+  };
+
+  SECTION("Test ability to optimize Rosenbrock function") {
+    optimization::LevenbergMarquardt optimizer(1e-10);
+
+    Eigen::VectorXd initial_point(2);
+    initial_point << -10.0, -1.0;
+
+    auto calced_min_location = optimizer.minimize(initial_point, rosenbrock);
+
+    REQUIRE(optimizer.get_minimum() + 1.0 == Approx(1.0).epsilon(1.0e-8));
+    REQUIRE(calced_min_location[0] == Approx(1.0).epsilon(1.0e-6));
+    REQUIRE(calced_min_location[1] == Approx(1.0).epsilon(1.0e-6));
+    REQUIRE(optimizer.get_num_iterations() < 100);
+  }
+
+  SECTION("Test points outside domain are rejected") {
+    optimization::LevenbergMarquardt optimizer(1e-10);
+
+    // Restrict domain to first coordinate less than 0.5
+    optimization::LevenbergMarquardt::ResidualFunction restricted =
+        [&rosenbrock](const Eigen::VectorXd& point, Eigen::VectorXd& residuals,
+                      Eigen::MatrixXd& jacobian) -> bool {
+      return point(0) < 0.5 && rosenbrock(point, residuals, jacobian);
+    };
+
+    Eigen::VectorXd initial_point(2);
+    initial_point << -1.0, 2.0;
+
+    auto calced_min_location = optimizer.minimize(initial_point, restricted);
+    REQUIRE(calced_min_location[0] < 0.5);
+    REQUIRE(calced_min_location[0] == Approx(0.5).epsilon(0.01));
+
+    initial_point << 1.0, 1.0;
+    optimizer.minimize(initial_point, restricted);
+    REQUIRE(optimizer.get_minimum() == std::numeric_limits<double>::infinity());
+  }
+}
@@ -0,0 +1,84 @@
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+#include "configure.h"
+#include "json_object.h"
+#include "profiler.h"
+#include "wittig_sinha.h"
+
+TEST_CASE("Test stage profiler", "[Helpers][Profiler]") {
+  auto profiler = utilities::Profiler::instance();
+
+  SECTION("Test stages accumulate counts and times") {
+    auto& stage = profiler->stage("ProfilerTest::accumulate");
+    REQUIRE(&profiler->stage("ProfilerTest::accumulate") == &stage);
+    stage.reset();
+
+    stage.add(2, 1000);
+    stage.add(3, 500);
+    REQUIRE(stage.count() == 5);
+    REQUIRE(stage.nanoseconds() == 1500);
+
+    bool found = false;
+    for (const auto& statistics : profiler->statistics()) {
+      if (statistics.name == "ProfilerTest::accumulate") {
+        found = true;
+        REQUIRE(statistics.count == 5);
+        REQUIRE(statistics.seconds == Approx(1.5E-6));
+      }
+    }
+    REQUIRE(found);
+
+    auto profile = profiler->to_json().get_library_json();
+    REQUIRE(profile["ProfilerTest::accumulate"]["count"] == 5);
+
+    // Stages without any counts are not reported
+    profiler->reset();
+    REQUIRE(stage.count() == 0);
+    REQUIRE(profiler->to_json().get_library_json().count(
+                "ProfilerTest::accumulate") == 0);
+  }
+
+  SECTION("Test scoped timers only record when enabled") {
+    auto& stage = profiler->stage("ProfilerTest::timer");
+    stage.reset();
+
+    { utilities::ScopedTimer timer(stage); }
+    REQUIRE(stage.count() == 0);
+
+    utilities::Profiler::set_enabled(true);
+    REQUIRE(utilities::Profiler::enabled());
+    { utilities::ScopedTimer timer(stage); }
+    { utilities::ScopedTimer timer(stage); }
+    utilities::Profiler::set_enabled(false);
+    REQUIRE(stage.count() == 2);
+  }
+
+#ifdef SMELT_ENABLE_PROFILING
+  SECTION("Test model stages are added to output") {
+    config::initialize();
+    stochastic::WittigSinha model("D", 30.0, 40.0, 2, 20.0, 100);
+
+    // Profile is only output when requested
+    auto output = model.generate("TestProfile").get_library_json();
+    REQUIRE(output.count("Profile") == 0);
+
+    profiler->reset();
+    utilities::Profiler::set_enabled(true);
+    model.set_profile_output(true);
+    output = model.generate("TestProfile").get_library_json();
+    utilities::Profiler::set_enabled(false);
+
+    REQUIRE(output["Events"].size() == 1);
+    REQUIRE(output["Profile"]["WittigSinha::gen_location_hists"]["count"] ==
+            1);
+    REQUIRE(output["Profile"]["WittigSinha::complex_random_numbers"]["count"] ==
+            1);
+    REQUIRE(output["Profile"]["MemoryRecordWriter::write_record"]["count"] ==
+            1);
+    REQUIRE(output["Profile"]["WittigSinha::gen_location_hists"]["seconds"]
+                .get<double>() > 0.0);
+  }
+#endif
+}
@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+#include "factory.h"
+#include "json_object.h"
+#include "record_writer.h"
+#include "stochastic_model.h"
+#include "vlachos_et_al.h"
+#include "wittig_sinha.h"
+
+namespace {
+// Read contents of file to string
+std::string read_file(const std::string& location) {
+  std::ifstream input(location);
+  std::stringstream contents;
+  contents << input.rdbuf();
+  return contents.str();
+}
+}  // namespace
+
+TEST_CASE("Test record writers", "[Helpers][Records]") {
+  // Event metadata and time series used for records
+  auto time_series = utilities::JsonObject();
+  time_series.add_value("name", "accel_x");
+  time_series.add_value("type", "Value");
+  time_series.add_value("dT", 0.01);
+  auto event = utilities::JsonObject();
+  event.add_value("name", "Event_1");
+  event.add_value("dT", 0.01);
+  event.add_value("numSteps", 3);
+  event.add_value("timeSeries", std::vector<utilities::JsonObject>{time_series});
+
+  std::vector<std::vector<double>> series{{0.1, -0.2, 1.0 / 3.0}};
+  auto header = utilities::JsonObject();
+  header.add_value("dT", 0.01);
+
+  SECTION("Test in-memory record writer") {
+    utilities::MemoryRecordWriter writer;
+    writer.write_header(header);
+    writer.write_record(event, series);
+    writer.write_record(event, series);
+    REQUIRE(writer.close());
+
+    auto output = writer.get_json().get_library_json();
+    REQUIRE(output["dT"] == 0.01);
+    REQUIRE(output["Events"].size() == 2);
+    REQUIRE(output["Events"][1]["name"] == "Event_1");
+    REQUIRE(output["Events"][1]["timeSeries"][0]["data"] ==
+            nlohmann::json(series[0]));
+
+    // Number of time series must match event metadata
+    std::vector<std::vector<double>> extra_series(2, series[0]);
+    REQUIRE_THROWS_AS(writer.write_record(event, extra_series),
+                      std::runtime_error);
+  }
+
+  SECTION("Test binary records in double and single precision") {
+    for (auto precision : {utilities::RecordPrecision::Double,
+                           utilities::RecordPrecision::Single}) {
+      {
+        utilities::BinaryRecordWriter writer("./test_records.bin", precision);
+        writer.write_header(header);
+        writer.write_record(event, series);
+        writer.write_record(event, std::vector<std::vector<double>>{
+                                       std::vector<double>(5, 2.0)});
+        REQUIRE(writer.num_records() == 2);
+        REQUIRE_THROWS_AS(writer.write_header(header), std::runtime_error);
+      }
+
+      utilities::BinaryRecordReader reader("./test_records.bin");
+      REQUIRE(reader.precision() == precision);
+      REQUIRE(reader.header() == header);
+
+      utilities::JsonObject read_event;
+      std::vector<std::vector<double>> read_series;
+      REQUIRE(reader.next(read_event, read_series));
+      REQUIRE(read_event == event);
+      REQUIRE(read_series.size() == 1);
+      REQUIRE(read_series[0].size() == 3);
+      double tolerance =
+          precision == utilities::RecordPrecision::Double ? 1e-15 : 1e-7;
+      for (unsigned int i = 0; i < series[0].size(); ++i) {
+        REQUIRE(std::abs(read_series[0][i] - series[0][i]) < tolerance);
+      }
+      // Values are aligned to 8 bytes for memory mapping
+      REQUIRE(reader.series_offsets()[0] % 8 == 0);
+
+      REQUIRE(reader.next(read_event, read_series));
+      REQUIRE(read_series[0] == std::vector<double>(5, 2.0));
+      REQUIRE(!reader.next(read_event, read_series));
+    }
+
+    std::remove("./test_records.bin");
+  }
+
+  SECTION("Test streaming JSON matches library output") {
+    // Header keys sorted before and after events, nested metadata and
+    // values that exercise number formatting
+    auto suite_header = utilities::JsonObject();
+    suite_header.add_value("A", std::vector<int>{1, 2});
+    suite_header.add_value("dT", 0.01);
+    suite_header.add_value("numSteps", 5);
+    auto nested_event = event;
+    nested_event.add_value("pattern",
+                           std::vector<utilities::JsonObject>{header, header});
+    nested_event.add_value("empty", std::vector<double>());
+    std::vector<std::vector<double>> values{
+        {1.0, -0.0, 1e-300, 123456789.125, 1.0 / 3.0,
+         std::numeric_limits<double>::quiet_NaN()}};
+
+    utilities::MemoryRecordWriter expected;
+    expected.write_header(suite_header);
+    expected.write_record(nested_event, values);
+    expected.write_record(event, series);
+    expected.get_json().write_to_file("./expected_records.json");
+
+    {
+      utilities::JsonRecordWriter writer("./streamed_records.json");
+      writer.write_header(suite_header);
+      writer.write_record(nested_event, values);
+      writer.write_record(event, series);
+      REQUIRE(writer.num_records() == 2);
+      REQUIRE_THROWS_AS(writer.write_header(header), std::runtime_error);
+    }
+    REQUIRE(read_file("./streamed_records.json") ==
+            read_file("./expected_records.json"));
+
+    // Compact output contains same values
+    {
+      utilities::JsonRecordWriter writer("./compact_records.json", false);
+      writer.write_header(suite_header);
+      writer.write_record(nested_event, values);
+      writer.write_record(event, series);
+    }
+    auto compact = read_file("./compact_records.json");
+    REQUIRE(compact.find(' ') == std::string::npos);
+    REQUIRE(nlohmann::json::parse(compact).dump() ==
+            expected.get_json().get_library_json().dump());
+
+    // Reduced precision output
+    {
+      utilities::JsonRecordWriter writer("./precision_records.json", false, 4);
+      writer.write_record(event, series);
+    }
+    auto reduced = nlohmann::json::parse(read_file("./precision_records.json"));
+    REQUIRE(reduced["Events"][0]["timeSeries"][0]["data"][2] == 0.3333);
+
+    // No records written
+    {
+      utilities::JsonRecordWriter writer("./empty_records.json");
+    }
+    utilities::MemoryRecordWriter empty;
+    empty.get_json().write_to_file("./expected_records.json");
+    REQUIRE(read_file("./empty_records.json") ==
+            read_file("./expected_records.json"));
+
+    std::remove("./expected_records.json");
+    std::remove("./streamed_records.json");
+    std::remove("./compact_records.json");
+    std::remove("./precision_records.json");
+    std::remove("./empty_records.json");
+  }
+
+  SECTION("Test streamed values match library number formatting") {
+    // Values at the limits of the shortest round-trip representation
+    std::vector<std::vector<double>> values{
+        {0.1 + 0.2, 100.0, -123.0, 1e16, 1e21, 1.5e-7, 1e-5, 5e-324,
+         std::numeric_limits<double>::max(),
+         std::numeric_limits<double>::min(),
+         -std::numeric_limits<double>::infinity()}};
+    std::mt19937_64 generator(25);
+    std::uniform_real_distribution<double> exponent(-300.0, 300.0);
+    std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+    for (unsigned int i = 0; i < 1000; ++i) {
+      values[0].push_back(mantissa(generator) *
+                          std::pow(10.0, exponent(generator)));
+    }
+
+    utilities::MemoryRecordWriter expected;
+    expected.write_record(event, values);
+    expected.get_json().write_to_file("./expected_records.json");
+    {
+      utilities::JsonRecordWriter writer("./streamed_records.json");
+      writer.write_record(event, values);
+    }
+    REQUIRE(read_file("./streamed_records.json") ==
+            read_file("./expected_records.json"));
+
+    std::remove("./expected_records.json");
+    std::remove("./streamed_records.json");
+  }
+
+  SECTION("Test trailing metadata matches library output") {
+    auto trailer = utilities::JsonObject();
+    trailer.add_value("Profile", header);
+
+    utilities::MemoryRecordWriter expected;
+    expected.write_header(header);
+    expected.write_record(event, series);
+    REQUIRE(expected.write_trailer(trailer));
+    REQUIRE(expected.get_json().get_library_json()["Profile"]["dT"] == 0.01);
+    expected.get_json().write_to_file("./expected_records.json");
+
+    {
+      utilities::JsonRecordWriter writer("./streamed_records.json");
+      writer.write_header(header);
+      writer.write_record(event, series);
+      REQUIRE(writer.write_trailer(trailer));
+      // Keys sorted before events can no longer be written
+      auto early_trailer = utilities::JsonObject();
+      early_trailer.add_value("A", 1);
+      REQUIRE_THROWS_AS(writer.write_trailer(early_trailer),
+                        std::runtime_error);
+    }
+    REQUIRE(read_file("./streamed_records.json") ==
+            read_file("./expected_records.json"));
+
+    // Binary format does not support trailing metadata
+    utilities::BinaryRecordWriter binary("./trailer_records.bin");
+    binary.write_record(event, series);
+    REQUIRE(!binary.write_trailer(trailer));
+    binary.close();
+
+    std::remove("./expected_records.json");
+    std::remove("./streamed_records.json");
+    std::remove("./trailer_records.bin");
+  }
+
+  SECTION("Test reading invalid file throws") {
+    auto json_file = utilities::JsonObject();
+    json_file.add_value("Events", 1);
+    json_file.write_to_file("./not_records.json");
+    REQUIRE_THROWS_AS(utilities::BinaryRecordReader("./not_records.json"),
+                      std::runtime_error);
+    std::remove("./not_records.json");
+
+    // Files written on a host with other byte order have reversed mark
+    {
+      utilities::BinaryRecordWriter writer("./swapped_records.bin");
+      writer.write_header(header);
+      writer.write_record(event, series);
+    }
+    std::string contents = read_file("./swapped_records.bin");
+    std::reverse(contents.begin() + 8, contents.begin() + 16);
+    {
+      std::ofstream output("./swapped_records.bin", std::ios::binary);
+      output << contents;
+    }
+    REQUIRE_THROWS_AS(utilities::BinaryRecordReader("./swapped_records.bin"),
+                      std::runtime_error);
+    std::remove("./swapped_records.bin");
+  }
+}
+
+TEST_CASE("Test streaming model output", "[Helpers][Records][Stochastic]") {
+  stochastic::VlachosEtAl model(6.5, 30.0, 500.0, 30.0, 2, 2, 15);
+
+  auto expected = model.generate("Stream").get_library_json();
+
+  {
+    utilities::BinaryRecordWriter writer("./test_model_records.bin");
+    REQUIRE(model.generate("Stream", writer));
+  }
+
+  utilities::BinaryRecordReader reader("./test_model_records.bin");
+  utilities::JsonObject event;
+  std::vector<std::vector<double>> series;
+  unsigned int num_events = 0;
+
+  while (reader.next(event, series)) {
+    auto event_json = event.get_library_json();
+    const auto& expected_event = expected["Events"][num_events];
+    REQUIRE(event_json["name"] == expected_event["name"]);
+    REQUIRE(event_json["numSteps"] == expected_event["numSteps"]);
+    REQUIRE(series.size() == 2);
+    REQUIRE(nlohmann::json(series[0]) ==
+            expected_event["timeSeries"][0]["data"]);
+    REQUIRE(nlohmann::json(series[1]) ==
+            expected_event["timeSeries"][1]["data"]);
+    ++num_events;
+  }
+
+  REQUIRE(num_events == 4);
+  std::remove("./test_model_records.bin");
+
+  // Streamed JSON files should match library output of generated events
+  const std::string streamed_location = "./streamed_model.json";
+  model.generate("Stream").write_to_file("./expected_model.json");
+  model.generate("Stream", streamed_location);
+  REQUIRE(read_file("./streamed_model.json") ==
+          read_file("./expected_model.json"));
+
+  stochastic::WittigSinha wind_model("B", 30.0, 40.0, 3, 50.0, 20);
+  wind_model.generate("Wind").write_to_file("./expected_model.json");
+  wind_model.generate("Wind", streamed_location);
+  REQUIRE(read_file("./streamed_model.json") ==
+          read_file("./expected_model.json"));
+
+  std::remove("./expected_model.json");
+  std::remove("./streamed_model.json");
+}
+
+TEST_CASE("Test sharded model output", "[Helpers][Records][Stochastic]") {
+  int seed = 25;
+  unsigned int num_shards = 3;
+  stochastic::VlachosEtAl full_model(6.5, 30.0, 500.0, 30.0, 2, 2, seed);
+  const std::string full_location = "./full_suite.json";
+  full_model.generate("Shard", full_location);
+
+  std::vector<std::string> json_shards, binary_shards;
+  unsigned int previous_end = 0;
+  for (unsigned int i = 0; i < num_shards; ++i) {
+    auto shard_model =
+        Factory<stochastic::StochasticModel, double, double, double, double,
+                unsigned int, unsigned int, int, unsigned int,
+                unsigned int>::instance()
+            ->create("VlachosSiteSpecificEQ", std::move(6.5), std::move(30.0),
+                     std::move(500.0), std::move(30.0), std::move(2),
+                     std::move(2), std::move(seed), std::move(i),
+                     std::move(num_shards));
+    REQUIRE(shard_model->shard_id() == i);
+    REQUIRE(shard_model->num_shards() == num_shards);
+    REQUIRE(shard_model->shard_begin() == previous_end);
+    previous_end = shard_model->shard_end();
+
+    json_shards.push_back("./shard_" + std::to_string(i) + ".json");
+    shard_model->generate("Shard", json_shards.back());
+    binary_shards.push_back("./shard_" + std::to_string(i) + ".bin");
+    utilities::BinaryRecordWriter writer(binary_shards.back());
+    shard_model->generate("Shard", writer);
+  }
+  REQUIRE(previous_end == full_model.num_records());
+
+  // Shard sizes differ by at most one record
+  auto shard_records =
+      nlohmann::json::parse(read_file(json_shards[0]))["Events"];
+  REQUIRE(shard_records.size() == 1);
+
+  // Merged JSON shards match single process output
+  REQUIRE(utilities::merge_json_records(json_shards, "./merged_suite.json"));
+  REQUIRE(read_file("./merged_suite.json") == read_file(full_location));
+  std::remove("./merged_suite.json");
+
+  // Merged binary shards match single process output
+  {
+    REQUIRE(
+        utilities::merge_binary_records(binary_shards, "./merged_suite.bin"));
+    auto expected = nlohmann::json::parse(read_file(full_location))["Events"];
+
+    utilities::BinaryRecordReader reader("./merged_suite.bin");
+    utilities::JsonObject event;
+    std::vector<std::vector<double>> series;
+    unsigned int num_events = 0;
+    while (reader.next(event, series)) {
+      auto record = event.get_library_json();
+      record["timeSeries"][0]["data"] = series[0];
+      record["timeSeries"][1]["data"] = series[1];
+      REQUIRE(record == expected[num_events]);
+      ++num_events;
+    }
+    REQUIRE(num_events == expected.size());
+    std::remove("./merged_suite.bin");
+  }
+
+  // Profiling statistics of shards are summed rather than compared
+  {
+    std::vector<std::string> profiled_shards;
+    for (unsigned int i = 0; i < 2; ++i) {
+      profiled_shards.push_back("./profiled_shard_" + std::to_string(i) +
+                                ".json");
+      utilities::JsonRecordWriter writer(profiled_shards.back());
+      writer.write_header(utilities::JsonObject(
+          nlohmann::json{{"Model", "Test"}}));
+      writer.write_record(
+          utilities::JsonObject(nlohmann::json{
+              {"name", "Event" + std::to_string(i)},
+              {"timeSeries", nlohmann::json::array({{{"name", "x"}}})}}),
+          std::vector<std::vector<double>>{{1.0 + i, 2.0}});
+      nlohmann::json stages;
+      stages["Shared"] = {{"count", 2 + i}, {"seconds", 0.5 + i}};
+      stages["Stage" + std::to_string(i)] = {{"count", 1}, {"seconds", 0.25}};
+      writer.write_trailer(utilities::JsonObject(
+          nlohmann::json{{"Profile", stages}}));
+      REQUIRE(writer.close());
+    }
+
+    REQUIRE(
+        utilities::merge_json_records(profiled_shards, "./merged_suite.json"));
+    auto merged = nlohmann::json::parse(read_file("./merged_suite.json"));
+    REQUIRE(merged["Events"].size() == 2);
+    REQUIRE(merged["Model"] == "Test");
+    auto profile = merged["Profile"];
+    REQUIRE(profile.size() == 3);
+    REQUIRE(profile["Shared"]["count"] == 5);
+    REQUIRE(profile["Shared"]["seconds"].get<double>() == Approx(2.0));
+    REQUIRE(profile["Stage0"]["count"] == 1);
+    REQUIRE(profile["Stage1"]["seconds"].get<double>() == Approx(0.25));
+
+    // Shards without profiles are merged without one
+    REQUIRE(utilities::merge_json_records(
+        std::vector<std::string>{json_shards[0], json_shards[1]},
+        "./merged_suite.json"));
+    REQUIRE(nlohmann::json::parse(read_file("./merged_suite.json"))
+                .count("Profile") == 0);
+
+    for (const auto& location : profiled_shards) {
+      std::remove(location.c_str());
+    }
+    std::remove("./merged_suite.json");
+  }
+
+  // Invalid shards and mismatched inputs throw
+  {
+    REQUIRE_THROWS_AS(full_model.set_shard(4, 4), std::runtime_error);
+    REQUIRE_THROWS_AS(full_model.set_shard(0, 0), std::runtime_error);
+
+    // Wind events have different header metadata than seismic events
+    stochastic::WittigSinha wind_model("B", 30.0, 40.0, 3, 50.0, 20);
+    const std::string wind_location = "./wind_shard.json";
+    wind_model.generate("Wind", wind_location);
+    REQUIRE_THROWS_AS(
+        utilities::merge_json_records(
+            std::vector<std::string>{json_shards[0], wind_location},
+            "./merged_suite.json"),
+        std::runtime_error);
+    REQUIRE_THROWS_AS(utilities::merge_json_records(std::vector<std::string>(),
+                                                    "./merged_suite.json"),
+                      std::runtime_error);
+    std::remove(wind_location.c_str());
+    std::remove("./merged_suite.json");
+  }
+
+  for (unsigned int i = 0; i < num_shards; ++i) {
+    std::remove(json_shards[i].c_str());
+    std::remove(binary_shards[i].c_str());
+  }
+  std::remove(full_location.c_str());
+}
@@ -1,4 +1,5 @@
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <catch2/catch.hpp>
@@ -148,7 +149,208 @@ TEST_CASE("Test Vlachos et al. (2018) implementation", "[Stochastic][Seismic]")
 
     REQUIRE(json1["Events"][0]["timeSeries"][0]["data"] ==
             json2["Events"][0]["timeSeries"][0]["data"]);
-  }  
+  }
+
+  SECTION("Test time history synthesis matches direct summation") {
+    stochastic::VlachosEtAl seeded_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 1, 1, 50);
+    Eigen::MatrixXd power_spectrum = Eigen::MatrixXd::Random(500, 200).cwiseAbs();
+    numeric_utils::RandomStream random_stream(50, 3);
+    auto reference_stream = random_stream;
+
+    std::vector<double> time_history;
+    seeded_model.simulate_time_history(time_history, power_spectrum,
+                                       random_stream);
+    REQUIRE(time_history.size() == 500);
+
+    // Direct evaluation of Eq-19 with same phase angles
+    std::vector<double> phase_angles(power_spectrum.cols());
+    for (auto& angle : phase_angles) {
+      angle = 2.0 * M_PI * reference_stream.uniform();
+    }
+
+    for (unsigned int i = 0; i < time_history.size(); ++i) {
+      double expected = 0.0;
+      for (unsigned int j = 0; j < phase_angles.size(); ++j) {
+        expected += std::sqrt(power_spectrum(i, j)) *
+                    std::cos(j * 0.2 * i * 0.01 + phase_angles[j]);
+      }
+      expected = 2.0 * std::sqrt(0.2) * expected;
+      REQUIRE(std::abs(time_history[i] - expected) < 1e-10);
+    }
+  }
+
+  SECTION("Test amplitude spectrum matches power spectrum") {
+    stochastic::VlachosEtAl seeded_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 1, 1, 50);
+    Eigen::VectorXd parameters(18);
+    parameters << 0.47, 2.37, 5.41, -0.27, 0.86, 11.7, -0.26, 1.07, 0.25,
+        0.32, 0.31, 0.27, 0.55, 0.50, 0.82, 0.27, 1163.0, 36.5;
+    // Use identified parameters so no further samples are drawn
+    parameters = seeded_model.identify_parameters(parameters);
+
+    Eigen::MatrixXd power_spectrum;
+    numeric_utils::RowMatrixXd amplitudes;
+    std::vector<double> impulse_response, amplitude_impulse_response;
+    seeded_model.power_spectrum_and_filter(parameters, power_spectrum,
+                                           impulse_response);
+    seeded_model.amplitude_spectrum_and_filter(parameters, amplitudes,
+                                               amplitude_impulse_response);
+
+    REQUIRE(amplitudes.rows() == power_spectrum.rows());
+    REQUIRE(amplitudes.cols() == power_spectrum.cols());
+    REQUIRE(amplitude_impulse_response == impulse_response);
+    Eigen::MatrixXd expected =
+        2.0 * std::sqrt(0.2) * power_spectrum.array().sqrt();
+    REQUIRE(amplitudes.isApprox(expected, 1e-14));
+
+    // Realizations from shared amplitudes match simulation from power
+    // spectrum
+    numeric_utils::RandomStream random_stream(50, 3);
+    auto amplitude_stream = random_stream;
+    std::vector<double> time_history, amplitude_history;
+    seeded_model.simulate_time_history(time_history, power_spectrum,
+                                       random_stream);
+    seeded_model.synthesize_time_history(amplitude_history, amplitudes,
+                                         amplitude_stream);
+    REQUIRE(amplitude_history == time_history);
+
+    // Single precision synthesis draws the same phase angles
+    numeric_utils::RandomStream single_stream(50, 3);
+    std::vector<double> single_history;
+    seeded_model.synthesize_time_history(
+        single_history, numeric_utils::RowMatrixXf(amplitudes.cast<float>()),
+        single_stream);
+    REQUIRE(single_history.size() == time_history.size());
+    double max_accel = 0.0;
+    for (double value : time_history) {
+      max_accel = std::max(max_accel, std::abs(value));
+    }
+    for (unsigned int i = 0; i < time_history.size(); ++i) {
+      REQUIRE(std::abs(single_history[i] - time_history[i]) <
+              1.0E-4 * max_accel);
+    }
+  }
+
+  SECTION("Test single precision records") {
+    int seed = 25;
+    stochastic::VlachosEtAl model(moment_magnitude, rupture_dist, vs30,
+                                  orientation, 1, 2, seed);
+    REQUIRE(model.precision() == utilities::RecordPrecision::Double);
+    auto double_events =
+        model.generate("TestHistory").get_library_json()["Events"];
+    model.set_precision(utilities::RecordPrecision::Single);
+    auto single_events =
+        model.generate("TestHistory").get_library_json()["Events"];
+    REQUIRE(single_events.size() == double_events.size());
+
+    for (unsigned int i = 0; i < single_events.size(); ++i) {
+      for (unsigned int j = 0; j < 2; ++j) {
+        std::vector<double> single_data =
+            single_events[i]["timeSeries"][j]["data"];
+        std::vector<double> double_data =
+            double_events[i]["timeSeries"][j]["data"];
+        REQUIRE(single_data.size() == double_data.size());
+        double max_accel = 0.0;
+        for (double value : double_data) {
+          max_accel = std::max(max_accel, std::abs(value));
+        }
+        for (unsigned int k = 0; k < single_data.size(); ++k) {
+          // Records are exactly representable as 32-bit floats
+          REQUIRE(static_cast<double>(static_cast<float>(single_data[k])) ==
+                  single_data[k]);
+          REQUIRE(std::abs(single_data[k] - double_data[k]) <
+                  1.0E-4 * max_accel);
+        }
+      }
+    }
+
+    // Records generated on demand match full suite in single precision
+    utilities::JsonObject event;
+    std::vector<std::vector<double>> series;
+    model.generate_record("TestHistory", 1, event, series);
+    auto record = event.get_library_json();
+    record["timeSeries"][0]["data"] = series[0];
+    record["timeSeries"][1]["data"] = series[1];
+    REQUIRE(record == single_events[1]);
+  }
+
+  SECTION("Test time histories are independent of number of threads") {
+    int seed = 25;
+    stochastic::VlachosEtAl serial_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 2, 3, seed);
+    stochastic::VlachosEtAl parallel_model(moment_magnitude, rupture_dist,
+                                           vs30, orientation, 2, 3, seed);
+    serial_model.set_num_threads(1);
+    parallel_model.set_num_threads(4);
+    REQUIRE(parallel_model.num_threads() == 4);
+
+    auto serial_json =
+        serial_model.generate("TestHistory").get_library_json();
+    auto parallel_json =
+        parallel_model.generate("TestHistory").get_library_json();
+
+    REQUIRE(serial_json["Events"].size() == 6);
+    REQUIRE(serial_json == parallel_json);
+
+    // Realizations for the same spectrum should differ from one another
+    REQUIRE(serial_json["Events"][0]["timeSeries"][0]["data"] !=
+            serial_json["Events"][1]["timeSeries"][0]["data"]);
+  }
+
+  SECTION("Test records generated on demand match full suite") {
+    int seed = 25;
+    stochastic::VlachosEtAl model(moment_magnitude, rupture_dist, vs30,
+                                  orientation, 2, 3, seed);
+    REQUIRE(model.num_records() == 6);
+    auto events = model.generate("TestHistory").get_library_json()["Events"];
+
+    // Request records out of order
+    utilities::JsonObject event;
+    std::vector<std::vector<double>> series;
+    for (unsigned int i : {4, 1, 5, 0, 3, 2}) {
+      model.generate_record("TestHistory", i, event, series);
+      auto record = event.get_library_json();
+      REQUIRE(series.size() == 2);
+      record["timeSeries"][0]["data"] = series[0];
+      record["timeSeries"][1]["data"] = series[1];
+      REQUIRE(record == events[i]);
+    }
+
+    REQUIRE_THROWS_AS(model.generate_record("TestHistory", 6, event, series),
+                      std::runtime_error);
+  }
+
+  SECTION("Test tabulated marginal inverse CDFs match exact transform") {
+    int seed = 25;
+    stochastic::VlachosEtAl exact_model(moment_magnitude, rupture_dist, vs30,
+                                        orientation, 2, 1, seed);
+    stochastic::VlachosEtAl tabulated_model(moment_magnitude, rupture_dist,
+                                            vs30, orientation, 2, 1, seed);
+    REQUIRE(tabulated_model.quantile_tolerance() == 0.0);
+    REQUIRE_THROWS_AS(tabulated_model.set_quantile_tolerance(0.0),
+                      std::runtime_error);
+    tabulated_model.set_quantile_tolerance(1.0e-10);
+    REQUIRE(tabulated_model.quantile_tolerance() == 1.0e-10);
+
+    auto exact_events =
+        exact_model.generate("TestHistory").get_library_json()["Events"];
+    auto tabulated_events =
+        tabulated_model.generate("TestHistory").get_library_json()["Events"];
+
+    REQUIRE(tabulated_events.size() == exact_events.size());
+    for (unsigned int i = 0; i < exact_events.size(); ++i) {
+      auto exact_data =
+          exact_events[i]["timeSeries"][0]["data"].get<std::vector<double>>();
+      auto tabulated_data = tabulated_events[i]["timeSeries"][0]["data"]
+                                .get<std::vector<double>>();
+      REQUIRE(tabulated_data.size() == exact_data.size());
+      for (unsigned int j = 0; j < exact_data.size(); ++j) {
+        REQUIRE(tabulated_data[j] ==
+                Approx(exact_data[j]).epsilon(1.0e-6).margin(1.0e-8));
+      }
+    }
+  }
 }
 
 TEST_CASE("Test Wittig & Sinha (1975) implementation", "[Stochastic][Wind]") {
@@ -211,6 +413,23 @@ TEST_CASE("Test Wittig & Sinha (1975) implementation", "[Stochastic][Wind]") {
     REQUIRE(time_histories_json);
   }
 
+  SECTION("Test batch location time histories match single location") {
+    auto random_numbers = test_wittig_sinha.complex_random_numbers();
+
+    auto location_hists =
+        test_wittig_sinha.gen_location_hists(random_numbers, true);
+
+    REQUIRE(location_hists.size() == static_cast<unsigned int>(random_numbers.cols()));
+    for (unsigned int j = 0; j < random_numbers.cols(); ++j) {
+      auto location_hist =
+          test_wittig_sinha.gen_location_hist(random_numbers, j, true);
+      REQUIRE(location_hists[j].size() == location_hist.size());
+      for (unsigned int i = 0; i < location_hist.size(); ++i) {
+        REQUIRE(std::abs(location_hists[j][i] - location_hist[i]) < 1E-10);
+      }
+    }
+  }
+
   SECTION("Test different constructors") {
     REQUIRE_NOTHROW(Factory<stochastic::StochasticModel, std::string, double,
                             double, unsigned int, double>::instance()
@@ -247,6 +466,25 @@ TEST_CASE("Test Wittig & Sinha (1975) implementation", "[Stochastic][Wind]") {
                      std::move(200.0), std::move(25)));
   }
 
+  SECTION("Test record generated on demand matches full suite") {
+    stochastic::WittigSinha model("D", 30.0, 123.0, 8, 200.0, 100);
+    REQUIRE(model.num_records() == 1);
+    auto events = model.generate("Wind").get_library_json()["Events"];
+
+    utilities::JsonObject event;
+    std::vector<std::vector<double>> series;
+    model.generate_record("Wind", 0, event, series);
+    auto record = event.get_library_json();
+    REQUIRE(series.size() == 8);
+    for (unsigned int i = 0; i < series.size(); ++i) {
+      record["timeSeries"][i]["data"] = series[i];
+    }
+    REQUIRE(record == events[0]);
+
+    REQUIRE_THROWS_AS(model.generate_record("Wind", 1, event, series),
+                      std::runtime_error);
+  }
+
   SECTION("Test that when seed provided subsequent runs are identical") {
     auto run1 = Factory<stochastic::StochasticModel, std::string, double,
                         double, unsigned int, double, int>::instance()
@@ -387,6 +625,34 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     test_model.transform_parameters_from_normal_space(false, nopulse_params);
   }
 
+  SECTION("Test tabulated marginal inverse CDFs match exact transform") {
+    stochastic::DabaghiDerKiureghian tabulated_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, num_sims, num_realizations,
+        truncate);
+    REQUIRE_THROWS_AS(tabulated_model.set_quantile_tolerance(-1.0),
+                      std::runtime_error);
+    tabulated_model.set_quantile_tolerance(1.0e-10);
+    REQUIRE(tabulated_model.quantile_tolerance() == 1.0e-10);
+
+    for (bool pulse_like : {true, false}) {
+      Eigen::VectorXd mean_params =
+          test_model.compute_transformed_model_parameters(pulse_like);
+      for (double offset : {-2.5, -1.0, 0.0, 0.5, 2.0}) {
+        Eigen::VectorXd exact_params = mean_params.array() + offset;
+        Eigen::VectorXd tabulated_params = exact_params;
+        test_model.transform_parameters_from_normal_space(pulse_like,
+                                                          exact_params);
+        tabulated_model.transform_parameters_from_normal_space(
+            pulse_like, tabulated_params);
+        for (unsigned int i = 0; i < exact_params.size(); ++i) {
+          REQUIRE(tabulated_params(i) ==
+                  Approx(exact_params(i)).epsilon(1.0e-8).margin(1.0e-10));
+        }
+      }
+    }
+  }
+
   SECTION("Test model parameter simulation") {
 
     auto pulse_params = test_model.simulate_model_parameters(true, 20);
@@ -419,6 +685,72 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     REQUIRE(backcalced_params(1) == Approx(0.0970).epsilon(0.01));
     REQUIRE(backcalced_params(2) == Approx(5.7577).epsilon(0.01));
     REQUIRE(backcalced_params(3) == Approx(0.0324).epsilon(0.01));
+
+    auto reference_params = test_model.backcalculate_modulating_params(
+        params, 1.7, stochastic::ModulatingFitMode::NelderMead);
+    for (unsigned int i = 0; i < 4; ++i) {
+      REQUIRE(backcalced_params(i) ==
+              Approx(reference_params(i)).epsilon(1.0e-4));
+    }
+  }
+
+  SECTION("Test Levenberg-Marquardt backcalculation matches Nelder-Mead") {
+    // Check analytic derivatives of residuals, with points before and after
+    // t_max_q
+    Eigen::VectorXd point(3);
+    point << 2.0, 0.3, 6.0;
+    Eigen::VectorXd residuals, perturbed_residuals;
+    Eigen::MatrixXd jacobian, perturbed_jacobian;
+    REQUIRE(test_model.calc_parameter_residuals(point, 2.0, 4.0, 12.0, 1.0,
+                                                residuals, jacobian));
+    REQUIRE(residuals.squaredNorm() ==
+            Approx(test_model.calc_parameter_error({2.0, 0.3, 6.0}, 2.0, 4.0,
+                                                   12.0, 1.0)));
+    for (unsigned int i = 0; i < 3; ++i) {
+      Eigen::VectorXd perturbed_point = point;
+      perturbed_point(i) += 1.0e-7;
+      test_model.calc_parameter_residuals(perturbed_point, 2.0, 4.0, 12.0, 1.0,
+                                          perturbed_residuals,
+                                          perturbed_jacobian);
+      for (unsigned int j = 0; j < 3; ++j) {
+        REQUIRE((perturbed_residuals(j) - residuals(j)) / 1.0e-7 ==
+                Approx(jacobian(j, i)).epsilon(1.0e-4).margin(1.0e-6));
+      }
+    }
+
+    // Points outside domain of modulating function are rejected
+    point << 2.0, -0.3, 6.0;
+    REQUIRE(!test_model.calc_parameter_residuals(point, 2.0, 4.0, 12.0, 1.0,
+                                                 residuals, jacobian));
+
+    // Targets that can't be matched exactly have flat valleys of minima, so
+    // fits are compared by their error measures
+    auto nopulse_params = test_model.simulate_model_parameters(false, 10);
+    for (unsigned int i = 0; i < nopulse_params.rows(); ++i) {
+      for (unsigned int j = 0; j < 2; ++j) {
+        Eigen::VectorXd q_params = nopulse_params.row(i).segment(7 * j, 4);
+        auto fit_params = test_model.backcalculate_modulating_params(q_params);
+        auto reference_params = test_model.backcalculate_modulating_params(
+            q_params, 0.0, stochastic::ModulatingFitMode::NelderMead);
+
+        double d05 = q_params(2), d030 = q_params(3),
+               d095 = q_params(2) + q_params(1);
+        double fit_error = test_model.calc_parameter_error(
+            {fit_params(0), fit_params(1), fit_params(2)}, d05, d030, d095,
+            0.0);
+        double reference_error = test_model.calc_parameter_error(
+            {reference_params(0), reference_params(1), reference_params(2)},
+            d05, d030, d095, 0.0);
+
+        REQUIRE(fit_error <= reference_error * (1.0 + 1.0e-6) + 1.0e-10);
+        if (reference_error < 1.0e-10) {
+          for (unsigned int k = 0; k < 4; ++k) {
+            REQUIRE(fit_params(k) ==
+                    Approx(reference_params(k)).epsilon(1.0e-4));
+          }
+        }
+      }
+    }
   }
 
   SECTION("Test modulating function, time-to-intensity, linear filter, and "
@@ -470,6 +802,60 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
             Approx(expected_response.lpNorm<2>()).epsilon(0.01));
   }
 
+  SECTION("Test truncated impulse response filter matches dense reference") {
+    unsigned int num_steps = 1500;
+    std::vector<double> frequency_filter(num_steps);
+    for (unsigned int i = 0; i < num_steps; ++i) {
+      frequency_filter[i] =
+          2.0 * M_PI * (i < 300 ? 8.0 : (i < 1200 ? 8.0 - 0.007 * (i - 300) : 1.7));
+    }
+
+    Eigen::MatrixXd white_noise(3, num_steps);
+    for (unsigned int i = 0; i < white_noise.rows(); ++i) {
+      for (unsigned int j = 0; j < num_steps; ++j) {
+        white_noise(i, j) = std::sin(12.9898 * (j + 1) + 78.233 * i) * 43758.5453;
+        white_noise(i, j) -= std::floor(white_noise(i, j)) + 0.5;
+      }
+    }
+
+    for (double zeta : {0.1, 0.5, 0.9}) {
+      auto dense = test_model.filter_white_noise(
+          white_noise, frequency_filter, zeta,
+          stochastic::ImpulseResponseMode::Dense);
+      auto truncated = test_model.filter_white_noise(
+          white_noise, frequency_filter, zeta,
+          stochastic::ImpulseResponseMode::Truncated);
+
+      REQUIRE(truncated.rows() == dense.rows());
+      REQUIRE(truncated.cols() == dense.cols());
+      REQUIRE((truncated - dense).cwiseAbs().maxCoeff() <
+              1.0E-8 * dense.cwiseAbs().maxCoeff());
+    }
+  }
+
+  SECTION("Test single precision impulse response filter") {
+    unsigned int num_steps = 1500;
+    std::vector<double> frequency_filter(num_steps, 2.0 * M_PI * 5.0);
+    Eigen::MatrixXd white_noise(2, num_steps);
+    for (unsigned int i = 0; i < white_noise.rows(); ++i) {
+      for (unsigned int j = 0; j < num_steps; ++j) {
+        white_noise(i, j) = std::sin(12.9898 * (j + 1) + 78.233 * i) * 43758.5453;
+        white_noise(i, j) -= std::floor(white_noise(i, j)) + 0.5;
+      }
+    }
+
+    auto double_filtered =
+        test_model.filter_white_noise(white_noise, frequency_filter, 0.3);
+    test_model.set_precision(utilities::RecordPrecision::Single);
+    auto single_filtered =
+        test_model.filter_white_noise(white_noise, frequency_filter, 0.3);
+
+    REQUIRE(single_filtered.rows() == double_filtered.rows());
+    REQUIRE(single_filtered.cols() == double_filtered.cols());
+    REQUIRE((single_filtered - double_filtered).cwiseAbs().maxCoeff() <
+            1.0E-5 * double_filtered.cwiseAbs().maxCoeff());
+  }
+
   SECTION("Test acceleration filter") {
     double freq_corner = std::pow(10, 1.4071 - 0.3452 * moment_magnitude);
     unsigned int filter_order = 4;
@@ -488,6 +874,24 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     REQUIRE(filtered_accel[3] == Approx(expected_accel[3]).epsilon(0.01));
     REQUIRE(filtered_accel[4] == Approx(expected_accel[4]).epsilon(0.01));
     REQUIRE(filtered_accel[5] == Approx(expected_accel[5]).epsilon(0.01));    
+
+    // Filtering rows of matrix in batch should match filtering each row
+    Eigen::MatrixXd accels(2, 6);
+    accels.row(0) = accel;
+    accels.row(1) = -2.0 * accel.reverse();
+
+    auto filtered_accels =
+        test_model.filter_acceleration_batch(accels, freq_corner, filter_order);
+
+    REQUIRE(filtered_accels.size() == 2);
+    for (unsigned int i = 0; i < filtered_accels.size(); ++i) {
+      Eigen::VectorXd row = accels.row(i);
+      auto expected = test_model.filter_acceleration(row, freq_corner, filter_order);
+      REQUIRE(filtered_accels[i].size() == expected.size());
+      for (unsigned int j = 0; j < expected.size(); ++j) {
+        REQUIRE(std::abs(filtered_accels[i][j] - expected[j]) < 1E-10);
+      }
+    }
   }
 
   SECTION("Test pulse acceleration calculation") {
@@ -515,4 +919,76 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
   SECTION("Test JSON generation") {
     bool success = test_model.generate("BlahBlah", "./dabaghi_test.json", true);
   }
+
+  SECTION("Test records generated on demand match full suite") {
+    int seed = 10;
+    stochastic::DabaghiDerKiureghian suite_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 1, num_realizations,
+        truncate, seed);
+    stochastic::DabaghiDerKiureghian record_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 1, num_realizations,
+        truncate, seed);
+    REQUIRE(record_model.num_records() == 2);
+    auto events = suite_model.generate("Test", true).get_library_json()["Events"];
+
+    utilities::JsonObject event;
+    std::vector<std::vector<double>> series;
+    for (unsigned int i = 0; i < record_model.num_records(); ++i) {
+      record_model.generate_record("Test", i, event, series, true);
+      auto record = event.get_library_json();
+      REQUIRE(series.size() == 2);
+      record["timeSeries"][0]["data"] = series[0];
+      record["timeSeries"][1]["data"] = series[1];
+      REQUIRE(record == events[i]);
+    }
+
+    // Records remain the same when requested again
+    std::vector<std::vector<double>> repeat_series;
+    record_model.generate_record("Test", 0, event, repeat_series, true);
+    REQUIRE(repeat_series[0] ==
+            events[0]["timeSeries"][0]["data"].get<std::vector<double>>());
+
+    // Records requested from the instance that generated the suite, in
+    // reverse order, match the suite
+    for (unsigned int i = suite_model.num_records(); i > 0; --i) {
+      suite_model.generate_record("Test", i - 1, event, series, true);
+      auto record = event.get_library_json();
+      record["timeSeries"][0]["data"] = series[0];
+      record["timeSeries"][1]["data"] = series[1];
+      REQUIRE(record == events[i - 1]);
+    }
+
+    // Generating the suite again on the same instance gives the same records
+    REQUIRE(suite_model.generate("Test", true).get_library_json()["Events"] ==
+            events);
+  }
+
+  SECTION("Test time histories are independent of number of threads") {
+    int seed = 10;
+    stochastic::DabaghiDerKiureghian parallel_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, truncate, seed);
+    stochastic::DabaghiDerKiureghian serial_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, truncate, seed);
+    parallel_model.set_num_threads(3);
+    REQUIRE(parallel_model.num_threads() == 3);
+    REQUIRE(parallel_model.num_records() == 2);
+
+    // Compare with records generated one parameter set at a time
+    auto events =
+        parallel_model.generate("Test", true).get_library_json()["Events"];
+    REQUIRE(events.size() == 2);
+    utilities::JsonObject event;
+    std::vector<std::vector<double>> series;
+    for (unsigned int i = 0; i < serial_model.num_records(); ++i) {
+      serial_model.generate_record("Test", i, event, series, true);
+      auto record = event.get_library_json();
+      record["timeSeries"][0]["data"] = series[0];
+      record["timeSeries"][1]["data"] = series[1];
+      REQUIRE(record == events[i]);
+    }
+  }
 }
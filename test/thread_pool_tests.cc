@@ -0,0 +1,62 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "thread_pool.h"
+
+TEST_CASE("Test thread pool", "[Helpers][ThreadPool]") {
+
+  SECTION("Test that every work item is processed exactly once") {
+    utilities::ThreadPool thread_pool(4);
+    REQUIRE(thread_pool.size() == 4);
+
+    std::vector<std::atomic<int>> counts(1000);
+    for (auto& count : counts) {
+      count = 0;
+    }
+
+    // Reuse pool for several jobs
+    for (unsigned int job = 0; job < 3; ++job) {
+      thread_pool.parallel_for(counts.size(),
+                               [&counts](std::size_t i) { ++counts[i]; });
+    }
+
+    for (auto& count : counts) {
+      REQUIRE(count == 3);
+    }
+  }
+
+  SECTION("Test serial pool and default size") {
+    utilities::ThreadPool serial_pool(1);
+    REQUIRE(serial_pool.size() == 1);
+
+    std::vector<double> values(10, 0.0);
+    serial_pool.parallel_for(values.size(), [&values](std::size_t i) {
+      values[i] = static_cast<double>(i);
+    });
+    for (unsigned int i = 0; i < values.size(); ++i) {
+      REQUIRE(values[i] == Approx(static_cast<double>(i)));
+    }
+
+    utilities::ThreadPool default_pool;
+    REQUIRE(default_pool.size() == utilities::ThreadPool::hardware_threads());
+  }
+
+  SECTION("Test that exceptions in work items are rethrown") {
+    utilities::ThreadPool thread_pool(3);
+    REQUIRE_THROWS_AS(thread_pool.parallel_for(100,
+                                               [](std::size_t i) {
+                                                 if (i == 42) {
+                                                   throw std::runtime_error(
+                                                       "Item failed");
+                                                 }
+                                               }),
+                      std::runtime_error);
+
+    // Pool should still be usable after failure
+    std::atomic<std::size_t> total{0};
+    thread_pool.parallel_for(10, [&total](std::size_t i) { total += i; });
+    REQUIRE(total == 45);
+  }
+}